@@ -0,0 +1,494 @@
+#pragma once
+
+#include <algorithm>          // std::min
+#include <atomic>             // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <cstdint>            // int64_t
+#include <deque>              // std::deque
+#include <exception>          // std::exception_ptr
+#include <functional>         // std::function
+#include <memory>             // std::unique_ptr
+#include <mutex>              // std::mutex
+#include <thread>             // std::thread
+#include <vector>             // std::vector
+
+#if defined(__linux__)
+    #include <pthread.h> // pthread_setaffinity_np
+    #include <sched.h>   // sched_getaffinity, cpu_set_t
+#endif
+
+namespace NextExecution
+{
+    namespace Detail
+    {
+        /**
+         * @class WorkStealingDeque
+         * @brief Chase-Lev work-stealing deque (with the C11 memory orderings of Le et al., PPoPP 2013).
+         * The owner thread pushes and pops at the bottom (LIFO, cache-warm); any thread steals from the top (FIFO,
+         * so thieves take the oldest and usually largest pieces of work). The ring buffer grows on demand;
+         * replaced buffers are retired, not freed, until the deque is destroyed because a thief may still read them.
+         * @tparam T A trivially copyable item type (task pointers).
+         * **/
+        template <typename T>
+        class WorkStealingDeque {
+        public:
+            explicit WorkStealingDeque(size_t capacity = 256) {
+                retired_.push_back(std::make_unique<Ring>(capacity));
+                ring_.store(retired_.back().get(), std::memory_order_relaxed);
+            }
+
+            WorkStealingDeque(const WorkStealingDeque&) = delete;
+            WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+            /**
+             * @brief Pushes an item at the bottom. Owner thread only.
+             * **/
+            void Push(T item) {
+                const int64_t b = bottom_.load(std::memory_order_relaxed);
+                const int64_t t = top_.load(std::memory_order_acquire);
+                Ring *ring = ring_.load(std::memory_order_relaxed);
+                if (b - t > static_cast<int64_t>(ring->capacity) - 1) ring = Grow(ring, t, b);
+                ring->Put(b, item);
+                bottom_.store(b + 1, std::memory_order_release); // Publishes the item to thieves
+            }
+
+            /**
+             * @brief Pops the most recently pushed item. Owner thread only.
+             * @return True if an item was popped into out.
+             * **/
+            bool Pop(T &out) {
+                const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+                Ring *ring = ring_.load(std::memory_order_relaxed);
+                bottom_.store(b, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t t = top_.load(std::memory_order_relaxed);
+                if (t > b) {
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                    return false;
+                }
+                out = ring->Get(b);
+                if (t == b) {
+                    // Last item: race against thieves for it
+                    const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                    return won;
+                }
+                return true;
+            }
+
+            /**
+             * @brief Steals the oldest item. Any thread.
+             * @return True if an item was stolen into out.
+             * **/
+            bool Steal(T &out) {
+                int64_t t = top_.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const int64_t b = bottom_.load(std::memory_order_acquire);
+                if (t >= b) return false;
+                const T item = ring_.load(std::memory_order_acquire)->Get(t);
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return false;
+                out = item;
+                return true;
+            }
+
+            /**
+             * @brief Checks whether the deque looks empty (a racy hint for idle threads).
+             * **/
+            [[nodiscard]] bool IsEmpty() const noexcept {
+                return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+            }
+
+        private:
+            struct Ring {
+                explicit Ring(size_t cap) : capacity(cap), items(new std::atomic<T>[cap]) {}
+                T Get(int64_t i) const noexcept { return items[static_cast<size_t>(i) & (capacity - 1)].load(std::memory_order_relaxed); }
+                void Put(int64_t i, T item) noexcept { items[static_cast<size_t>(i) & (capacity - 1)].store(item, std::memory_order_relaxed); }
+
+                size_t capacity;                        // Power of two
+                std::unique_ptr<std::atomic<T>[]> items; // Ring storage
+            };
+
+            Ring *Grow(Ring *old, int64_t t, int64_t b) {
+                retired_.push_back(std::make_unique<Ring>(old->capacity * 2));
+                Ring *ring = retired_.back().get();
+                for (int64_t i = t; i < b; ++i) ring->Put(i, old->Get(i));
+                ring_.store(ring, std::memory_order_release);
+                return ring;
+            }
+
+            alignas(64) std::atomic<int64_t> top_{0};    // Steal end
+            alignas(64) std::atomic<int64_t> bottom_{0}; // Owner end
+            std::atomic<Ring *> ring_{nullptr};          // Current buffer
+            std::vector<std::unique_ptr<Ring>> retired_; // Every buffer ever used (owner only)
+        };
+    }
+
+    /**
+     * @class TaskGroup
+     * @brief Tracks a set of tasks spawned on an ExecutionContext so they can be waited for together.
+     * The first exception thrown by a task is kept and rethrown by ExecutionContext::Wait; once a task
+     * has failed, ParallelFor skips the chunks that have not started yet.
+     * **/
+    class TaskGroup {
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        /**
+         * @brief Checks whether a task of the group has thrown.
+         * **/
+        [[nodiscard]] bool HasFailed() const noexcept { return failed_.load(std::memory_order_relaxed); }
+
+    private:
+        friend class ExecutionContext;
+
+        void SetError(std::exception_ptr error) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = error;
+            failed_.store(true, std::memory_order_relaxed);
+        }
+
+        std::atomic<size_t> pending_{0}; // Spawned tasks that have not finished
+        std::atomic<bool> failed_{false}; // Set when a task throws
+        std::mutex mutex_;                // Guards error_
+        std::exception_ptr error_;        // First exception thrown by a task
+    };
+
+    /**
+     * @class ExecutionContext
+     * @brief Owns the work-stealing thread pool every kernel and executor schedules its parallel work on.
+     *
+     * Kernels never spawn threads themselves: they call ParallelFor (or Spawn/Wait) on a context, usually
+     * GetDefaultContext(), so concurrent operators share one set of workers instead of oversubscribing the cores.
+     *
+     * Every worker owns a Chase-Lev deque. New tasks go to the bottom of the spawning worker's deque, idle
+     * workers steal from the top of the others; tasks submitted from outside the pool go through an injection
+     * queue. ParallelFor splits its range recursively, so a thief always takes the largest remaining half.
+     * A context of N threads starts N - 1 workers: the calling thread borrows the last deque while it waits.
+     * Waiting is never idle: Wait executes pending tasks (its own or stolen ones) until the group completes,
+     * so ParallelFor can be nested inside tasks without deadlocking or blocking a worker.
+     * **/
+    class ExecutionContext {
+    public:
+        /**
+         * @brief Constructs a context and starts its workers.
+         * @param numThreads The number of threads that run parallel work, caller included (0 = one per hardware thread).
+         * @param pinThreads If true, worker i is pinned to the (i + 1)-th CPU of the process affinity mask (Linux only;
+         * ignored elsewhere). Pinning keeps packed panels in the core-private caches on dedicated inference hosts.
+         * **/
+        explicit ExecutionContext(size_t numThreads = 0, bool pinThreads = false) {
+            if (numThreads == 0) numThreads = std::thread::hardware_concurrency();
+            if (numThreads == 0) numThreads = 1;
+            numThreads_ = numThreads;
+            deques_.reserve(numThreads);
+            for (size_t i = 0; i < numThreads; ++i) deques_.push_back(std::make_unique<Detail::WorkStealingDeque<Task *>>());
+
+            workers_.reserve(numThreads - 1);
+            for (size_t i = 0; i + 1 < numThreads; ++i) {
+                workers_.emplace_back([this, i] { WorkerLoop(i); });
+                if (pinThreads) PinThread(workers_.back(), i + 1);
+            }
+        }
+
+        ~ExecutionContext() {
+            stopping_.store(true, std::memory_order_release);
+            WakeWorkers(true);
+            for (std::thread &worker : workers_) worker.join();
+            // Tasks nobody waited for are dropped
+            for (auto &deque : deques_) {
+                Task *task;
+                while (deque->Steal(task)) delete task;
+            }
+            for (Task *task : injected_) delete task;
+        }
+
+        ExecutionContext(const ExecutionContext&) = delete;
+        ExecutionContext& operator=(const ExecutionContext&) = delete;
+
+        /**
+         * @brief Gets the number of threads that run parallel work (workers plus the caller).
+         * @return The thread count.
+         * **/
+        [[nodiscard]] size_t GetNumThreads() const noexcept { return numThreads_; }
+
+        /**
+         * @brief Schedules a task as part of a group. Call Wait(group) before the group is destroyed.
+         * @param group The group the task belongs to.
+         * @param func The task body.
+         * **/
+        void Spawn(TaskGroup &group, std::function<void()> func) {
+            group.pending_.fetch_add(1, std::memory_order_relaxed);
+            Task *task = new Task{std::move(func), &group};
+            const ThreadSlot &slot = CurrentSlot();
+            if (slot.owner == this) {
+                deques_[slot.index]->Push(task);
+            } else {
+                std::lock_guard<std::mutex> lock(injectedMutex_);
+                injected_.push_back(task);
+                injectedSize_.fetch_add(1, std::memory_order_relaxed);
+            }
+            WakeWorkers(false);
+        }
+
+        /**
+         * @brief Waits for every task of a group, running pending tasks in the meantime.
+         * @param group The group to wait for.
+         * @throws Rethrows the first exception thrown by a task of the group.
+         * **/
+        void Wait(TaskGroup &group) {
+            SlotGuard guard(*this);
+            WaitWithSlot(group, guard.Index());
+        }
+
+        /**
+         * @brief Runs func over [begin, end) in chunks of at most grain indices, and waits for completion.
+         * The range is split in halves recursively: one half is spawned, the other processed, so idle threads
+         * steal large pieces first and the chunks end up balanced across threads.
+         * @param begin First index.
+         * @param end One past the last index.
+         * @param grain Maximum number of indices per chunk, i.e. the smallest unit worth a task
+         * (0 = automatic: about eight chunks per thread).
+         * @param func Callable as func(size_t chunkBegin, size_t chunkEnd).
+         * @throws Rethrows the first exception thrown by func, after every started chunk has finished.
+         * **/
+        template <typename Func>
+        void ParallelFor(size_t begin, size_t end, size_t grain, Func &&func) {
+            if (begin >= end) return;
+            const size_t count = end - begin;
+            if (grain == 0) grain = std::max<size_t>(1, count / (numThreads_ * 8));
+            if (count <= grain || numThreads_ == 1) {
+                func(begin, end);
+                return;
+            }
+
+            const std::function<void(size_t, size_t)> body = [&func](size_t chunkBegin, size_t chunkEnd) { func(chunkBegin, chunkEnd); };
+            TaskGroup group;
+            SlotGuard guard(*this); // Let the caller's splits land in a deque rather than the injection queue
+            SplitRange(group, begin, end, grain, body);
+            WaitWithSlot(group, guard.Index());
+        }
+
+    private:
+        struct Task {
+            std::function<void()> func; // Task body
+            TaskGroup *group;           // Group notified on completion
+        };
+
+        // Deque a thread pushes to: workers own theirs, an outside caller borrows the last one while it waits
+        struct ThreadSlot {
+            const ExecutionContext *owner = nullptr;
+            size_t index = 0;
+        };
+
+        static ThreadSlot &CurrentSlot() noexcept {
+            thread_local ThreadSlot slot;
+            return slot;
+        }
+
+        /**
+         * @brief Attaches an outside thread to the spare deque for the guard's lifetime, if it is free.
+         * Threads that are already attached (workers, nested calls) keep their slot.
+         * **/
+        class SlotGuard {
+        public:
+            explicit SlotGuard(ExecutionContext &context) : context_(context), saved_(CurrentSlot()) {
+                if (saved_.owner == &context) {
+                    index_ = saved_.index;
+                } else if (!context.externalBusy_.exchange(true, std::memory_order_acquire)) {
+                    attached_ = true;
+                    index_ = context.numThreads_ - 1;
+                    CurrentSlot() = ThreadSlot{&context, index_};
+                }
+            }
+
+            ~SlotGuard() {
+                if (attached_) {
+                    CurrentSlot() = saved_;
+                    context_.externalBusy_.store(false, std::memory_order_release);
+                }
+            }
+
+            SlotGuard(const SlotGuard&) = delete;
+            SlotGuard& operator=(const SlotGuard&) = delete;
+
+            // Deque index of the thread, or NoSlot when it only has access to the injection queue
+            [[nodiscard]] size_t Index() const noexcept { return index_; }
+
+        private:
+            ExecutionContext &context_;
+            ThreadSlot saved_;
+            size_t index_ = NoSlot;
+            bool attached_ = false;
+        };
+
+        static constexpr size_t NoSlot = static_cast<size_t>(-1);
+
+        void SplitRange(TaskGroup &group, size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &body) {
+            while (end - begin > grain) {
+                const size_t mid = begin + (end - begin) / 2;
+                Spawn(group, [this, &group, mid, end, grain, &body] { SplitRange(group, mid, end, grain, body); });
+                end = mid;
+            }
+            if (group.HasFailed()) return;
+            try {
+                body(begin, end);
+            } catch (...) {
+                group.SetError(std::current_exception());
+            }
+        }
+
+        void WaitWithSlot(TaskGroup &group, size_t index) {
+            size_t idle = 0;
+            while (group.pending_.load(std::memory_order_acquire) != 0) {
+                if (Task *task = FindWork(index)) {
+                    Execute(task);
+                    idle = 0;
+                } else if (++idle > 64) {
+                    std::this_thread::yield();
+                }
+            }
+            if (group.HasFailed()) {
+                std::exception_ptr error;
+                {
+                    std::lock_guard<std::mutex> lock(group.mutex_);
+                    error = group.error_;
+                    group.error_ = nullptr;
+                }
+                group.failed_.store(false, std::memory_order_relaxed);
+                if (error) std::rethrow_exception(error);
+            }
+        }
+
+        void Execute(Task *task) {
+            TaskGroup *group = task->group;
+            if (!group->HasFailed()) {
+                try {
+                    task->func();
+                } catch (...) {
+                    group->SetError(std::current_exception());
+                }
+            }
+            delete task;
+            group->pending_.fetch_sub(1, std::memory_order_acq_rel); // Last access to the group
+        }
+
+        Task *FindWork(size_t index) {
+            Task *task = nullptr;
+            if (index != NoSlot && deques_[index]->Pop(task)) return task;
+
+            if (injectedSize_.load(std::memory_order_relaxed) != 0) {
+                std::lock_guard<std::mutex> lock(injectedMutex_);
+                if (!injected_.empty()) {
+                    task = injected_.front();
+                    injected_.pop_front();
+                    injectedSize_.fetch_sub(1, std::memory_order_relaxed);
+                    return task;
+                }
+            }
+
+            // Steal, starting from a random victim so thieves spread out
+            thread_local uint64_t seed = 0x9E3779B97F4A7C15ull ^ reinterpret_cast<uintptr_t>(&seed);
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            const size_t start = static_cast<size_t>(seed % numThreads_);
+            for (size_t i = 0; i < numThreads_; ++i) {
+                const size_t victim = (start + i) % numThreads_;
+                if (victim != index && deques_[victim]->Steal(task)) return task;
+            }
+            return nullptr;
+        }
+
+        bool HasVisibleWork() const {
+            if (injectedSize_.load(std::memory_order_relaxed) != 0) return true;
+            for (const auto &deque : deques_) {
+                if (!deque->IsEmpty()) return true;
+            }
+            return false;
+        }
+
+        void WakeWorkers(bool all) {
+            epoch_.fetch_add(1, std::memory_order_seq_cst);
+            if (sleeping_.load(std::memory_order_seq_cst) == 0) return;
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex_); // Orders the wake-up after a sleeper's epoch check
+            }
+            if (all) sleepCondition_.notify_all();
+            else sleepCondition_.notify_one();
+        }
+
+        void WorkerLoop(size_t index) {
+            CurrentSlot() = ThreadSlot{this, index};
+            size_t idle = 0;
+            while (!stopping_.load(std::memory_order_acquire)) {
+                if (Task *task = FindWork(index)) {
+                    Execute(task);
+                    idle = 0;
+                    continue;
+                }
+                if (++idle < 128) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                // Nothing to do for a while: sleep until new work is announced
+                const uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+                sleeping_.fetch_add(1, std::memory_order_seq_cst);
+                if (!HasVisibleWork()) {
+                    std::unique_lock<std::mutex> lock(sleepMutex_);
+                    sleepCondition_.wait(lock, [&] {
+                        return stopping_.load(std::memory_order_acquire) || epoch_.load(std::memory_order_seq_cst) != epoch;
+                    });
+                }
+                sleeping_.fetch_sub(1, std::memory_order_seq_cst);
+                idle = 0;
+            }
+        }
+
+        static void PinThread([[maybe_unused]] std::thread &thread, [[maybe_unused]] size_t slot) {
+#if defined(__linux__)
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+            if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+            const int count = CPU_COUNT(&allowed);
+            if (count <= 0) return;
+            int target = static_cast<int>(slot % static_cast<size_t>(count));
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (!CPU_ISSET(cpu, &allowed)) continue;
+                if (target-- == 0) {
+                    cpu_set_t single;
+                    CPU_ZERO(&single);
+                    CPU_SET(cpu, &single);
+                    pthread_setaffinity_np(thread.native_handle(), sizeof(single), &single);
+                    return;
+                }
+            }
+#endif
+        }
+
+        size_t numThreads_ = 1;                                               // Threads running parallel work, caller included
+        std::vector<std::unique_ptr<Detail::WorkStealingDeque<Task *>>> deques_; // One per worker plus one for an outside caller
+        std::vector<std::thread> workers_;                                    // Worker threads
+        std::atomic<bool> externalBusy_{false};                               // Whether an outside caller holds the spare deque
+
+        std::mutex injectedMutex_;             // Guards injected_
+        std::deque<Task *> injected_;          // Tasks spawned by threads without a deque
+        std::atomic<size_t> injectedSize_{0};  // Size of injected_ (read without the lock)
+
+        std::mutex sleepMutex_;                  // Sleep/wake handshake
+        std::condition_variable sleepCondition_; // Idle workers sleep here
+        std::atomic<uint64_t> epoch_{0};         // Bumped whenever work is published
+        std::atomic<size_t> sleeping_{0};        // Number of sleeping workers
+        std::atomic<bool> stopping_{false};      // Set by the destructor
+    };
+
+    /**
+     * @brief Gets the process-wide context used by kernels when none is given.
+     * @return A reference to the default ExecutionContext (one thread per hardware thread).
+     * **/
+    inline ExecutionContext &GetDefaultContext() {
+        static ExecutionContext context;
+        return context;
+    }
+}
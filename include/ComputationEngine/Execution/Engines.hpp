@@ -0,0 +1,799 @@
+#pragma once
+
+#include "Context.hpp"
+#include "NodeEvaluator.hpp"
+#include "../Graph/Passes/MemoryPlanner.hpp"
+#include "../Kernels/Reference.hpp"
+#include "../../Core/TensorView.hpp"
+#include "../../Utils/NextTypes/NextDeviceType.hpp"
+#include <algorithm>  // std::find, std::max
+#include <atomic>     // std::atomic
+#include <cmath>      // std::fabs, std::isnan
+#include <functional> // std::function
+#include <limits>     // std::numeric_limits
+#include <map>        // std::map
+#include <memory>     // std::unique_ptr, std::shared_ptr
+#include <string>     // std::string
+#include <tuple>      // std::tie
+#include <utility>    // std::move
+#include <vector>     // std::vector
+
+namespace NextExecution
+{
+    using NextGraph::Graph;
+    using NextGraph::NodeId;
+    using NextGraph::ValueId;
+    using NextTensor::TensorInterface;
+    using NextTensor::TensorView;
+    using NextTypes::DeviceType;
+    using NextTypes::MemoryLayout;
+
+    /**
+     * @brief A kernel as the executor calls it: runs one node on resolved buffers, epilogue included.
+     * **/
+    using NodeKernel = std::function<void(const Node &, const NodeBuffers &, ExecutionContext &)>;
+
+    /**
+     * @brief What a kernel implementation is registered for.
+     * **/
+    struct KernelKey {
+        OpType op = OpType::UNKNOWN;                   // Operation
+        DataType dtype = DataType::UNKNOWN;            // Element type of the operands
+        MemoryLayout layout = MemoryLayout::ROW_MAJOR; // Physical layout of the output
+
+        bool operator<(const KernelKey &other) const {
+            return std::tie(op, dtype, layout) < std::tie(other.op, other.dtype, other.layout);
+        }
+        bool operator==(const KernelKey &other) const { return op == other.op && dtype == other.dtype && layout == other.layout; }
+    };
+
+    /**
+     * @brief A registered kernel implementation.
+     * **/
+    struct KernelEntry {
+        NodeKernel run;   // The implementation
+        int priority = 0; // Higher is preferred when several engines provide the key
+    };
+
+    /**
+     * @class Engine
+     * @brief A set of kernel implementations for one device, registered per (OpType, DataType, MemoryLayout).
+     *
+     * Engines only provide kernels; the executor picks, for every node at compile time, the registered kernel with
+     * the highest priority among the engines it was given (the first engine wins ties). Every kernel must honor the
+     * epilogue of the node it runs (see FuseElementwise).
+     * **/
+    class Engine {
+    public:
+        virtual ~Engine() = default;
+
+        /**
+         * @brief Gets a short name identifying the engine.
+         * **/
+        [[nodiscard]] virtual std::string GetName() const = 0;
+
+        /**
+         * @brief Gets the device the kernels of the engine run on.
+         * **/
+        [[nodiscard]] virtual DeviceType GetDeviceType() const noexcept = 0;
+
+        /**
+         * @brief Registers (or replaces) the kernel for a key.
+         * @param key The operation, data type and layout the kernel handles.
+         * @param kernel The implementation.
+         * @param priority Selection priority (higher is preferred).
+         * @throws std::invalid_argument if the kernel is empty.
+         * **/
+        void RegisterKernel(const KernelKey &key, NodeKernel kernel, int priority = 0) {
+            if (!kernel) {
+                throw std::invalid_argument("Cannot register an empty kernel.");
+            }
+            kernels_[key] = KernelEntry{std::move(kernel), priority};
+        }
+
+        /**
+         * @brief Finds the kernel registered for a key.
+         * @param key The key.
+         * @return The kernel, or nullptr if the engine has none.
+         * **/
+        [[nodiscard]] const KernelEntry *FindKernel(const KernelKey &key) const {
+            const auto it = kernels_.find(key);
+            return it == kernels_.end() ? nullptr : &it->second;
+        }
+
+        /**
+         * @brief Gets every key the engine has a kernel for.
+         * **/
+        [[nodiscard]] std::vector<KernelKey> GetKernelKeys() const {
+            std::vector<KernelKey> keys;
+            keys.reserve(kernels_.size());
+            for (const auto &entry : kernels_) keys.push_back(entry.first);
+            return keys;
+        }
+
+    protected:
+        Engine() = default;
+
+        // Registers one kernel for every data type in a list
+        void RegisterKernels(OpType op, const std::vector<DataType> &dtypes, const NodeKernel &kernel, int priority,
+                             MemoryLayout layout = MemoryLayout::ROW_MAJOR) {
+            for (DataType dtype : dtypes) RegisterKernel(KernelKey{op, dtype, layout}, kernel, priority);
+        }
+
+        static std::vector<DataType> FloatTypes() { return {DataType::FLOAT32, DataType::FLOAT64}; }
+        static std::vector<MemoryLayout> BlockedLayouts() { return {MemoryLayout::NCHW8C, MemoryLayout::NCHW16C}; }
+        static std::vector<DataType> NumericTypes() {
+            return {DataType::FLOAT32, DataType::FLOAT64, DataType::INT8, DataType::INT16, DataType::INT32, DataType::INT64,
+                    DataType::UINT8, DataType::UINT16, DataType::UINT32, DataType::UINT64};
+        }
+
+        // Registers REORDER into and out of every layout, and the operations that have channel-blocked kernels
+        void RegisterBlockedKernels(const NodeKernel &kernel, int priority) {
+            for (MemoryLayout layout : {MemoryLayout::ROW_MAJOR, MemoryLayout::NCHW8C, MemoryLayout::NCHW16C}) {
+                RegisterKernels(OpType::REORDER, NumericTypes(), kernel, priority, layout);
+                RegisterKernel(KernelKey{OpType::REORDER, DataType::BOOL, layout}, kernel, priority);
+            }
+            for (MemoryLayout layout : BlockedLayouts()) {
+                for (OpType op : {OpType::ADD, OpType::SUB, OpType::MUL, OpType::DIV, OpType::RELU, OpType::SIGMOID, OpType::TANH,
+                                  OpType::CONV2D, OpType::MAXPOOL, OpType::AVGPOOL}) {
+                    RegisterKernels(op, FloatTypes(), kernel, priority, layout);
+                }
+            }
+        }
+
+    private:
+        std::map<KernelKey, KernelEntry> kernels_; // Registered kernels
+    };
+
+    namespace Detail
+    {
+        // Splits the buffers of a node into its head operands
+        inline size_t GetHeadInputs(const Node &node, const NodeBuffers &buffers) {
+            if (buffers.inputs.size() != node.inputs.size() || buffers.inputMetas.size() != node.inputs.size()) {
+                throw std::invalid_argument("Node buffers do not match the node inputs.");
+            }
+            return NextGraph::GetNumHeadInputs(node);
+        }
+
+        /**
+         * @brief Runs a node with the reference kernels, then its epilogue element by element.
+         * **/
+        inline void RunReferenceNode(const Node &node, const NodeBuffers &buffers, ExecutionContext &) {
+            namespace Reference = NextKernels::Reference;
+            const size_t headInputs = GetHeadInputs(node, buffers);
+            const NextGraph::NodeAttributes &attributes = node.attributes;
+            const std::vector<const void *> &in = buffers.inputs;
+            const std::vector<TensorMetadata> &meta = buffers.inputMetas;
+            switch (node.op) {
+                case OpType::ADD: case OpType::SUB: case OpType::MUL: case OpType::DIV:
+                    Reference::Binary(node.op, buffers.dtype, buffers.out, buffers.outMeta, in[0], meta[0], in[1], meta[1]);
+                    break;
+                case OpType::RELU: case OpType::SIGMOID: case OpType::TANH:
+                    Reference::Unary(node.op, buffers.dtype, buffers.out, buffers.outMeta, in[0], meta[0]);
+                    break;
+                case OpType::MATMUL:
+                    Reference::MatMul(buffers.dtype, buffers.out, buffers.outMeta, in[0], meta[0], in[1], meta[1]);
+                    break;
+                case OpType::SOFTMAX:
+                    Reference::Softmax(buffers.dtype, buffers.out, buffers.outMeta, in[0], meta[0], NextGraph::Detail::NormalizeAxis(attributes.axis, meta[0].GetRank()));
+                    break;
+                case OpType::CONV2D: {
+                    const auto [sh, sw] = NextGraph::Detail::GetSpatialPair(attributes.strides, 1, 1, "Strides");
+                    const auto [ph, pw] = NextGraph::Detail::GetSpatialPair(attributes.padding, 0, 0, "Padding");
+                    Reference::Conv2D(buffers.dtype, buffers.out, buffers.outMeta, in[0], meta[0], in[1], meta[1],
+                                      headInputs == 3 ? in[2] : nullptr, headInputs == 3 ? &meta[2] : nullptr, sh, sw, ph, pw, attributes.groups);
+                    break;
+                }
+                case OpType::MAXPOOL: case OpType::AVGPOOL: {
+                    const size_t kh = attributes.kernel[0], kw = attributes.kernel[1]; // Validated by shape inference
+                    const auto [sh, sw] = NextGraph::Detail::GetSpatialPair(attributes.strides, kh, kw, "Strides");
+                    const auto [ph, pw] = NextGraph::Detail::GetSpatialPair(attributes.padding, 0, 0, "Padding");
+                    Reference::Pool2D(node.op, buffers.dtype, buffers.out, buffers.outMeta, in[0], meta[0], kh, kw, sh, sw, ph, pw);
+                    break;
+                }
+                case OpType::FLATTEN: case OpType::RESHAPE:
+                    Reference::CopyElements(buffers.dtype, buffers.out, buffers.outMeta, in[0], meta[0]);
+                    break;
+                case OpType::TRANSPOSE:
+                    Reference::CopyElements(buffers.dtype, buffers.out, buffers.outMeta, in[0], NextShapeUtils::NextPermute(meta[0], attributes.axes));
+                    break;
+                case OpType::REORDER:
+                    Reference::CopyElements(buffers.dtype, buffers.out, buffers.outMeta, in[0], meta[0]);
+                    break;
+                default:
+                    throw std::invalid_argument("No reference kernel is available for this operation.");
+            }
+            if (!node.epilogue.empty()) {
+                Reference::ApplyEpilogue(buffers.dtype, buffers.out, buffers.outMeta, GetEpilogueOperations(node, buffers));
+            }
+        }
+    }
+
+    /**
+     * @class ReferenceEngine
+     * @brief Plain scalar kernels for every operation (see NextKernels::Reference), with the lowest priority.
+     * Used as the fallback for operations no optimized kernel covers and as the ground truth for ValidateEngine.
+     * **/
+    class ReferenceEngine : public Engine {
+    public:
+        static constexpr int Priority = 0;
+
+        ReferenceEngine() {
+            const NodeKernel kernel = Detail::RunReferenceNode;
+            for (OpType op : {OpType::ADD, OpType::MUL}) {
+                RegisterKernels(op, NumericTypes(), kernel, Priority);
+                RegisterKernel(KernelKey{op, DataType::BOOL, MemoryLayout::ROW_MAJOR}, kernel, Priority);
+            }
+            for (OpType op : {OpType::SUB, OpType::DIV}) RegisterKernels(op, NumericTypes(), kernel, Priority);
+            for (OpType op : {OpType::RELU, OpType::SIGMOID, OpType::TANH, OpType::MATMUL, OpType::SOFTMAX,
+                              OpType::CONV2D, OpType::MAXPOOL, OpType::AVGPOOL}) {
+                RegisterKernels(op, FloatTypes(), kernel, Priority);
+            }
+            for (OpType op : {OpType::FLATTEN, OpType::RESHAPE, OpType::TRANSPOSE}) {
+                RegisterKernels(op, NumericTypes(), kernel, Priority);
+                RegisterKernel(KernelKey{op, DataType::BOOL, MemoryLayout::ROW_MAJOR}, kernel, Priority);
+            }
+            RegisterBlockedKernels(kernel, Priority);
+        }
+
+        [[nodiscard]] std::string GetName() const override { return "reference"; }
+        [[nodiscard]] DeviceType GetDeviceType() const noexcept override { return DeviceType::CPU; }
+    };
+
+    /**
+     * @class OptimizedCpuEngine
+     * @brief The vectorized, multithreaded CPU kernels (see EvaluateNode): SIMD elementwise and activation loops,
+     * fused epilogues, blocked GEMM, online softmax, im2col/direct/Winograd convolution,
+     * channels-last and global pooling, and the channel-blocked (nChw8c/nChw16c) elementwise, pooling and depthwise
+     * convolution kernels with their REORDERs. Preferred over the reference engine wherever both have a kernel.
+     * **/
+    class OptimizedCpuEngine : public Engine {
+    public:
+        static constexpr int Priority = 100;
+
+        OptimizedCpuEngine() {
+            const NodeKernel kernel = [](const Node &node, const NodeBuffers &buffers, ExecutionContext &context) { EvaluateNode(node, buffers, context); };
+            for (OpType op : {OpType::ADD, OpType::MUL}) {
+                RegisterKernels(op, NumericTypes(), kernel, Priority);
+                RegisterKernel(KernelKey{op, DataType::BOOL, MemoryLayout::ROW_MAJOR}, kernel, Priority);
+            }
+            for (OpType op : {OpType::SUB, OpType::DIV}) RegisterKernels(op, NumericTypes(), kernel, Priority);
+            for (OpType op : {OpType::RELU, OpType::SIGMOID, OpType::TANH, OpType::MATMUL, OpType::SOFTMAX, OpType::CONV2D,
+                              OpType::MAXPOOL, OpType::AVGPOOL}) {
+                RegisterKernels(op, FloatTypes(), kernel, Priority);
+            }
+            for (OpType op : {OpType::FLATTEN, OpType::RESHAPE, OpType::TRANSPOSE}) {
+                RegisterKernels(op, NumericTypes(), kernel, Priority);
+                RegisterKernel(KernelKey{op, DataType::BOOL, MemoryLayout::ROW_MAJOR}, kernel, Priority);
+            }
+            RegisterBlockedKernels(kernel, Priority);
+        }
+
+        [[nodiscard]] std::string GetName() const override { return "cpu"; }
+        [[nodiscard]] DeviceType GetDeviceType() const noexcept override { return DeviceType::CPU; }
+    };
+
+    /**
+     * @brief Gets the engines executors use by default: the optimized CPU engine, then the reference engine.
+     * **/
+    [[nodiscard]] inline const std::vector<std::shared_ptr<const Engine>> &GetDefaultEngines() {
+        static const std::vector<std::shared_ptr<const Engine>> engines{std::make_shared<OptimizedCpuEngine>(), std::make_shared<ReferenceEngine>()};
+        return engines;
+    }
+
+    /**
+     * @brief Picks the kernel for a key: the highest priority among the engines, the first engine on ties.
+     * @param engines The candidate engines.
+     * @param key The key.
+     * @return The engine and kernel, or {nullptr, nullptr} if no engine has the key.
+     * **/
+    [[nodiscard]] inline std::pair<const Engine *, const KernelEntry *> SelectKernel(const std::vector<std::shared_ptr<const Engine>> &engines, const KernelKey &key) {
+        std::pair<const Engine *, const KernelEntry *> best{nullptr, nullptr};
+        for (const auto &engine : engines) {
+            const KernelEntry *kernel = engine->FindKernel(key);
+            if (kernel && (!best.second || kernel->priority > best.second->priority)) best = {engine.get(), kernel};
+        }
+        return best;
+    }
+
+    /**
+     * @class GraphExecutor
+     * @brief Compiles a graph once, then runs it many times, executing independent branches concurrently.
+     *
+     * Compilation infers shapes, plans every intermediate buffer into one slab (see PlanMemory) and resolves the
+     * address of every operand, so a run only binds the inputs and executes kernels.
+     *
+     * A run schedules nodes on the work-stealing pool of the context as soon as their dependencies finish: every
+     * node has an atomic counter of unfinished producers and the node that drops a counter to zero schedules the
+     * consumer. One ready consumer continues on the same thread (a chain runs as a sequence, in cache), the others
+     * are spawned and stolen by idle workers, so the branches of inception-style or multi-head models overlap.
+     * Kernels split their own work with ParallelFor on the same context: inter-op and intra-op parallelism share
+     * one set of threads and never oversubscribe the cores.
+     *
+     * Every node runs the kernel selected at compile time among the engines (see SelectKernel), keyed by its
+     * operation, data type and output layout.
+     * View nodes (RESHAPE/FLATTEN/TRANSPOSE that alias their input) cost nothing at run time: their consumers read
+     * the viewed buffer directly.
+     * The memory plan lets buffers with disjoint lifetimes share slab memory. Lifetimes are computed on the
+     * topological order, which independent branches no longer follow, so a node writing reused memory also waits
+     * for every reader of the buffers that held that memory before.
+     * Runs are not reentrant: they share the slab, and the outputs of a run are views of it, valid until the next run.
+     * **/
+    class GraphExecutor {
+    public:
+        /**
+         * @brief Compiles a graph with the default engines (see GetDefaultEngines).
+         * @param graph The graph (taken over by the executor).
+         * @param context The execution context runs are scheduled on (must outlive the executor).
+         * @throws std::invalid_argument if shape inference fails, a node has no kernel, or a graph output is a graph
+         * input (or a view of one) or channel-blocked.
+         * **/
+        explicit GraphExecutor(Graph graph, ExecutionContext &context = GetDefaultContext())
+            : GraphExecutor(std::move(graph), GetDefaultEngines(), context) {}
+
+        /**
+         * @brief Compiles a graph, selecting every kernel among the given engines.
+         * @param graph The graph (taken over by the executor).
+         * @param engines The engines providing kernels (e.g. only a ReferenceEngine to run the reference numerics).
+         * @param context The execution context runs are scheduled on (must outlive the executor).
+         * @throws std::invalid_argument if shape inference fails, no engine has a kernel for a node, or a graph output
+         * is a graph input (or a view of one) or channel-blocked.
+         * **/
+        GraphExecutor(Graph graph, std::vector<std::shared_ptr<const Engine>> engines, ExecutionContext &context = GetDefaultContext())
+            : graph_(std::move(graph)), engines_(std::move(engines)), context_(context) {
+            NextGraph::InferShapes(graph_);
+            const NextGraph::MemoryPlan plan = NextGraph::PlanMemory(graph_);
+            slabBytes_ = plan.slabBytes;
+            slab_ = NextMemory::Storage::Create(std::max<size_t>(plan.slabBytes, 1));
+            Compile(plan);
+        }
+
+        GraphExecutor(const GraphExecutor&) = delete;
+        GraphExecutor& operator=(const GraphExecutor&) = delete;
+
+        /**
+         * @brief Runs the graph.
+         * @param inputs One tensor per graph input, in the order of Graph::GetInputs(), with the declared data type,
+         * shape and strides (the offset may differ).
+         * @return One view per graph output, in the order of Graph::GetOutputs(); valid until the next run.
+         * @throws std::invalid_argument if the inputs do not match the graph inputs.
+         * @throws Rethrows the first exception thrown by a kernel.
+         * **/
+        std::vector<TensorView> Run(const std::vector<const TensorInterface *> &inputs) {
+            BindInputs(inputs);
+
+            TaskGroup group;
+            for (size_t i = 0; i < nodes_.size(); ++i) {
+                pending_[i].store(nodes_[i].numDependencies, std::memory_order_relaxed);
+            }
+            for (size_t root : roots_) {
+                context_.Spawn(group, [this, &group, root] { RunFrom(group, root); });
+            }
+            context_.Wait(group);
+
+            std::vector<TensorView> outputs;
+            outputs.reserve(outputs_.size());
+            for (const OutputBinding &output : outputs_) outputs.emplace_back(output.storage, output.metadata, output.dtype);
+            return outputs;
+        }
+
+        /**
+         * @brief Gets the compiled graph (shapes inferred, intermediates planned).
+         * **/
+        [[nodiscard]] const Graph &GetGraph() const noexcept { return graph_; }
+
+        /**
+         * @brief Gets the size of the slab holding every intermediate buffer.
+         * **/
+        [[nodiscard]] size_t GetSlabBytes() const noexcept { return slabBytes_; }
+
+        /**
+         * @brief Gets the engine whose kernel runs a node.
+         * @param node The node.
+         * @return The engine, or nullptr for nodes that do no work (views, erased nodes).
+         * **/
+        [[nodiscard]] const Engine *GetSelectedEngine(NodeId node) const {
+            for (const CompiledNode &compiled : nodes_) {
+                if (compiled.node == node) return compiled.engine;
+            }
+            return nullptr;
+        }
+
+    private:
+        struct CompiledNode {
+            NodeId node;                   // Graph node
+            const Engine *engine;          // Engine providing the kernel
+            const KernelEntry *kernel;     // Selected kernel
+            NodeBuffers buffers;           // Operand addresses (graph inputs patched at every run)
+            std::vector<std::pair<size_t, ValueId>> boundInputs; // (operand slot, graph input it reads)
+            std::vector<size_t> consumers; // Compiled nodes waiting for this one (one entry per dependent node)
+            size_t numDependencies = 0;    // Distinct compiled nodes this one waits for
+        };
+
+        struct OutputBinding {
+            NextMemory::StoragePtr storage; // Slab or constant storage
+            TensorMetadata metadata;        // Metadata inside that storage
+            DataType dtype;                 // Element type
+        };
+
+        // Root of the buffer a value lives in
+        ValueId GetRoot(ValueId value) const {
+            const ValueId base = graph_.GetValue(value).aliasOf;
+            return base == NextGraph::InvalidId ? value : base;
+        }
+
+        // Start of the buffer a non-input value lives in
+        void *GetBase(ValueId value) const {
+            const NextGraph::Value &root = graph_.GetValue(GetRoot(value));
+            return root.kind == NextGraph::ValueKind::CONSTANT ? root.data->GetData() : slab_->GetData();
+        }
+
+        void Compile(const NextGraph::MemoryPlan &plan) {
+            inputIndex_.assign(graph_.GetNumValues(), NextGraph::InvalidId);
+            for (ValueId input : graph_.GetInputs()) {
+                inputIndex_[input] = inputBases_.size();
+                inputBases_.push_back(nullptr);
+            }
+
+            // Compiled nodes: every node that does work, in topological order
+            std::vector<size_t> compiledOf(graph_.GetNumNodes(), NextGraph::InvalidId);
+            for (NodeId id : graph_.TopologicalOrder()) {
+                if (NextGraph::IsViewNode(graph_, id)) continue;
+                const NextGraph::Node &node = graph_.GetNode(id);
+                const NextGraph::Value &output = graph_.GetValue(node.outputs.front());
+                const auto [engine, kernel] = SelectKernel(engines_, KernelKey{node.op, output.dtype, output.layout});
+                if (!kernel) {
+                    throw std::invalid_argument(std::string("No engine has a kernel for ") + NextGraph::Detail::GetOpName(node.op) +
+                                                " with this data type and layout.");
+                }
+                CompiledNode compiled;
+                compiled.node = id;
+                compiled.engine = engine;
+                compiled.kernel = kernel;
+                compiled.buffers.dtype = output.dtype;
+                compiled.buffers.out = slab_->GetData();
+                compiled.buffers.outMeta = *output.metadata;
+                for (size_t slot = 0; slot < node.inputs.size(); ++slot) {
+                    const ValueId input = node.inputs[slot];
+                    const ValueId root = GetRoot(input);
+                    compiled.buffers.inputMetas.push_back(*graph_.GetValue(input).metadata);
+                    if (graph_.GetValue(root).kind == NextGraph::ValueKind::INPUT) {
+                        compiled.buffers.inputs.push_back(nullptr);
+                        compiled.boundInputs.emplace_back(slot, root);
+                    } else {
+                        compiled.buffers.inputs.push_back(GetBase(input));
+                    }
+                }
+                compiledOf[id] = nodes_.size();
+                nodes_.push_back(std::move(compiled));
+            }
+
+            // Data dependencies: the node producing the buffer behind every operand (through views)
+            std::vector<std::vector<size_t>> dependencies(nodes_.size());
+            std::vector<std::vector<size_t>> readers(nodes_.size()); // Per compiled node: nodes reading its buffer
+            auto addDependency = [&](size_t node, size_t dependency) {
+                std::vector<size_t> &list = dependencies[node];
+                if (dependency != node && std::find(list.begin(), list.end(), dependency) == list.end()) list.push_back(dependency);
+            };
+            for (size_t index = 0; index < nodes_.size(); ++index) {
+                for (ValueId input : graph_.GetNode(nodes_[index].node).inputs) {
+                    NodeId producer = graph_.GetValue(input).producer;
+                    while (producer != NextGraph::InvalidId && compiledOf[producer] == NextGraph::InvalidId) {
+                        producer = graph_.GetValue(graph_.GetNode(producer).inputs.front()).producer; // Skip views
+                    }
+                    if (producer == NextGraph::InvalidId) continue;
+                    addDependency(index, compiledOf[producer]);
+                    readers[compiledOf[producer]].push_back(index);
+                }
+            }
+
+            // Memory dependencies: a node reusing slab memory waits until the previous owners are no longer read
+            std::vector<std::pair<size_t, size_t>> ranges(nodes_.size()); // Byte range written by every compiled node
+            for (size_t index = 0; index < nodes_.size(); ++index) {
+                const ValueId output = graph_.GetNode(nodes_[index].node).outputs.front();
+                const TensorMetadata &meta = *graph_.GetValue(output).metadata;
+                const size_t bytes = meta.GetStorageSize() * NextTypes::GetDataTypeSize(graph_.GetValue(output).dtype);
+                ranges[index] = {plan.byteOffsets[output], plan.byteOffsets[output] + bytes};
+            }
+            for (size_t later = 0; later < nodes_.size(); ++later) {
+                for (size_t earlier = 0; earlier < later; ++earlier) {
+                    if (ranges[earlier].first >= ranges[later].second || ranges[later].first >= ranges[earlier].second) continue;
+                    addDependency(later, earlier);
+                    for (size_t reader : readers[earlier]) addDependency(later, reader);
+                }
+            }
+
+            for (size_t index = 0; index < nodes_.size(); ++index) {
+                nodes_[index].numDependencies = dependencies[index].size();
+                for (size_t dependency : dependencies[index]) nodes_[dependency].consumers.push_back(index);
+                if (dependencies[index].empty()) roots_.push_back(index);
+            }
+            pending_ = std::make_unique<std::atomic<size_t>[]>(nodes_.size());
+
+            for (ValueId id : graph_.GetOutputs()) {
+                const NextGraph::Value &value = graph_.GetValue(id);
+                const NextGraph::Value &root = graph_.GetValue(GetRoot(id));
+                if (root.kind == NextGraph::ValueKind::INPUT) {
+                    throw std::invalid_argument("Graph outputs cannot be graph inputs or views of them.");
+                }
+                if (NextTypes::IsBlockedLayout(value.layout)) {
+                    throw std::invalid_argument("Graph outputs cannot be channel-blocked; insert a REORDER.");
+                }
+                outputs_.push_back(OutputBinding{root.kind == NextGraph::ValueKind::CONSTANT ? root.data : slab_, *value.metadata, value.dtype});
+            }
+        }
+
+        void BindInputs(const std::vector<const TensorInterface *> &inputs) {
+            const std::vector<ValueId> &graphInputs = graph_.GetInputs();
+            if (inputs.size() != graphInputs.size()) {
+                throw std::invalid_argument("Run requires one tensor per graph input.");
+            }
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                const NextGraph::Value &declared = graph_.GetValue(graphInputs[i]);
+                const TensorInterface &tensor = *inputs[i];
+                const TensorMetadata &meta = tensor.GetMetadata();
+                if (tensor.GetDataType() != declared.dtype || meta.GetShape() != declared.metadata->GetShape() ||
+                    meta.GetStrides() != declared.metadata->GetStrides() || meta.GetLayout() != declared.metadata->GetLayout()) {
+                    throw std::invalid_argument("Input '" + declared.name + "' does not match the declared data type, shape and strides.");
+                }
+                // Shift the base so the declared (compile-time) offsets address the bound tensor
+                const std::ptrdiff_t shift = (static_cast<std::ptrdiff_t>(meta.GetOffset()) - static_cast<std::ptrdiff_t>(declared.metadata->GetOffset())) *
+                                             static_cast<std::ptrdiff_t>(NextTypes::GetDataTypeSize(declared.dtype));
+                inputBases_[i] = static_cast<const char *>(tensor.GetRawData()) + shift;
+            }
+            for (CompiledNode &compiled : nodes_) {
+                for (const auto &[slot, input] : compiled.boundInputs) compiled.buffers.inputs[slot] = inputBases_[inputIndex_[input]];
+            }
+        }
+
+        // Runs a node, then the consumers it makes ready: the first one inline, the others as new tasks
+        void RunFrom(TaskGroup &group, size_t index) {
+            while (index != NextGraph::InvalidId) {
+                if (group.HasFailed()) return;
+                const CompiledNode &compiled = nodes_[index];
+                compiled.kernel->run(graph_.GetNode(compiled.node), compiled.buffers, context_);
+                size_t next = NextGraph::InvalidId;
+                for (size_t consumer : compiled.consumers) {
+                    if (pending_[consumer].fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+                    if (next == NextGraph::InvalidId) {
+                        next = consumer;
+                    } else {
+                        context_.Spawn(group, [this, &group, consumer] { RunFrom(group, consumer); });
+                    }
+                }
+                index = next;
+            }
+        }
+
+        Graph graph_;                                 // Compiled graph
+        std::vector<std::shared_ptr<const Engine>> engines_; // Engines the kernels come from
+        ExecutionContext &context_;                   // Pool runs are scheduled on
+        NextMemory::StoragePtr slab_;                 // Every intermediate buffer
+        size_t slabBytes_ = 0;                        // Planned slab size
+        std::vector<CompiledNode> nodes_;             // Nodes that do work, in topological order
+        std::vector<size_t> roots_;                   // Compiled nodes without dependencies
+        std::unique_ptr<std::atomic<size_t>[]> pending_; // Per compiled node: producers not finished in this run
+        std::vector<OutputBinding> outputs_;          // Graph outputs
+        std::vector<size_t> inputIndex_;              // Per value: position in the graph inputs (InvalidId otherwise)
+        std::vector<const void *> inputBases_;        // Per graph input: base pointer bound for this run
+    };
+
+    /**
+     * @brief Result of checking one kernel against the reference engine.
+     * **/
+    struct KernelValidation {
+        KernelKey key;         // Validated kernel
+        size_t variant = 0;    // Case of the kernel (see Detail::MakeValidationCase)
+        double maxError = 0.0; // Largest |kernel - reference| / max(1, |reference|) over the output
+        bool passed = false;   // Whether maxError is within the tolerance
+    };
+
+    namespace Detail
+    {
+        /**
+         * @brief Builds a one-node graph exercising a kernel key: odd extents (vector tails), broadcast operands,
+         * strided and padded windows, and for floating point heads that take one a fused epilogue.
+         * Channel-blocked keys read activations in their layout with a channel count that leaves a partial block.
+         * ROW_MAJOR CONV2D has one case per algorithm: 0 im2col, 1 and 2 Winograd F(2x2, 3x3) and F(4x4, 3x3)
+         * (requested through the node attribute, with partial output tiles), 3 depthwise and 4 narrow groups (DIRECT).
+         * @param key The kernel key.
+         * @param variant The case to build (0 for every other kernel).
+         * @return The graph and the node to run, or InvalidId if the operation has no validation case of that variant.
+         * **/
+        inline std::pair<Graph, NodeId> MakeValidationCase(const KernelKey &key, size_t variant = 0) {
+            Graph graph;
+            const DataType dtype = key.dtype;
+            const bool isFloat = dtype == DataType::FLOAT32 || dtype == DataType::FLOAT64;
+            const bool blocked = NextTypes::IsBlockedLayout(key.layout);
+            auto addInput = [&](const std::string &name, const TensorShapeDynamic &shape, MemoryLayout layout = MemoryLayout::ROW_MAJOR) {
+                const ValueId input = graph.AddInput(name, dtype, shape);
+                if (layout != MemoryLayout::ROW_MAJOR) {
+                    graph.GetValue(input).layout = layout;
+                    graph.GetValue(input).metadata = TensorMetadata(shape, layout);
+                }
+                return input;
+            };
+            ValueId result = NextGraph::InvalidId;
+            std::vector<std::pair<NextGraph::EpilogueStep, TensorShapeDynamic>> epilogue;
+            if (variant > 0 && (key.op != OpType::CONV2D || blocked || variant > 4)) return {std::move(graph), NextGraph::InvalidId};
+            switch (key.op) {
+                case OpType::ADD: case OpType::SUB: case OpType::MUL: case OpType::DIV:
+                    if (blocked) {
+                        result = graph.AddNode(key.op, {addInput("a", {2, 19, 5, 7}, key.layout), addInput("b", {2, 19, 5, 7}, key.layout)});
+                        epilogue = {{NextGraph::EpilogueStep{OpType::MUL, 0, true}, {2, 19, 5, 7}}, {NextGraph::EpilogueStep{OpType::TANH}, {}}};
+                        break;
+                    }
+                    result = graph.AddNode(key.op, {graph.AddInput("a", dtype, {5, 1, 67}), graph.AddInput("b", dtype, {33, 67})});
+                    epilogue = {{NextGraph::EpilogueStep{OpType::MUL, 0, true}, {67}}, {NextGraph::EpilogueStep{OpType::TANH}, {}}};
+                    break;
+                case OpType::RELU: case OpType::SIGMOID: case OpType::TANH:
+                    if (blocked) {
+                        result = graph.AddNode(key.op, {addInput("x", {2, 19, 5, 7}, key.layout)});
+                        epilogue = {{NextGraph::EpilogueStep{OpType::SUB, 0, false}, {2, 19, 5, 7}}};
+                        break;
+                    }
+                    result = graph.AddNode(key.op, {graph.AddInput("x", dtype, {7, 131})});
+                    epilogue = {{NextGraph::EpilogueStep{OpType::SUB, 0, false}, {131}}};
+                    break;
+                case OpType::MATMUL:
+                    result = graph.MatMul(graph.AddInput("a", dtype, {2, 37, 71}), graph.AddInput("b", dtype, {71, 53}));
+                    epilogue = {{NextGraph::EpilogueStep{OpType::ADD, 0, false}, {53}}, {NextGraph::EpilogueStep{OpType::RELU}, {}}};
+                    break;
+                case OpType::SOFTMAX:
+                    result = graph.Softmax(graph.AddInput("x", dtype, {5, 19, 23}), 1);
+                    break;
+                case OpType::CONV2D:
+                    if (blocked) { // Depthwise
+                        result = graph.Conv2D(addInput("x", {2, 19, 13, 11}, key.layout), graph.AddInput("w", dtype, {19, 1, 3, 3}),
+                                              graph.AddInput("bias", dtype, {19}), {2, 1}, {1, 1}, 19);
+                        epilogue = {{NextGraph::EpilogueStep{OpType::ADD, 0, true}, {2, 19, 7, 11}}, {NextGraph::EpilogueStep{OpType::RELU}, {}}};
+                        break;
+                    }
+                    switch (variant) {
+                        case 1: case 2: // Winograd: 3x3, stride 1, at least 16 channels
+                            result = graph.Conv2D(graph.AddInput("x", dtype, {1, 17, 10, 9}), graph.AddInput("w", dtype, {19, 17, 3, 3}),
+                                                  graph.AddInput("bias", dtype, {19}), {1, 1}, {1, 1});
+                            graph.GetNode(graph.GetValue(result).producer).attributes.algorithm =
+                                variant == 1 ? NextKernels::ConvAlgorithm::WINOGRAD_2X3 : NextKernels::ConvAlgorithm::WINOGRAD_4X3;
+                            epilogue = {{NextGraph::EpilogueStep{OpType::ADD, 0, true}, {19, 1, 1}}, {NextGraph::EpilogueStep{OpType::RELU}, {}}};
+                            break;
+                        case 3: // Depthwise
+                            result = graph.Conv2D(graph.AddInput("x", dtype, {2, 6, 13, 11}), graph.AddInput("w", dtype, {6, 1, 3, 3}),
+                                                  graph.AddInput("bias", dtype, {6}), {2, 1}, {1, 1}, 6);
+                            epilogue = {{NextGraph::EpilogueStep{OpType::ADD, 0, true}, {6, 1, 1}}, {NextGraph::EpilogueStep{OpType::RELU}, {}}};
+                            break;
+                        case 4: // Narrow groups: 4 input channels per group
+                            result = graph.Conv2D(graph.AddInput("x", dtype, {1, 8, 9, 10}), graph.AddInput("w", dtype, {6, 4, 5, 3}),
+                                                  graph.AddInput("bias", dtype, {6}), {1, 2}, {2, 1}, 2);
+                            epilogue = {{NextGraph::EpilogueStep{OpType::ADD, 0, true}, {6, 1, 1}}, {NextGraph::EpilogueStep{OpType::RELU}, {}}};
+                            break;
+                        default:
+                            result = graph.Conv2D(graph.AddInput("x", dtype, {2, 5, 13, 11}), graph.AddInput("w", dtype, {7, 5, 3, 3}),
+                                                  graph.AddInput("bias", dtype, {7}), {2, 1}, {1, 1});
+                            epilogue = {{NextGraph::EpilogueStep{OpType::ADD, 0, true}, {7, 1, 1}}, {NextGraph::EpilogueStep{OpType::RELU}, {}}};
+                            break;
+                    }
+                    break;
+                case OpType::MAXPOOL: case OpType::AVGPOOL:
+                    result = graph.AddNode(key.op, {addInput("x", {2, blocked ? size_t(19) : size_t(3), 15, 14}, key.layout)},
+                                           [] { NextGraph::NodeAttributes a; a.kernel = {3, 3}; a.strides = {2, 2}; a.padding = {1, 1}; return a; }());
+                    break;
+                case OpType::RESHAPE:
+                    result = graph.Reshape(graph.AddInput("x", dtype, {6, 35}), {5, 42});
+                    break;
+                case OpType::FLATTEN:
+                    result = graph.Flatten(graph.AddInput("x", dtype, {3, 4, 5}), 1);
+                    break;
+                case OpType::TRANSPOSE:
+                    result = graph.Transpose(graph.AddInput("x", dtype, {4, 6, 5}), {2, 0, 1});
+                    break;
+                case OpType::REORDER: // Into a blocked layout, or out of one into ROW_MAJOR
+                    result = graph.Reorder(addInput("x", {2, 19, 5, 7}, blocked ? MemoryLayout::ROW_MAJOR : MemoryLayout::NCHW16C), key.layout);
+                    break;
+                default:
+                    return {std::move(graph), NextGraph::InvalidId};
+            }
+            const NodeId node = graph.GetValue(result).producer;
+            if (isFloat) {
+                for (auto &[step, shape] : epilogue) {
+                    if (step.operand != NextGraph::InvalidId) {
+                        step.operand = graph.GetNode(node).inputs.size();
+                        graph.AppendNodeInput(node, addInput("operand", shape, blocked ? key.layout : MemoryLayout::ROW_MAJOR));
+                    }
+                    graph.GetNode(node).epilogue.push_back(step);
+                }
+            }
+            graph.GetValue(result).layout = key.layout;
+            graph.MarkOutput(result);
+            NextGraph::InferShapes(graph);
+            return {std::move(graph), node};
+        }
+
+        // Deterministic operand values: small integers for integer types, [-2, 2] (or [0.5, 2.5] for divisors) for floats
+        inline void FillValidationData(DataType dtype, void *data, size_t count, uint64_t seed, bool divisor) {
+            NextKernels::DispatchDataType(dtype, [&](auto tag) {
+                using T = typename decltype(tag)::type;
+                uint64_t state = seed * 6364136223846793005ull + 1442695040888963407ull;
+                for (size_t i = 0; i < count; ++i) {
+                    state = state * 6364136223846793005ull + 1442695040888963407ull;
+                    const uint32_t bits = static_cast<uint32_t>(state >> 33);
+                    if constexpr (std::is_same_v<T, bool>) {
+                        static_cast<T *>(data)[i] = (bits & 1) != 0;
+                    } else if constexpr (std::is_floating_point_v<T>) {
+                        const double unit = static_cast<double>(bits) / 2147483648.0; // [0, 1)
+                        static_cast<T *>(data)[i] = static_cast<T>(divisor ? 0.5 + 2.0 * unit : 4.0 * unit - 2.0);
+                    } else {
+                        static_cast<T *>(data)[i] = static_cast<T>(divisor ? 1 + bits % 5 : bits % 10);
+                    }
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief Checks the numerics of every kernel of an engine against the reference engine.
+     * Every kernel whose key the reference also covers runs its small cases (see Detail::MakeValidationCase) on the
+     * same deterministic inputs as the reference kernel, and the outputs are compared element by element.
+     * @param engine The engine to validate.
+     * @param reference The engine providing the expected results.
+     * @param tolerance Largest accepted |kernel - reference| / max(1, |reference|). The Winograd F(4x4, 3x3) case gets
+     * ten times as much: its transforms (coefficients up to 8) amplify rounding about tenfold.
+     * @param context The execution context the kernels run on.
+     * @return One result per validated case.
+     * @throws Rethrows any exception thrown by a kernel.
+     * **/
+    inline std::vector<KernelValidation> ValidateEngine(const Engine &engine, const Engine &reference = ReferenceEngine(), double tolerance = 1e-4,
+                                                        ExecutionContext &context = GetDefaultContext()) {
+        std::vector<KernelValidation> results;
+        for (const KernelKey &key : engine.GetKernelKeys()) {
+            const KernelEntry *expected = reference.FindKernel(key);
+            if (!expected) continue;
+            for (size_t variant = 0;; ++variant) {
+                auto [graph, nodeId] = Detail::MakeValidationCase(key, variant);
+                if (nodeId == NextGraph::InvalidId) break;
+                const Node &node = graph.GetNode(nodeId);
+                const size_t elementSize = NextTypes::GetDataTypeSize(key.dtype);
+
+                std::vector<NextMemory::StoragePtr> storages;
+                NodeBuffers buffers;
+                buffers.dtype = key.dtype;
+                for (size_t slot = 0; slot < node.inputs.size(); ++slot) {
+                    const TensorMetadata &meta = *graph.GetValue(node.inputs[slot]).metadata;
+                    storages.push_back(NextMemory::Storage::Create(std::max<size_t>(1, meta.GetStorageSize() * elementSize)));
+                    Detail::FillValidationData(key.dtype, storages.back()->GetData(), meta.GetStorageSize(), slot + 1, key.op == OpType::DIV && slot == 1);
+                    buffers.inputs.push_back(storages.back()->GetData());
+                    buffers.inputMetas.push_back(meta);
+                }
+                buffers.outMeta = TensorMetadata(graph.GetValue(node.outputs.front()).metadata->GetShape(), key.layout);
+                const size_t count = buffers.outMeta.GetTotalSize(), storageSize = buffers.outMeta.GetStorageSize();
+                NextMemory::StoragePtr actual = NextMemory::Storage::Create(std::max<size_t>(1, storageSize * elementSize));
+                NextMemory::StoragePtr wanted = NextMemory::Storage::Create(std::max<size_t>(1, storageSize * elementSize));
+
+                buffers.out = actual->GetData();
+                engine.FindKernel(key)->run(node, buffers, context);
+                buffers.out = wanted->GetData();
+                expected->run(node, buffers, context);
+
+                KernelValidation result;
+                result.key = key;
+                result.variant = variant;
+                NextKernels::DispatchDataType(key.dtype, [&](auto tag) {
+                    using T = typename decltype(tag)::type;
+                    const T *lhs = static_cast<const T *>(actual->GetData());
+                    const T *rhs = static_cast<const T *>(wanted->GetData());
+                    for (size_t i = 0; i < count; ++i) {
+                        const size_t offset = NextKernels::Reference::Detail::OffsetOf(buffers.outMeta, i); // Channel padding is not compared
+                        const double x = static_cast<double>(lhs[offset]), y = static_cast<double>(rhs[offset]);
+                        const double error = std::fabs(x - y) / std::max(1.0, std::fabs(y));
+                        if (std::isnan(error)) result.maxError = std::numeric_limits<double>::infinity();
+                        else result.maxError = std::max(result.maxError, error);
+                    }
+                });
+                const bool winograd4 = node.op == OpType::CONV2D && node.attributes.algorithm == NextKernels::ConvAlgorithm::WINOGRAD_4X3;
+                result.passed = result.maxError <= (winograd4 ? 10 * tolerance : tolerance);
+                results.push_back(result);
+            }
+        }
+        return results;
+    }
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "Context.hpp"
+#include "../Graph/Graph.hpp"
+#include "../Graph/Passes/ShapeInference.hpp"
+#include "../Kernels/Conv.hpp"
+#include "../Kernels/Copy.hpp"
+#include "../Kernels/Fused.hpp"
+#include "../Kernels/Gemm.hpp"
+#include "../Kernels/Pool.hpp"
+#include "../Kernels/Reorder.hpp"
+#include "../Kernels/Softmax.hpp"
+#include "../../Utils/NextShapeUtils.hpp"
+#include <tuple>  // std::tie
+#include <vector> // std::vector
+
+namespace NextExecution
+{
+    using NextGraph::Node;
+    using NextTypes::OpType;
+
+    /**
+     * @brief The memory a node reads and writes during one evaluation.
+     * inputs/inputMetas have one entry per Node::inputs (head operands, then epilogue operands).
+     * **/
+    struct NodeBuffers {
+        DataType dtype = DataType::UNKNOWN;          // Element type of every operand
+        void *out = nullptr;                          // Start of the output buffer
+        TensorMetadata outMeta{TensorShapeDynamic{}}; // Output metadata (offset relative to out)
+        std::vector<const void *> inputs;             // Start of every input buffer
+        std::vector<TensorMetadata> inputMetas;       // Input metadata (offsets relative to their buffer)
+    };
+
+    /**
+     * @brief Checks whether EvaluateNode has a kernel for an operation.
+     * @param op The operation.
+     * @return True if nodes of this operation can be evaluated.
+     * **/
+    [[nodiscard]] inline bool CanEvaluate(OpType op) noexcept {
+        switch (op) {
+            case OpType::ADD: case OpType::SUB: case OpType::MUL: case OpType::DIV:
+            case OpType::RELU: case OpType::SIGMOID: case OpType::TANH:
+            case OpType::MATMUL: case OpType::SOFTMAX: case OpType::CONV2D:
+            case OpType::MAXPOOL: case OpType::AVGPOOL:
+            case OpType::FLATTEN: case OpType::RESHAPE: case OpType::TRANSPOSE: case OpType::REORDER:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief Resolves the epilogue steps of a node against its buffers.
+     * @param node The node.
+     * @param buffers Its input and output buffers.
+     * @return One operation per Node::epilogue step, with operand addresses and metadata filled in.
+     * **/
+    [[nodiscard]] inline std::vector<NextKernels::EpilogueOperation> GetEpilogueOperations(const Node &node, const NodeBuffers &buffers) {
+        std::vector<NextKernels::EpilogueOperation> operations;
+        operations.reserve(node.epilogue.size());
+        for (const NextGraph::EpilogueStep &step : node.epilogue) {
+            NextKernels::EpilogueOperation operation;
+            operation.op = step.op;
+            if (step.operand != NextGraph::InvalidId) {
+                operation.operand = buffers.inputs[step.operand];
+                operation.operandMeta = buffers.inputMetas[step.operand];
+                operation.operandOnLeft = step.operandOnLeft;
+            }
+            operations.push_back(std::move(operation));
+        }
+        return operations;
+    }
+
+    namespace Detail
+    {
+        // A channel-blocked tensor seen as the flat array of its storage (channel padding included)
+        inline TensorMetadata FlattenBlocked(const TensorMetadata &meta) {
+            return meta.GetChannelBlock() == 0 ? meta : TensorMetadata(TensorShapeDynamic{meta.GetStorageSize()}, meta.GetOffset());
+        }
+
+        // A channel-blocked tensor [N, C, H, W] seen as the channels-last tensor [N * ceil(C / b), b, H, W]
+        inline TensorMetadata BlockedAsChannelsLast(const TensorMetadata &meta) {
+            const TensorShapeDynamic &shape = meta.GetShape();
+            const size_t block = meta.GetChannelBlock();
+            return TensorMetadata(TensorShapeDynamic{shape[0] * ((shape[1] + block - 1) / block), block, shape[2], shape[3]},
+                                  TensorStrideDynamic{meta.GetBlockStride(), 1, meta.GetStrides()[2], meta.GetStrides()[3]}, meta.GetOffset());
+        }
+
+        /**
+         * @brief Runs a pooling or depthwise convolution node whose operands are channel-blocked (checked by
+         * CheckLayouts), then its epilogue over the flat storage.
+         * Pooling sees every channel block as a channels-last tensor of b channels, so one call covers all of them
+         * (the channel padding is pooled too and stays unspecified); the convolution runs the blocked depthwise kernel,
+         * which applies the epilogue row by row.
+         * **/
+        inline void EvaluateBlockedWindowed(const Node &node, const NodeBuffers &buffers, const NodeBuffers &flat, ExecutionContext &context) {
+            const TensorMetadata &inMeta = buffers.inputMetas[0];
+            const TensorMetadata &outMeta = buffers.outMeta;
+            if (node.op == OpType::CONV2D) {
+                NextKernels::Conv2DParams params;
+                std::tie(params.strideH, params.strideW) = NextGraph::Detail::GetSpatialPair(node.attributes.strides, 1, 1, "Strides");
+                std::tie(params.padH, params.padW) = NextGraph::Detail::GetSpatialPair(node.attributes.padding, 0, 0, "Padding");
+                params.groups = node.attributes.groups;
+                const bool hasBias = NextGraph::GetNumHeadInputs(node) == 3;
+                const NextKernels::Epilogue epilogue(buffers.dtype, buffers.out, flat.outMeta, GetEpilogueOperations(node, flat));
+                NextKernels::DepthwiseConv2DBlocked(buffers.dtype, buffers.out, outMeta, buffers.inputs[0], inMeta, buffers.inputs[1], buffers.inputMetas[1],
+                                                    hasBias ? buffers.inputs[2] : nullptr, hasBias ? &buffers.inputMetas[2] : nullptr, params, context, &epilogue);
+                return;
+            }
+            NextKernels::Pool2DParams params;
+            if (node.attributes.kernel.size() != 2) {
+                throw std::invalid_argument("Pooling requires a kernel {kh, kw}.");
+            }
+            params.kernelH = node.attributes.kernel[0];
+            params.kernelW = node.attributes.kernel[1];
+            std::tie(params.strideH, params.strideW) = NextGraph::Detail::GetSpatialPair(node.attributes.strides, params.kernelH, params.kernelW, "Strides");
+            std::tie(params.padH, params.padW) = NextGraph::Detail::GetSpatialPair(node.attributes.padding, 0, 0, "Padding");
+            NextKernels::Pool2D(node.op, buffers.dtype, buffers.out, BlockedAsChannelsLast(outMeta), buffers.inputs[0], BlockedAsChannelsLast(inMeta), params, context);
+            const NextKernels::Epilogue epilogue(buffers.dtype, buffers.out, flat.outMeta, GetEpilogueOperations(node, flat));
+            if (!epilogue.IsEmpty()) {
+                context.ParallelFor(0, flat.outMeta.GetTotalSize(), NextKernels::Detail::ElementwiseGrain,
+                                    [&](size_t begin, size_t end) { epilogue.Apply(begin, end); });
+            }
+        }
+    }
+
+    /**
+     * @brief Runs one graph node on explicit buffers, including its fused epilogue.
+     * RESHAPE/FLATTEN/TRANSPOSE always materialize their result into the output buffer (callers skip the nodes
+     * whose output is a view of the input); RESHAPE and FLATTEN then require a contiguous output.
+     * A channel-blocked output (see NextTypes::MemoryLayout) selects the blocked kernels: elementwise nodes run on the
+     * flat storage of their operands, pooling and depthwise convolution on the channel blocks (see
+     * Detail::EvaluateBlockedWindowed). REORDER converts between layouts.
+     * @param node The node (shapes inferred).
+     * @param buffers Its input and output buffers.
+     * @param context The execution context the kernel runs on.
+     * @throws std::invalid_argument if there is no kernel for the operation, or on any kernel error.
+     * **/
+    inline void EvaluateNode(const Node &node, const NodeBuffers &buffers, ExecutionContext &context = GetDefaultContext()) {
+        if (buffers.inputs.size() != node.inputs.size() || buffers.inputMetas.size() != node.inputs.size()) {
+            throw std::invalid_argument("Node buffers do not match the node inputs.");
+        }
+        if (node.op != OpType::REORDER && buffers.outMeta.GetChannelBlock() != 0) {
+            NodeBuffers flat = buffers;
+            flat.outMeta = Detail::FlattenBlocked(buffers.outMeta);
+            for (TensorMetadata &meta : flat.inputMetas) meta = Detail::FlattenBlocked(meta);
+            if (node.op == OpType::MAXPOOL || node.op == OpType::AVGPOOL || node.op == OpType::CONV2D) {
+                Detail::EvaluateBlockedWindowed(node, buffers, flat, context);
+            } else {
+                EvaluateNode(node, flat, context); // Operands of the same shape and layout: lane by lane
+            }
+            return;
+        }
+        std::vector<NextKernels::EpilogueOperation> steps = GetEpilogueOperations(node, buffers);
+        const bool fused = !steps.empty();
+        if (fused && (node.op == OpType::FLATTEN || node.op == OpType::RESHAPE || node.op == OpType::TRANSPOSE || node.op == OpType::REORDER)) {
+            throw std::invalid_argument("View operations cannot have an epilogue.");
+        }
+        const size_t headInputs = NextGraph::GetNumHeadInputs(node);
+        const std::vector<const void *> headData(buffers.inputs.begin(), buffers.inputs.begin() + static_cast<std::ptrdiff_t>(headInputs));
+        const std::vector<TensorMetadata> headMetas(buffers.inputMetas.begin(), buffers.inputMetas.begin() + static_cast<std::ptrdiff_t>(headInputs));
+
+        switch (node.op) {
+            case OpType::ADD: case OpType::SUB: case OpType::MUL: case OpType::DIV:
+            case OpType::RELU: case OpType::SIGMOID: case OpType::TANH: {
+                if (fused) {
+                    const NextKernels::Epilogue epilogue(buffers.dtype, buffers.out, buffers.outMeta, std::move(steps));
+                    NextKernels::FusedElementwise(node.op, buffers.dtype, buffers.out, buffers.outMeta, headData, headMetas, epilogue, context);
+                } else if (headInputs == 2) {
+                    NextKernels::ElementwiseBinary(node.op, buffers.dtype, buffers.out, buffers.outMeta, headData[0], headMetas[0],
+                                                   headData[1], headMetas[1], context);
+                } else {
+                    NextKernels::ElementwiseUnary(node.op, buffers.dtype, buffers.out, buffers.outMeta, headData[0], headMetas[0], context);
+                }
+                break;
+            }
+            case OpType::MATMUL: {
+                if (fused) {
+                    const NextKernels::Epilogue epilogue(buffers.dtype, buffers.out, buffers.outMeta, std::move(steps));
+                    NextKernels::MatMul(buffers.dtype, buffers.out, buffers.outMeta, headData[0], headMetas[0], headData[1], headMetas[1], context, &epilogue);
+                } else {
+                    NextKernels::MatMul(buffers.dtype, buffers.out, buffers.outMeta, headData[0], headMetas[0], headData[1], headMetas[1], context);
+                }
+                break;
+            }
+            case OpType::CONV2D: {
+                NextKernels::Conv2DParams params;
+                std::tie(params.strideH, params.strideW) = NextGraph::Detail::GetSpatialPair(node.attributes.strides, 1, 1, "Strides");
+                std::tie(params.padH, params.padW) = NextGraph::Detail::GetSpatialPair(node.attributes.padding, 0, 0, "Padding");
+                params.groups = node.attributes.groups;
+                const void *bias = headInputs == 3 ? headData[2] : nullptr;
+                const TensorMetadata *biasMeta = headInputs == 3 ? &headMetas[2] : nullptr;
+                if (fused) {
+                    const NextKernels::Epilogue epilogue(buffers.dtype, buffers.out, buffers.outMeta, std::move(steps));
+                    NextKernels::Conv2D(buffers.dtype, buffers.out, buffers.outMeta, headData[0], headMetas[0], headData[1], headMetas[1],
+                                        bias, biasMeta, params, node.attributes.algorithm, context, &epilogue);
+                } else {
+                    NextKernels::Conv2D(buffers.dtype, buffers.out, buffers.outMeta, headData[0], headMetas[0], headData[1], headMetas[1],
+                                        bias, biasMeta, params, node.attributes.algorithm, context);
+                }
+                break;
+            }
+            case OpType::MAXPOOL: case OpType::AVGPOOL: {
+                NextKernels::Pool2DParams params;
+                if (node.attributes.kernel.size() != 2) {
+                    throw std::invalid_argument("Pooling requires a kernel {kh, kw}.");
+                }
+                params.kernelH = node.attributes.kernel[0];
+                params.kernelW = node.attributes.kernel[1];
+                std::tie(params.strideH, params.strideW) = NextGraph::Detail::GetSpatialPair(node.attributes.strides, params.kernelH, params.kernelW, "Strides");
+                std::tie(params.padH, params.padW) = NextGraph::Detail::GetSpatialPair(node.attributes.padding, 0, 0, "Padding");
+                if (fused) {
+                    const NextKernels::Epilogue epilogue(buffers.dtype, buffers.out, buffers.outMeta, std::move(steps));
+                    NextKernels::Pool2D(node.op, buffers.dtype, buffers.out, buffers.outMeta, headData[0], headMetas[0], params, context, &epilogue);
+                } else {
+                    NextKernels::Pool2D(node.op, buffers.dtype, buffers.out, buffers.outMeta, headData[0], headMetas[0], params, context);
+                }
+                break;
+            }
+            case OpType::SOFTMAX: {
+                NextKernels::Softmax(buffers.dtype, buffers.out, buffers.outMeta, headData[0], headMetas[0],
+                                     NextGraph::Detail::NormalizeAxis(node.attributes.axis, headMetas[0].GetRank()), context);
+                if (fused) {
+                    const NextKernels::Epilogue epilogue(buffers.dtype, buffers.out, buffers.outMeta, std::move(steps));
+                    context.ParallelFor(0, buffers.outMeta.GetTotalSize(), NextKernels::Detail::ElementwiseGrain,
+                                        [&](size_t begin, size_t end) { epilogue.Apply(begin, end); });
+                }
+                break;
+            }
+            case OpType::FLATTEN: case OpType::RESHAPE: {
+                // Same elements in row-major order: copy through the output buffer viewed with the input shape
+                if (!buffers.outMeta.IsContiguous()) {
+                    throw std::invalid_argument("RESHAPE requires a contiguous output.");
+                }
+                const TensorMetadata outAsInput(headMetas[0].GetShape(), buffers.outMeta.GetOffset());
+                NextKernels::Copy(buffers.dtype, buffers.out, outAsInput, headData[0], headMetas[0], context);
+                break;
+            }
+            case OpType::TRANSPOSE: {
+                NextKernels::Copy(buffers.dtype, buffers.out, buffers.outMeta, headData[0],
+                                  NextShapeUtils::NextPermute(headMetas[0], node.attributes.axes), context);
+                break;
+            }
+            case OpType::REORDER: {
+                NextKernels::Reorder(buffers.dtype, buffers.out, buffers.outMeta, headData[0], headMetas[0], context);
+                break;
+            }
+            default:
+                throw std::invalid_argument("No kernel is available for this operation.");
+        }
+    }
+}
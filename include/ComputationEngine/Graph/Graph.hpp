@@ -0,0 +1,564 @@
+#pragma once
+
+#include "../../Core/TensorInterface.hpp"
+#include "../../Core/Memory/Storage.hpp"
+#include "../../Utils/NextTypes/NextMemoryLayout.hpp"
+#include "../../Utils/NextTypes/NextOpType.hpp"
+#include "../Kernels/Conv.hpp"
+#include "../Kernels/Copy.hpp"
+#include <cstdint>   // int64_t
+#include <optional>  // std::optional
+#include <stdexcept> // std::invalid_argument, std::out_of_range
+#include <string>    // std::string
+#include <utility>   // std::move
+#include <vector>    // std::vector
+
+namespace NextGraph
+{
+    using OpType = NextTypes::OpType;
+    using MemoryLayout = NextTypes::MemoryLayout;
+    using NextTensor::TensorInterface;
+
+    using ValueId = size_t; // Index of a value in its graph
+    using NodeId = size_t;  // Index of a node in its graph
+    inline constexpr size_t InvalidId = static_cast<size_t>(-1);
+
+    /**
+     * @enum ValueKind
+     * @brief Where the data of a graph value comes from.
+     * Values : INPUT (bound at every run), CONSTANT (owned by the graph, e.g. weights), INTERMEDIATE (produced by a node)
+     * **/
+    enum class ValueKind {
+        INPUT,
+        CONSTANT,
+        INTERMEDIATE
+    };
+
+    /**
+     * @brief Operator attributes. Each OpType reads only the fields documented for it.
+     * **/
+    struct NodeAttributes {
+        TensorShapeDynamic shape;   // RESHAPE: target shape
+        TensorIndexDynamic axes;    // TRANSPOSE: permutation (empty = reverse the dimensions)
+        int64_t axis = -1;          // SOFTMAX: reduced axis; FLATTEN: first flattened axis (negative counts from the end)
+        TensorIndexDynamic kernel;  // MAXPOOL/AVGPOOL: window {kh, kw} (CONV2D takes it from the weight)
+        TensorIndexDynamic strides; // CONV2D/MAXPOOL/AVGPOOL: {sh, sw} (empty = 1 for CONV2D, the window for pools)
+        TensorIndexDynamic padding; // CONV2D/MAXPOOL/AVGPOOL: zero padding {ph, pw} on both sides (empty = 0)
+        size_t groups = 1;          // CONV2D: channel groups (groups == C is a depthwise convolution)
+        NextKernels::ConvAlgorithm algorithm = NextKernels::ConvAlgorithm::AUTO; // CONV2D: algorithm of the plain-layout kernel
+
+        bool operator==(const NodeAttributes &other) const {
+            return shape == other.shape && axes == other.axes && axis == other.axis && kernel == other.kernel &&
+                   strides == other.strides && padding == other.padding && groups == other.groups && algorithm == other.algorithm;
+        }
+        bool operator!=(const NodeAttributes &other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief A tensor flowing along the edges of the graph.
+     * **/
+    struct Value {
+        std::string name;                      // Debug name (may be empty)
+        ValueKind kind = ValueKind::INTERMEDIATE;
+        DataType dtype = DataType::UNKNOWN;    // Element type
+        std::optional<TensorMetadata> metadata; // Shape, strides and offset; known for inputs and constants, inferred for the rest
+        NodeId producer = InvalidId;           // Node that writes the value (InvalidId for inputs and constants)
+        ValueId aliasOf = InvalidId;           // View values: the value whose buffer they view (set by shape inference)
+        std::vector<NodeId> consumers;         // Nodes that read the value (one entry per use)
+        bool isOutput = false;                 // Whether the value is a graph output
+        MemoryLayout layout = MemoryLayout::ROW_MAJOR; // Physical layout of the elements (kernels are selected per layout, see AssignLayouts)
+        NextMemory::StoragePtr data;           // CONSTANT: the element data described by metadata
+    };
+
+    /**
+     * @brief An elementwise operation fused after the main operation of a node (set by the fusion pass).
+     * **/
+    struct EpilogueStep {
+        OpType op = OpType::UNKNOWN;  // ADD, SUB, MUL, DIV, RELU, SIGMOID or TANH
+        size_t operand = InvalidId;   // Binary steps: position of the other operand in Node::inputs
+        bool operandOnLeft = false;   // Binary steps: the operand is the left-hand side (operand <op> result)
+    };
+
+    /**
+     * @brief An operation of the graph.
+     * **/
+    struct Node {
+        std::string name;                   // Debug name (may be empty)
+        OpType op = OpType::UNKNOWN;        // Operation
+        std::vector<ValueId> inputs;        // Operands, in the order the operation expects, then the epilogue operands
+        std::vector<ValueId> outputs;       // Results
+        NodeAttributes attributes;          // Operation parameters
+        std::vector<EpilogueStep> epilogue; // Elementwise steps applied in order to the result before it is stored
+        bool erased = false;                // Removed by a rewrite; skipped by every traversal
+    };
+
+    /**
+     * @brief Gets the number of inputs read by the main operation of a node (its inputs minus the epilogue operands).
+     * @param node The node.
+     * @return The number of leading inputs that belong to the operation itself.
+     * **/
+    [[nodiscard]] inline size_t GetNumHeadInputs(const Node &node) noexcept {
+        size_t operands = 0;
+        for (const EpilogueStep &step : node.epilogue) {
+            if (step.operand != InvalidId) ++operands;
+        }
+        return node.inputs.size() - operands;
+    }
+
+    /**
+     * @brief Gets the number of inputs an operation takes.
+     * @param op The operation.
+     * @return The minimum and maximum number of inputs (CONV2D takes an optional bias).
+     * **/
+    [[nodiscard]] inline std::pair<size_t, size_t> GetOpArity(OpType op) noexcept {
+        switch (op) {
+            case OpType::ADD: case OpType::SUB: case OpType::MUL: case OpType::DIV: case OpType::MATMUL:
+                return {2, 2};
+            case OpType::CONV2D:
+                return {2, 3};
+            case OpType::RELU: case OpType::SIGMOID: case OpType::TANH: case OpType::SOFTMAX:
+            case OpType::MAXPOOL: case OpType::AVGPOOL: case OpType::FLATTEN: case OpType::RESHAPE: case OpType::TRANSPOSE:
+            case OpType::REORDER:
+                return {1, 1};
+            default:
+                return {0, 0};
+        }
+    }
+
+    /**
+     * @class Graph
+     * @brief A dataflow graph of tensor operations, recorded once and executed many times.
+     *
+     * Values (tensors) and nodes (operations) are stored in flat arrays and referred to by index, so ids stay valid
+     * while passes rewrite the graph: a removed node is only marked erased. Every value has at most one producer;
+     * graph inputs are bound at run time, constants (weights) are owned by the graph.
+     * Value metadata is known for inputs and constants and filled in for the rest by shape inference.
+     * **/
+    class Graph {
+    public:
+        Graph() = default;
+
+        // Builder
+
+        /**
+         * @brief Declares a graph input.
+         * @param name Debug name.
+         * @param dtype Element type.
+         * @param shape Shape; inputs are bound as contiguous tensors.
+         * @return The id of the input value.
+         * @throws std::invalid_argument if the data type is unknown.
+         * **/
+        ValueId AddInput(const std::string &name, DataType dtype, const TensorShapeDynamic &shape) {
+            if (NextTypes::GetDataTypeSize(dtype) == 0) {
+                throw std::invalid_argument("Graph input requires a known data type.");
+            }
+            const ValueId id = NewValue(name, ValueKind::INPUT, dtype);
+            values_[id].metadata = TensorMetadata(shape);
+            inputs_.push_back(id);
+            return id;
+        }
+
+        /**
+         * @brief Adds a constant that shares an existing storage (no copy).
+         * @param name Debug name.
+         * @param storage The element data.
+         * @param metadata Layout of the constant inside the storage.
+         * @param dtype Element type.
+         * @return The id of the constant value.
+         * @throws std::invalid_argument if the storage is null, the data type unknown or the storage too small.
+         * **/
+        ValueId AddConstant(const std::string &name, NextMemory::StoragePtr storage, const TensorMetadata &metadata, DataType dtype) {
+            const size_t elementSize = NextTypes::GetDataTypeSize(dtype);
+            if (!storage || elementSize == 0) {
+                throw std::invalid_argument("Graph constant requires a storage and a known data type.");
+            }
+            if (NextUtils::ComputeStorageSize(metadata.GetShape(), metadata.GetStrides(), metadata.GetOffset()) * elementSize > storage->GetSize()) {
+                throw std::invalid_argument("Graph constant metadata addresses elements outside of the storage.");
+            }
+            const ValueId id = NewValue(name, ValueKind::CONSTANT, dtype);
+            values_[id].metadata = metadata;
+            values_[id].data = std::move(storage);
+            return id;
+        }
+
+        /**
+         * @brief Adds a constant holding a contiguous copy of a tensor.
+         * @param name Debug name.
+         * @param tensor The tensor to copy (any layout).
+         * @return The id of the constant value.
+         * @throws std::invalid_argument if the data type is unknown.
+         * **/
+        ValueId AddConstant(const std::string &name, const TensorInterface &tensor) {
+            const DataType dtype = tensor.GetDataType();
+            const size_t elementSize = NextTypes::GetDataTypeSize(dtype);
+            if (elementSize == 0) {
+                throw std::invalid_argument("Graph constant requires a known data type.");
+            }
+            const TensorMetadata metadata(tensor.GetMetadata().GetShape());
+            NextMemory::StoragePtr storage = NextMemory::Storage::Create(metadata.GetTotalSize() * elementSize);
+            NextKernels::Copy(dtype, storage->GetData(), metadata, tensor.GetRawData(), tensor.GetMetadata());
+            return AddConstant(name, std::move(storage), metadata, dtype);
+        }
+
+        /**
+         * @brief Adds a node with a single output.
+         * The output data type is that of the first input; its metadata is left to shape inference.
+         * @param op The operation.
+         * @param inputs The operand values.
+         * @param attributes The operation parameters.
+         * @param name Debug name.
+         * @return The id of the output value.
+         * @throws std::invalid_argument if the operation is unknown or takes a different number of inputs.
+         * @throws std::out_of_range if an input id does not exist.
+         * **/
+        ValueId AddNode(OpType op, const std::vector<ValueId> &inputs, const NodeAttributes &attributes = {}, const std::string &name = "") {
+            const auto [minInputs, maxInputs] = GetOpArity(op);
+            if (maxInputs == 0) {
+                throw std::invalid_argument("Graph node requires a known operation.");
+            }
+            if (inputs.size() < minInputs || inputs.size() > maxInputs) {
+                throw std::invalid_argument("Graph node has the wrong number of inputs for its operation.");
+            }
+            for (ValueId input : inputs) CheckValue(input);
+
+            const NodeId nodeId = nodes_.size();
+            nodes_.emplace_back();
+            Node &node = nodes_.back();
+            node.name = name;
+            node.op = op;
+            node.inputs = inputs;
+            node.attributes = attributes;
+            for (ValueId input : inputs) values_[input].consumers.push_back(nodeId);
+
+            const ValueId output = NewValue(name, ValueKind::INTERMEDIATE, values_[inputs.front()].dtype);
+            values_[output].producer = nodeId;
+            nodes_[nodeId].outputs.push_back(output);
+            return output;
+        }
+
+        ValueId Add(ValueId a, ValueId b, const std::string &name = "") { return AddNode(OpType::ADD, {a, b}, {}, name); }
+        ValueId Sub(ValueId a, ValueId b, const std::string &name = "") { return AddNode(OpType::SUB, {a, b}, {}, name); }
+        ValueId Mul(ValueId a, ValueId b, const std::string &name = "") { return AddNode(OpType::MUL, {a, b}, {}, name); }
+        ValueId Div(ValueId a, ValueId b, const std::string &name = "") { return AddNode(OpType::DIV, {a, b}, {}, name); }
+        ValueId MatMul(ValueId a, ValueId b, const std::string &name = "") { return AddNode(OpType::MATMUL, {a, b}, {}, name); }
+        ValueId Relu(ValueId x, const std::string &name = "") { return AddNode(OpType::RELU, {x}, {}, name); }
+        ValueId Sigmoid(ValueId x, const std::string &name = "") { return AddNode(OpType::SIGMOID, {x}, {}, name); }
+        ValueId Tanh(ValueId x, const std::string &name = "") { return AddNode(OpType::TANH, {x}, {}, name); }
+
+        ValueId Softmax(ValueId x, int64_t axis = -1, const std::string &name = "") {
+            NodeAttributes attributes;
+            attributes.axis = axis;
+            return AddNode(OpType::SOFTMAX, {x}, attributes, name);
+        }
+
+        ValueId Flatten(ValueId x, int64_t axis = 1, const std::string &name = "") {
+            NodeAttributes attributes;
+            attributes.axis = axis;
+            return AddNode(OpType::FLATTEN, {x}, attributes, name);
+        }
+
+        ValueId Reshape(ValueId x, const TensorShapeDynamic &shape, const std::string &name = "") {
+            NodeAttributes attributes;
+            attributes.shape = shape;
+            return AddNode(OpType::RESHAPE, {x}, attributes, name);
+        }
+
+        ValueId Transpose(ValueId x, const TensorIndexDynamic &axes = {}, const std::string &name = "") {
+            NodeAttributes attributes;
+            attributes.axes = axes;
+            return AddNode(OpType::TRANSPOSE, {x}, attributes, name);
+        }
+
+        /**
+         * @brief Adds a 2D convolution of x [N, C, H, W] with weight [O, C / groups, KH, KW] and an optional bias [O].
+         * @param bias The bias value, or InvalidId for none.
+         * @param groups Channel groups: output channels [g * O / groups, (g + 1) * O / groups) read input channels
+         * [g * C / groups, (g + 1) * C / groups) only.
+         * **/
+        ValueId Conv2D(ValueId x, ValueId weight, ValueId bias = InvalidId, const TensorIndexDynamic &strides = {},
+                       const TensorIndexDynamic &padding = {}, size_t groups = 1, const std::string &name = "") {
+            NodeAttributes attributes;
+            attributes.strides = strides;
+            attributes.padding = padding;
+            attributes.groups = groups;
+            if (bias == InvalidId) return AddNode(OpType::CONV2D, {x, weight}, attributes, name);
+            return AddNode(OpType::CONV2D, {x, weight, bias}, attributes, name);
+        }
+
+        ValueId MaxPool(ValueId x, const TensorIndexDynamic &kernel, const TensorIndexDynamic &strides = {},
+                        const TensorIndexDynamic &padding = {}, const std::string &name = "") {
+            NodeAttributes attributes;
+            attributes.kernel = kernel;
+            attributes.strides = strides;
+            attributes.padding = padding;
+            return AddNode(OpType::MAXPOOL, {x}, attributes, name);
+        }
+
+        ValueId AvgPool(ValueId x, const TensorIndexDynamic &kernel, const TensorIndexDynamic &strides = {},
+                        const TensorIndexDynamic &padding = {}, const std::string &name = "") {
+            NodeAttributes attributes;
+            attributes.kernel = kernel;
+            attributes.strides = strides;
+            attributes.padding = padding;
+            return AddNode(OpType::AVGPOOL, {x}, attributes, name);
+        }
+
+        /**
+         * @brief Adds a copy of x stored in another memory layout (e.g. NCHW -> nChw8c and back).
+         * @param layout The layout of the result.
+         * **/
+        ValueId Reorder(ValueId x, MemoryLayout layout, const std::string &name = "") {
+            const ValueId output = AddNode(OpType::REORDER, {x}, {}, name);
+            values_[output].layout = layout;
+            return output;
+        }
+
+        /**
+         * @brief Marks a value as a graph output.
+         * @param value The value.
+         * @throws std::out_of_range if the value does not exist.
+         * **/
+        void MarkOutput(ValueId value) {
+            CheckValue(value);
+            if (!values_[value].isOutput) {
+                values_[value].isOutput = true;
+                outputs_.push_back(value);
+            }
+        }
+
+        // Rewriting
+
+        /**
+         * @brief Redirects every use of a value (node inputs and graph outputs) to another value.
+         * @param from The value to replace.
+         * @param to The replacement.
+         * @throws std::out_of_range if a value does not exist.
+         * **/
+        void ReplaceAllUses(ValueId from, ValueId to) {
+            CheckValue(from);
+            CheckValue(to);
+            if (from == to) return;
+            for (NodeId consumer : values_[from].consumers) {
+                for (ValueId &input : nodes_[consumer].inputs) {
+                    if (input == from) input = to;
+                }
+                values_[to].consumers.push_back(consumer);
+            }
+            values_[from].consumers.clear();
+            if (values_[from].isOutput) {
+                values_[from].isOutput = false;
+                for (ValueId &output : outputs_) {
+                    if (output == from) output = to;
+                }
+                if (values_[to].isOutput) {
+                    // Both were outputs: keep one entry per value
+                    for (size_t i = outputs_.size(); i-- > 0;) {
+                        if (outputs_[i] == to) { outputs_.erase(outputs_.begin() + static_cast<std::ptrdiff_t>(i)); break; }
+                    }
+                }
+                values_[to].isOutput = true;
+            }
+        }
+
+        /**
+         * @brief Makes another value the graph output in place of one (its position in the outputs is kept).
+         * Unlike ReplaceAllUses, the nodes reading the previous output keep reading it.
+         * @param from The current output.
+         * @param to The replacement.
+         * @throws std::out_of_range if a value does not exist.
+         * @throws std::invalid_argument if from is not a graph output or to already is one.
+         * **/
+        void ReplaceOutput(ValueId from, ValueId to) {
+            CheckValue(from);
+            CheckValue(to);
+            if (!values_[from].isOutput || values_[to].isOutput) {
+                throw std::invalid_argument("ReplaceOutput requires an output and a value that is not one.");
+            }
+            for (ValueId &output : outputs_) {
+                if (output == from) output = to;
+            }
+            values_[from].isOutput = false;
+            values_[to].isOutput = true;
+        }
+
+        /**
+         * @brief Replaces one input of a node.
+         * @param node The node.
+         * @param index The input position.
+         * @param value The new input value.
+         * @throws std::out_of_range if the node, position or value does not exist.
+         * **/
+        void SetNodeInput(NodeId node, size_t index, ValueId value) {
+            CheckNode(node);
+            CheckValue(value);
+            std::vector<ValueId> &inputs = nodes_[node].inputs;
+            if (index >= inputs.size()) {
+                throw std::out_of_range("Node input index out of range.");
+            }
+            RemoveConsumer(inputs[index], node);
+            inputs[index] = value;
+            values_[value].consumers.push_back(node);
+        }
+
+        /**
+         * @brief Appends an input to a node (used by rewrites that merge nodes).
+         * @param node The node.
+         * @param value The new input value.
+         * @throws std::out_of_range if the node or value does not exist.
+         * **/
+        void AppendNodeInput(NodeId node, ValueId value) {
+            CheckNode(node);
+            CheckValue(value);
+            nodes_[node].inputs.push_back(value);
+            values_[value].consumers.push_back(node);
+        }
+
+        /**
+         * @brief Makes a node write another value (used by rewrites that merge a node into its producer).
+         * The previous output loses its producer.
+         * @param node The node.
+         * @param index The output position.
+         * @param value The new output value (must not have a producer).
+         * @throws std::out_of_range if the node, position or value does not exist.
+         * @throws std::invalid_argument if the value already has a producer.
+         * **/
+        void SetNodeOutput(NodeId node, size_t index, ValueId value) {
+            CheckNode(node);
+            CheckValue(value);
+            std::vector<ValueId> &outputs = nodes_[node].outputs;
+            if (index >= outputs.size()) {
+                throw std::out_of_range("Node output index out of range.");
+            }
+            if (values_[value].producer != InvalidId && values_[value].producer != node) {
+                throw std::invalid_argument("A value can have only one producer.");
+            }
+            values_[outputs[index]].producer = InvalidId;
+            outputs[index] = value;
+            values_[value].producer = node;
+        }
+
+        /**
+         * @brief Removes a node: it is detached from its inputs and marked erased; its outputs lose their producer.
+         * @param node The node.
+         * @throws std::out_of_range if the node does not exist.
+         * **/
+        void EraseNode(NodeId node) {
+            CheckNode(node);
+            Node &target = nodes_[node];
+            if (target.erased) return;
+            for (ValueId input : target.inputs) RemoveConsumer(input, node);
+            for (ValueId output : target.outputs) {
+                if (values_[output].producer == node) values_[output].producer = InvalidId;
+            }
+            target.erased = true;
+        }
+
+        /**
+         * @brief Removes the nodes whose outputs are neither graph outputs nor used by a live node.
+         * @return The number of nodes removed.
+         * **/
+        size_t EliminateDeadNodes() {
+            size_t removed = 0;
+            const std::vector<NodeId> order = TopologicalOrder();
+            for (size_t i = order.size(); i-- > 0;) {
+                const Node &node = nodes_[order[i]];
+                bool used = false;
+                for (ValueId output : node.outputs) {
+                    used = used || values_[output].isOutput || !values_[output].consumers.empty();
+                }
+                if (!used) {
+                    EraseNode(order[i]);
+                    ++removed;
+                }
+            }
+            return removed;
+        }
+
+        // Traversal
+
+        /**
+         * @brief Orders the live nodes so every node comes after the producers of its inputs (Kahn's algorithm).
+         * Ties are broken by insertion order, so the order is deterministic.
+         * @return The node ids in topological order.
+         * @throws std::invalid_argument if the graph contains a cycle.
+         * **/
+        [[nodiscard]] std::vector<NodeId> TopologicalOrder() const {
+            std::vector<size_t> pending(nodes_.size(), 0);
+            std::vector<NodeId> order;
+            size_t live = 0;
+            for (NodeId id = 0; id < nodes_.size(); ++id) {
+                if (nodes_[id].erased) continue;
+                ++live;
+                for (ValueId input : nodes_[id].inputs) {
+                    if (values_[input].producer != InvalidId) ++pending[id];
+                }
+                if (pending[id] == 0) order.push_back(id);
+            }
+            order.reserve(live);
+            for (size_t next = 0; next < order.size(); ++next) {
+                for (ValueId output : nodes_[order[next]].outputs) {
+                    for (NodeId consumer : values_[output].consumers) {
+                        if (--pending[consumer] == 0) order.push_back(consumer);
+                    }
+                }
+            }
+            if (order.size() != live) {
+                throw std::invalid_argument("Graph contains a cycle.");
+            }
+            return order;
+        }
+
+        // Accessors
+
+        [[nodiscard]] const Node &GetNode(NodeId id) const { CheckNode(id); return nodes_[id]; }
+        [[nodiscard]] Node &GetNode(NodeId id) { CheckNode(id); return nodes_[id]; }
+        [[nodiscard]] const Value &GetValue(ValueId id) const { CheckValue(id); return values_[id]; }
+        [[nodiscard]] Value &GetValue(ValueId id) { CheckValue(id); return values_[id]; }
+
+        /**
+         * @brief Gets the number of node slots (erased nodes included); valid ids are [0, GetNumNodes()).
+         * **/
+        [[nodiscard]] size_t GetNumNodes() const noexcept { return nodes_.size(); }
+
+        /**
+         * @brief Gets the number of value slots; valid ids are [0, GetNumValues()).
+         * **/
+        [[nodiscard]] size_t GetNumValues() const noexcept { return values_.size(); }
+
+        [[nodiscard]] const std::vector<ValueId> &GetInputs() const noexcept { return inputs_; }
+        [[nodiscard]] const std::vector<ValueId> &GetOutputs() const noexcept { return outputs_; }
+
+    private:
+        ValueId NewValue(const std::string &name, ValueKind kind, DataType dtype) {
+            values_.emplace_back();
+            Value &value = values_.back();
+            value.name = name;
+            value.kind = kind;
+            value.dtype = dtype;
+            return values_.size() - 1;
+        }
+
+        void RemoveConsumer(ValueId value, NodeId node) {
+            std::vector<NodeId> &consumers = values_[value].consumers;
+            for (size_t i = 0; i < consumers.size(); ++i) {
+                if (consumers[i] == node) {
+                    consumers.erase(consumers.begin() + static_cast<std::ptrdiff_t>(i));
+                    return;
+                }
+            }
+        }
+
+        void CheckValue(ValueId id) const {
+            if (id >= values_.size()) throw std::out_of_range("Graph value id out of range.");
+        }
+
+        void CheckNode(NodeId id) const {
+            if (id >= nodes_.size()) throw std::out_of_range("Graph node id out of range.");
+        }
+
+        std::vector<Node> nodes_;     // Every node ever added (erased ones included)
+        std::vector<Value> values_;   // Every value ever added
+        std::vector<ValueId> inputs_;  // Graph inputs, in binding order
+        std::vector<ValueId> outputs_; // Graph outputs, in result order
+    };
+}
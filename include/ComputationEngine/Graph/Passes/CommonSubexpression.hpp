@@ -0,0 +1,148 @@
+#pragma once
+
+#include "../Graph.hpp"
+#include <cstdint> // uint64_t
+#include <cstring> // std::memcmp
+#include <map>     // std::map
+#include <vector>  // std::vector
+
+namespace NextGraph
+{
+    namespace Detail
+    {
+        inline bool SameEpilogue(const std::vector<EpilogueStep> &lhs, const std::vector<EpilogueStep> &rhs) {
+            if (lhs.size() != rhs.size()) return false;
+            for (size_t i = 0; i < lhs.size(); ++i) {
+                if (lhs[i].op != rhs[i].op || lhs[i].operand != rhs[i].operand || lhs[i].operandOnLeft != rhs[i].operandOnLeft) return false;
+            }
+            return true;
+        }
+
+        // Constants up to this many bytes are also merged when their contents are equal
+        constexpr size_t MaxComparedConstantBytes = 64 * 1024;
+
+        // Element type, layout, shape and strides (the offset is compared by the caller when the storage is shared)
+        inline bool SameConstantView(const Value &lhs, const Value &rhs) {
+            return lhs.dtype == rhs.dtype && lhs.layout == rhs.layout && lhs.metadata->GetShape() == rhs.metadata->GetShape() &&
+                   lhs.metadata->GetStrides() == rhs.metadata->GetStrides();
+        }
+
+        // The bytes spanned by a constant's view, starting at its first element
+        inline const unsigned char *ConstantBytes(const Value &value, size_t &bytes) {
+            const size_t elementSize = NextTypes::GetDataTypeSize(value.dtype);
+            bytes = value.metadata->GetStorageSize() * elementSize;
+            return static_cast<const unsigned char *>(value.data->GetData()) + value.metadata->GetOffset() * elementSize;
+        }
+
+        // FNV-1a hash of a small constant's contents (buckets the content comparison)
+        inline uint64_t HashConstant(const Value &value) {
+            size_t bytes = 0;
+            const unsigned char *data = ConstantBytes(value, bytes);
+            uint64_t hash = 14695981039346656037ull;
+            for (size_t i = 0; i < bytes; ++i) hash = (hash ^ data[i]) * 1099511628211ull;
+            return hash;
+        }
+
+        inline bool SameConstantContents(const Value &lhs, const Value &rhs) {
+            size_t lhsBytes = 0, rhsBytes = 0;
+            const unsigned char *lhsData = ConstantBytes(lhs, lhsBytes), *rhsData = ConstantBytes(rhs, rhsBytes);
+            return lhsBytes == rhsBytes && std::memcmp(lhsData, rhsData, lhsBytes) == 0;
+        }
+
+        // Layouts are not attributes: REORDER, for one, stores its target layout only on its output value
+        inline bool SameLayouts(const Graph &graph, const std::vector<ValueId> &lhs, const std::vector<ValueId> &rhs) {
+            for (size_t i = 0; i < lhs.size(); ++i) {
+                if (graph.GetValue(lhs[i]).layout != graph.GetValue(rhs[i]).layout) return false;
+            }
+            return true;
+        }
+
+        // Merging two graph outputs would drop an entry of the output list
+        inline bool BothOutputs(const Graph &graph, const std::vector<ValueId> &lhs, const std::vector<ValueId> &rhs) {
+            for (size_t i = 0; i < lhs.size(); ++i) {
+                if (graph.GetValue(lhs[i]).isOutput && graph.GetValue(rhs[i]).isOutput) return true;
+            }
+            return false;
+        }
+    }
+
+    /**
+     * @brief Common-subexpression elimination pass: merges nodes that compute the same thing.
+     *
+     * Two nodes are identical when they have the same operation, the same inputs in the same order, equal
+     * attributes, the same epilogue and outputs in the same layouts (two REORDERs of one value to different
+     * layouts differ only there). Constants are merged too when they share the same storage, metadata and
+     * data type (e.g. a weight added twice), or when they span at most MaxComparedConstantBytes and hold the same
+     * bytes with the same data type, layout, shape and strides. The latter lets the pass run after FoldConstants,
+     * which gives every folded result a buffer of its own: identical folded constants (and then their readers) merge.
+     * Nodes are visited in topological order, so once the inputs of two
+     * nodes have been merged the nodes themselves merge, and whole duplicated subgraphs collapse.
+     * Every use of a duplicate (graph outputs included) is redirected to the kept value and the duplicate is erased;
+     * nodes whose results are both graph outputs are kept apart so the output list keeps its length and order.
+     * @param graph The graph (rewritten in place).
+     * @return The number of nodes and constants removed.
+     * **/
+    inline size_t EliminateCommonSubexpressions(Graph &graph) {
+        size_t removed = 0;
+
+        // Constants aliasing the same data, or small constants holding the same bytes
+        std::map<const void *, std::vector<ValueId>> constants;
+        std::map<uint64_t, std::vector<ValueId>> contents;
+        for (ValueId id = 0; id < graph.GetNumValues(); ++id) {
+            const Value &value = graph.GetValue(id);
+            if (value.kind != ValueKind::CONSTANT || !value.data || !value.metadata) continue;
+            if (value.consumers.empty() && !value.isOutput) continue;
+            std::vector<ValueId> &aliases = constants[value.data->GetData()];
+            ValueId match = InvalidId;
+            for (ValueId candidate : aliases) {
+                const Value &other = graph.GetValue(candidate);
+                if (Detail::SameConstantView(other, value) && other.metadata->GetOffset() == value.metadata->GetOffset() &&
+                    !(value.isOutput && other.isOutput)) {
+                    match = candidate;
+                    break;
+                }
+            }
+            const bool compared = value.metadata->GetStorageSize() * NextTypes::GetDataTypeSize(value.dtype) <= Detail::MaxComparedConstantBytes;
+            std::vector<ValueId> *equals = compared ? &contents[Detail::HashConstant(value)] : nullptr;
+            for (size_t i = 0; match == InvalidId && equals && i < equals->size(); ++i) {
+                const Value &other = graph.GetValue((*equals)[i]);
+                if (Detail::SameConstantView(other, value) && Detail::SameConstantContents(other, value) && !(value.isOutput && other.isOutput)) {
+                    match = (*equals)[i];
+                }
+            }
+            if (match == InvalidId) {
+                aliases.push_back(id);
+                if (equals) equals->push_back(id);
+            } else {
+                graph.ReplaceAllUses(id, match);
+                ++removed;
+            }
+        }
+
+        // Nodes: buckets by (operation, inputs), then compare attributes and epilogues
+        std::map<std::pair<OpType, std::vector<ValueId>>, std::vector<NodeId>> seen;
+        for (NodeId id : graph.TopologicalOrder()) {
+            const Node &node = graph.GetNode(id);
+            std::vector<NodeId> &candidates = seen[{node.op, node.inputs}];
+            NodeId match = InvalidId;
+            for (NodeId candidate : candidates) {
+                const Node &other = graph.GetNode(candidate);
+                if (other.attributes == node.attributes && Detail::SameEpilogue(other.epilogue, node.epilogue) &&
+                    other.outputs.size() == node.outputs.size() && Detail::SameLayouts(graph, other.outputs, node.outputs) &&
+                    !Detail::BothOutputs(graph, other.outputs, node.outputs)) {
+                    match = candidate;
+                    break;
+                }
+            }
+            if (match == InvalidId) {
+                candidates.push_back(id);
+                continue;
+            }
+            const std::vector<ValueId> outputs = node.outputs;
+            for (size_t i = 0; i < outputs.size(); ++i) graph.ReplaceAllUses(outputs[i], graph.GetNode(match).outputs[i]);
+            graph.EraseNode(id);
+            ++removed;
+        }
+        return removed;
+    }
+}
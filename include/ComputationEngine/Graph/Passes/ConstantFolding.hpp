@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ShapeInference.hpp"
+#include "../../Execution/NodeEvaluator.hpp"
+
+namespace NextGraph
+{
+    /**
+     * @brief Constant folding pass: evaluates at build time every node whose inputs are all constants.
+     *
+     * Nodes are visited in topological order, so whole constant subgraphs fold (a folded result is a constant
+     * for its consumers). The result of a folded node becomes a CONSTANT value holding a contiguous buffer and the
+     * node is erased. This includes RESHAPE/FLATTEN/TRANSPOSE of weights: a transposed weight is stored already laid
+     * out in its transposed order instead of being re-read through a strided view on every run.
+     * Constants left without readers release their data. Nodes without a kernel (see CanEvaluate) are kept.
+     * @param graph The graph (rewritten in place; shapes are inferred first).
+     * @param context The execution context the folded nodes run on.
+     * @return The number of nodes folded.
+     * @throws std::invalid_argument if shape inference or a kernel fails.
+     * **/
+    inline size_t FoldConstants(Graph &graph, NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        InferShapes(graph);
+        size_t folded = 0;
+        for (NodeId id : graph.TopologicalOrder()) {
+            const Node &node = graph.GetNode(id);
+            if (!NextExecution::CanEvaluate(node.op)) continue;
+            bool constant = true;
+            for (ValueId input : node.inputs) constant = constant && graph.GetValue(input).kind == ValueKind::CONSTANT;
+            if (!constant) continue;
+
+            NextExecution::NodeBuffers buffers;
+            for (ValueId input : node.inputs) {
+                const Value &value = graph.GetValue(input);
+                buffers.inputs.push_back(value.data->GetData());
+                buffers.inputMetas.push_back(*value.metadata);
+            }
+            Value &result = graph.GetValue(node.outputs.front());
+            const TensorMetadata metadata(result.metadata->GetShape(), result.layout); // Dense in its layout (contiguous for views)
+            NextMemory::StoragePtr storage = NextMemory::Storage::Create(metadata.GetStorageSize() * NextTypes::GetDataTypeSize(result.dtype));
+            buffers.dtype = result.dtype;
+            buffers.out = storage->GetData();
+            buffers.outMeta = metadata;
+            NextExecution::EvaluateNode(node, buffers, context);
+
+            const std::vector<ValueId> inputs = node.inputs;
+            graph.EraseNode(id);
+            result.kind = ValueKind::CONSTANT;
+            result.metadata = metadata;
+            result.aliasOf = InvalidId;
+            result.data = std::move(storage);
+            for (ValueId input : inputs) {
+                Value &value = graph.GetValue(input);
+                if (value.consumers.empty() && !value.isOutput) value.data.reset();
+            }
+            ++folded;
+        }
+        if (folded > 0) InferShapes(graph); // Views of folded values now view contiguous constants
+        return folded;
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ShapeInference.hpp"
+
+namespace NextGraph
+{
+    namespace Detail
+    {
+        inline bool IsBinaryElementwiseOp(OpType op) noexcept {
+            return op == OpType::ADD || op == OpType::SUB || op == OpType::MUL || op == OpType::DIV;
+        }
+
+        inline bool IsElementwiseOp(OpType op) noexcept {
+            return IsBinaryElementwiseOp(op) || op == OpType::RELU || op == OpType::SIGMOID || op == OpType::TANH;
+        }
+
+        // Operations that can run an epilogue on their result
+        inline bool IsFusionHead(OpType op) noexcept {
+            return IsElementwiseOp(op) || op == OpType::MATMUL || op == OpType::CONV2D;
+        }
+    }
+
+    /**
+     * @brief Elementwise fusion pass: folds chains of elementwise nodes into the node that produces their input.
+     *
+     * A node whose result feeds exactly one elementwise consumer (ADD, SUB, MUL, DIV, RELU, SIGMOID, TANH) absorbs
+     * it as an epilogue step: the consumer is erased, its other operand (if any) is appended to the inputs of the
+     * head and the head now writes the consumer's output. This repeats down the chain, so ADD -> RELU or
+     * MUL -> ADD -> SIGMOID become one node that reads its inputs once and writes its output once, and a
+     * MATMUL/CONV2D followed by a bias ADD and an activation applies both while each output block is in cache.
+     *
+     * A chain stops at a value that is a graph output or has several readers (it must be materialized), at a
+     * binary operand that does not broadcast into the result shape (the result would grow) and at non-float values.
+     * @param graph The graph (rewritten in place; shapes are inferred before and after).
+     * @return The number of nodes fused away.
+     * @throws std::invalid_argument if shape inference fails.
+     * **/
+    inline size_t FuseElementwise(Graph &graph) {
+        InferShapes(graph);
+        size_t fused = 0;
+        for (NodeId id : graph.TopologicalOrder()) {
+            if (graph.GetNode(id).erased || !Detail::IsFusionHead(graph.GetNode(id).op)) continue;
+            while (true) {
+                Node &head = graph.GetNode(id);
+                const ValueId result = head.outputs.front();
+                const Value &value = graph.GetValue(result);
+                if (!Detail::IsFloatType(value.dtype) || value.isOutput || value.consumers.size() != 1) break;
+                const NodeId consumerId = value.consumers.front();
+                const Node &consumer = graph.GetNode(consumerId);
+                if (!Detail::IsElementwiseOp(consumer.op) || !consumer.epilogue.empty()) break;
+
+                EpilogueStep step;
+                step.op = consumer.op;
+                ValueId operand = InvalidId;
+                if (Detail::IsBinaryElementwiseOp(consumer.op)) {
+                    step.operandOnLeft = consumer.inputs[1] == result;
+                    operand = consumer.inputs[step.operandOnLeft ? 0 : 1];
+                    const Value &other = graph.GetValue(operand);
+                    const TensorShapeDynamic &shape = value.metadata->GetShape();
+                    if (other.dtype != value.dtype || NextShapeUtils::NextBroadcastShape(shape, other.metadata->GetShape()) != shape) break;
+                    step.operand = head.inputs.size();
+                }
+
+                const ValueId fusedResult = consumer.outputs.front();
+                const TensorMetadata metadata = *value.metadata;
+                graph.EraseNode(consumerId);
+                if (operand != InvalidId) graph.AppendNodeInput(id, operand);
+                graph.GetNode(id).epilogue.push_back(step);
+                graph.SetNodeOutput(id, 0, fusedResult);
+                graph.GetValue(fusedResult).metadata = metadata;
+                ++fused;
+            }
+        }
+        if (fused > 0) InferShapes(graph);
+        return fused;
+    }
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "ShapeInference.hpp"
+#include "../../Kernels/Simd.hpp"
+#include <map>     // std::map
+#include <numeric> // std::iota
+#include <set>     // std::set
+#include <utility> // std::pair
+#include <vector>  // std::vector
+
+namespace NextGraph
+{
+    /**
+     * @brief Result of layout assignment.
+     * **/
+    struct LayoutPlan {
+        size_t blockedNodes = 0; // Nodes whose output is channel-blocked
+        size_t reorders = 0;     // REORDER nodes inserted
+    };
+
+    namespace Detail
+    {
+        /**
+         * @brief Blocked layout matching the vector width for a data type: 16 floats fill an AVX-512 register,
+         * 8 lanes fill an AVX2 float register or an AVX-512 double register (and two SSE registers).
+         * **/
+        inline MemoryLayout GetPreferredBlockedLayout(DataType dtype) noexcept {
+            const bool wide = NextKernels::GetIsaLevel() == NextKernels::IsaLevel::AVX512;
+            return dtype == DataType::FLOAT32 && wide ? MemoryLayout::NCHW16C : MemoryLayout::NCHW8C;
+        }
+
+        // Nodes whose kernels gain from a blocked layout: pooling and depthwise convolution read whole channel blocks
+        inline bool IsLayoutAnchor(const Graph &graph, const Node &node) {
+            const TensorMetadata &input = *graph.GetValue(node.inputs.front()).metadata;
+            if (node.op == OpType::MAXPOOL || node.op == OpType::AVGPOOL) return true;
+            return node.op == OpType::CONV2D && node.attributes.groups == input.GetShape()[1] &&
+                   graph.GetValue(node.outputs.front()).metadata->GetShape()[1] == input.GetShape()[1];
+        }
+
+        // Whether input slot of a node reads an activation (the operand that follows the node output layout)
+        inline bool IsActivationSlot(const Node &node, size_t slot) {
+            const bool windowed = node.op == OpType::MAXPOOL || node.op == OpType::AVGPOOL || node.op == OpType::CONV2D;
+            return !windowed || slot == 0 || slot >= GetNumHeadInputs(node);
+        }
+
+        /**
+         * @brief Checks whether a node has a blocked kernel for its operands (see CheckLayouts): a float anchor, or
+         * a float elementwise node whose activations all have its output shape.
+         * **/
+        inline bool IsBlockedCandidate(const Graph &graph, const Node &node) {
+            if (node.op == OpType::REORDER || !SupportsBlockedLayout(node.op)) return false;
+            const Value &output = graph.GetValue(node.outputs.front());
+            if (!output.metadata || !IsFloatType(output.dtype) || output.aliasOf != InvalidId) return false;
+            const TensorShapeDynamic &shape = output.metadata->GetShape();
+            const bool windowed = node.op == OpType::MAXPOOL || node.op == OpType::AVGPOOL || node.op == OpType::CONV2D;
+            if (windowed && !IsLayoutAnchor(graph, node)) return false;
+            for (size_t slot = windowed ? GetNumHeadInputs(node) : 0; slot < node.inputs.size(); ++slot) {
+                if (graph.GetValue(node.inputs[slot]).metadata->GetShape() != shape) return false;
+            }
+            return true;
+        }
+
+        inline size_t FindComponent(std::vector<size_t> &parent, size_t node) {
+            while (parent[node] != node) node = parent[node] = parent[parent[node]];
+            return node;
+        }
+    }
+
+    /**
+     * @brief Layout assignment pass: stores the activations around pooling and depthwise convolutions in a
+     * channel-blocked layout (see NextTypes::MemoryLayout) and inserts the REORDER nodes the choice requires.
+     *
+     * In nChw8c/nChw16c the channels of one pixel fill a vector register, so pooling and depthwise convolution run
+     * at full vector width along the channels with unit-stride loads. Nodes that have blocked kernels (pooling,
+     * depthwise CONV2D, and float elementwise nodes whose operands all have the output shape) are grouped into
+     * connected regions. A region is blocked when it holds at least as many pooling/convolution nodes as the
+     * REORDERs it needs at its boundary (activations entering from ROW_MAJOR producers or graph inputs, results read
+     * by ROW_MAJOR nodes or returned as graph outputs); reorders of constants are not counted, since FoldConstants
+     * performs them once. Weights and bias stay ROW_MAJOR and graph outputs are always returned ROW_MAJOR.
+     * Every value is reordered at most once per target layout, whatever its number of readers.
+     *
+     * Run it before FuseElementwise (fused chains then stay in their region) and before FoldConstants.
+     * @param graph The graph (rewritten in place; shapes are inferred before and after).
+     * @param layout NCHW8C or NCHW16C, or UNKNOWN to pick per data type from the vector width (see
+     * Detail::GetPreferredBlockedLayout).
+     * @return The number of blocked nodes and of REORDER nodes inserted.
+     * @throws std::invalid_argument if the layout is not blocked (or UNKNOWN), or if shape inference fails.
+     * **/
+    inline LayoutPlan AssignLayouts(Graph &graph, MemoryLayout layout = MemoryLayout::UNKNOWN) {
+        if (layout != MemoryLayout::UNKNOWN && !NextTypes::IsBlockedLayout(layout)) {
+            throw std::invalid_argument("AssignLayouts requires a channel-blocked layout.");
+        }
+        InferShapes(graph);
+        const std::vector<NodeId> order = graph.TopologicalOrder();
+
+        // Regions: candidates connected through activations
+        std::vector<bool> candidate(graph.GetNumNodes(), false);
+        std::vector<size_t> parent(graph.GetNumNodes());
+        std::iota(parent.begin(), parent.end(), size_t(0));
+        for (NodeId id : order) candidate[id] = Detail::IsBlockedCandidate(graph, graph.GetNode(id));
+        for (NodeId id : order) {
+            if (!candidate[id]) continue;
+            const Node &node = graph.GetNode(id);
+            for (size_t slot = 0; slot < node.inputs.size(); ++slot) {
+                const NodeId producer = graph.GetValue(node.inputs[slot]).producer;
+                if (producer != InvalidId && candidate[producer] && Detail::IsActivationSlot(node, slot)) {
+                    parent[Detail::FindComponent(parent, id)] = Detail::FindComponent(parent, producer);
+                }
+            }
+        }
+
+        // Cost model: pooling/convolution nodes against boundary reorders
+        std::map<size_t, size_t> anchors;
+        std::map<size_t, std::set<std::pair<ValueId, bool>>> boundary; // Per region: (value, entering) needing a REORDER
+        for (NodeId id : order) {
+            if (!candidate[id]) continue;
+            const Node &node = graph.GetNode(id);
+            const size_t region = Detail::FindComponent(parent, id);
+            if (Detail::IsLayoutAnchor(graph, node)) ++anchors[region];
+            for (size_t slot = 0; slot < node.inputs.size(); ++slot) {
+                const Value &input = graph.GetValue(node.inputs[slot]);
+                const bool inside = input.producer != InvalidId && candidate[input.producer];
+                if (Detail::IsActivationSlot(node, slot) && !inside && input.kind != ValueKind::CONSTANT) {
+                    boundary[region].insert({node.inputs[slot], true});
+                }
+            }
+            const ValueId result = node.outputs.front();
+            const Value &value = graph.GetValue(result);
+            bool leaves = value.isOutput;
+            for (NodeId consumer : value.consumers) {
+                const Node &reader = graph.GetNode(consumer);
+                if (reader.op == OpType::REORDER) continue;
+                for (size_t slot = 0; slot < reader.inputs.size(); ++slot) {
+                    if (reader.inputs[slot] == result && (!candidate[consumer] || !Detail::IsActivationSlot(reader, slot))) leaves = true;
+                }
+            }
+            if (leaves) boundary[region].insert({result, false});
+        }
+
+        LayoutPlan plan;
+        std::vector<MemoryLayout> nodeLayout(graph.GetNumNodes(), MemoryLayout::ROW_MAJOR);
+        for (NodeId id : order) {
+            const size_t region = Detail::FindComponent(parent, id);
+            if (!candidate[id] || anchors[region] == 0 || anchors[region] < boundary[region].size()) continue;
+            const Value &output = graph.GetValue(graph.GetNode(id).outputs.front());
+            nodeLayout[id] = layout == MemoryLayout::UNKNOWN ? Detail::GetPreferredBlockedLayout(output.dtype) : layout;
+            ++plan.blockedNodes;
+        }
+        for (NodeId id : order) {
+            if (graph.GetNode(id).op != OpType::REORDER) graph.GetValue(graph.GetNode(id).outputs.front()).layout = nodeLayout[id];
+        }
+
+        // Every operand in the layout its reader expects, one REORDER per (value, layout)
+        std::map<std::pair<ValueId, MemoryLayout>, ValueId> reordered;
+        auto reorder = [&](ValueId value, MemoryLayout target) {
+            const auto [it, inserted] = reordered.try_emplace({value, target}, InvalidId);
+            if (inserted) {
+                const std::string name = graph.GetValue(value).name;
+                it->second = graph.Reorder(value, target, name.empty() ? "" : name + "_reorder");
+                ++plan.reorders;
+            }
+            return it->second;
+        };
+        for (NodeId id : order) {
+            if (graph.GetNode(id).op == OpType::REORDER) continue;
+            for (size_t slot = 0; slot < graph.GetNode(id).inputs.size(); ++slot) { // Adding nodes invalidates references
+                const ValueId input = graph.GetNode(id).inputs[slot];
+                const MemoryLayout target = Detail::IsActivationSlot(graph.GetNode(id), slot) ? nodeLayout[id] : MemoryLayout::ROW_MAJOR;
+                if (graph.GetValue(input).layout == target) continue;
+                const ValueId converted = reorder(input, target);
+                graph.SetNodeInput(id, slot, converted);
+            }
+        }
+        const std::vector<ValueId> outputs = graph.GetOutputs();
+        for (ValueId output : outputs) {
+            const Value &value = graph.GetValue(output);
+            if (value.isOutput && NextTypes::IsBlockedLayout(value.layout)) {
+                const ValueId converted = reorder(output, MemoryLayout::ROW_MAJOR);
+                graph.ReplaceOutput(output, converted);
+            }
+        }
+        InferShapes(graph);
+        return plan;
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "ShapeInference.hpp"
+#include "../../../Core/Memory/Allocator.hpp"
+#include <algorithm> // std::sort, std::max
+
+namespace NextGraph
+{
+    /**
+     * @brief Result of memory planning: where every intermediate buffer lives inside one slab.
+     * **/
+    struct MemoryPlan {
+        size_t slabBytes = 0;            // Size of the slab holding every planned buffer
+        size_t unplannedBytes = 0;       // Sum of the planned buffer sizes (what one buffer per value would need)
+        std::vector<size_t> byteOffsets; // Per value id: byte offset in the slab, or InvalidId if the value is not planned
+    };
+
+    namespace Detail
+    {
+        struct PlannedBuffer {
+            ValueId value;  // Value owning the buffer
+            size_t bytes;   // Aligned size
+            size_t first;   // Step of the producing node
+            size_t last;    // Step of the last reader (of the value or any view of it)
+            size_t offset;  // Assigned byte offset
+        };
+    }
+
+    /**
+     * @brief Liveness-based memory planner: packs every intermediate buffer into a single slab.
+     *
+     * Each buffer is live from the step of its producer to the last step that reads it, directly or through a
+     * view (RESHAPE/FLATTEN/TRANSPOSE outputs alias their base and get no buffer of their own). Graph outputs
+     * stay live until the end. Offsets are assigned greedily by decreasing size: each buffer takes the smallest
+     * gap (best fit) between already placed buffers whose lifetimes overlap its own, or goes on top of them.
+     * Buffers whose lifetimes do not overlap share memory, so the slab is close to the peak live size.
+     *
+     * The planned offsets are written into the value metadata (TensorMetadata offsets are in elements, relative
+     * to the slab start) and propagated to the views. Inputs and constants are not planned.
+     * Run after InferShapes; run InferShapes again before re-planning a rewritten graph.
+     * @param graph The graph (its intermediate metadata is updated).
+     * @param alignment Byte alignment of every buffer (at least the largest element size).
+     * @return The plan: slab size and per-value byte offsets.
+     * @throws std::invalid_argument if a value has no metadata (shape inference has not run).
+     * **/
+    inline MemoryPlan PlanMemory(Graph &graph, size_t alignment = NextMemory::DefaultAlignment) {
+        const std::vector<NodeId> order = graph.TopologicalOrder();
+        const size_t endStep = order.size();
+        std::vector<size_t> stepOf(graph.GetNumNodes(), 0);
+        for (size_t step = 0; step < order.size(); ++step) stepOf[order[step]] = step;
+
+        MemoryPlan plan;
+        plan.byteOffsets.assign(graph.GetNumValues(), InvalidId);
+
+        // Buffers: values written by a node that are not views
+        std::vector<Detail::PlannedBuffer> buffers;
+        std::vector<size_t> bufferOf(graph.GetNumValues(), InvalidId);
+        for (NodeId node : order) {
+            for (ValueId id : graph.GetNode(node).outputs) {
+                const Value &value = graph.GetValue(id);
+                if (value.aliasOf != InvalidId) continue;
+                if (!value.metadata) {
+                    throw std::invalid_argument("Memory planning requires inferred shapes.");
+                }
+                const TensorMetadata &meta = *value.metadata;
+                const size_t elements = meta.GetStorageSize();
+                const size_t bytes = NextMemory::AlignUp(elements * NextTypes::GetDataTypeSize(value.dtype), alignment);
+                bufferOf[id] = buffers.size();
+                buffers.push_back(Detail::PlannedBuffer{id, bytes, stepOf[node], stepOf[node], 0});
+            }
+        }
+
+        // Lifetimes: extend every buffer to its last reader, through views
+        for (ValueId id = 0; id < graph.GetNumValues(); ++id) {
+            const Value &value = graph.GetValue(id);
+            const ValueId root = value.aliasOf == InvalidId ? id : value.aliasOf;
+            if (bufferOf[root] == InvalidId) continue;
+            Detail::PlannedBuffer &buffer = buffers[bufferOf[root]];
+            if (value.producer == InvalidId && id != root) continue; // Orphaned view left by a rewrite
+            for (NodeId consumer : value.consumers) buffer.last = std::max(buffer.last, stepOf[consumer]);
+            if (value.isOutput) buffer.last = endStep;
+        }
+
+        // Greedy by size, best fit among the overlapping buffers already placed
+        std::vector<size_t> byDecreasingSize(buffers.size());
+        for (size_t i = 0; i < buffers.size(); ++i) byDecreasingSize[i] = i;
+        std::sort(byDecreasingSize.begin(), byDecreasingSize.end(), [&](size_t lhs, size_t rhs) {
+            if (buffers[lhs].bytes != buffers[rhs].bytes) return buffers[lhs].bytes > buffers[rhs].bytes;
+            return buffers[lhs].first < buffers[rhs].first;
+        });
+
+        std::vector<const Detail::PlannedBuffer *> placed;
+        std::vector<const Detail::PlannedBuffer *> overlapping;
+        for (size_t index : byDecreasingSize) {
+            Detail::PlannedBuffer &buffer = buffers[index];
+            plan.unplannedBytes += buffer.bytes;
+
+            overlapping.clear();
+            for (const Detail::PlannedBuffer *other : placed) {
+                if (other->first <= buffer.last && buffer.first <= other->last) overlapping.push_back(other);
+            }
+            std::sort(overlapping.begin(), overlapping.end(), [](const auto *lhs, const auto *rhs) { return lhs->offset < rhs->offset; });
+
+            size_t bestOffset = InvalidId;
+            size_t bestGap = InvalidId;
+            size_t cursor = 0; // End of the occupied prefix
+            for (const Detail::PlannedBuffer *other : overlapping) {
+                if (other->offset > cursor) {
+                    const size_t gap = other->offset - cursor;
+                    if (gap >= buffer.bytes && gap < bestGap) {
+                        bestGap = gap;
+                        bestOffset = cursor;
+                    }
+                }
+                cursor = std::max(cursor, other->offset + other->bytes);
+            }
+            buffer.offset = bestOffset != InvalidId ? bestOffset : cursor;
+            plan.slabBytes = std::max(plan.slabBytes, buffer.offset + buffer.bytes);
+            placed.push_back(&buffer);
+        }
+
+        // Write the offsets into the metadata, then re-derive the views from their (now placed) inputs
+        for (const Detail::PlannedBuffer &buffer : buffers) {
+            Value &value = graph.GetValue(buffer.value);
+            value.metadata->SetOffset(buffer.offset / NextTypes::GetDataTypeSize(value.dtype));
+            plan.byteOffsets[buffer.value] = buffer.offset;
+        }
+        for (NodeId node : order) {
+            if (IsViewNode(graph, node) && graph.GetValue(graph.GetValue(graph.GetNode(node).outputs.front()).aliasOf).kind == ValueKind::INTERMEDIATE) {
+                Detail::InferNode(graph, node);
+            }
+        }
+        return plan;
+    }
+}
@@ -0,0 +1,331 @@
+#pragma once
+
+#include "../Graph.hpp"
+#include "../../../Utils/NextShapeUtils.hpp"
+#include <string> // std::string
+
+namespace NextGraph
+{
+    namespace Detail
+    {
+        inline const char *GetOpName(OpType op) noexcept {
+            switch (op) {
+                case OpType::ADD:       return "ADD";
+                case OpType::SUB:       return "SUB";
+                case OpType::MUL:       return "MUL";
+                case OpType::DIV:       return "DIV";
+                case OpType::MATMUL:    return "MATMUL";
+                case OpType::RELU:      return "RELU";
+                case OpType::SIGMOID:   return "SIGMOID";
+                case OpType::TANH:      return "TANH";
+                case OpType::SOFTMAX:   return "SOFTMAX";
+                case OpType::CONV2D:    return "CONV2D";
+                case OpType::MAXPOOL:   return "MAXPOOL";
+                case OpType::AVGPOOL:   return "AVGPOOL";
+                case OpType::FLATTEN:   return "FLATTEN";
+                case OpType::RESHAPE:   return "RESHAPE";
+                case OpType::TRANSPOSE: return "TRANSPOSE";
+                case OpType::REORDER:   return "REORDER";
+                default:                return "UNKNOWN";
+            }
+        }
+
+        inline bool IsFloatType(DataType dtype) noexcept {
+            return dtype == DataType::FLOAT32 || dtype == DataType::FLOAT64;
+        }
+
+        /**
+         * @brief Resolves a possibly negative axis against a rank.
+         * @param axis The axis (negative counts from the end).
+         * @param rank The rank.
+         * @param inclusive Whether axis == rank is allowed (FLATTEN).
+         * @throws std::invalid_argument if the axis is out of range.
+         * **/
+        inline size_t NormalizeAxis(int64_t axis, size_t rank, bool inclusive = false) {
+            const int64_t limit = static_cast<int64_t>(rank) + (inclusive ? 1 : 0);
+            const int64_t resolved = axis < 0 ? axis + static_cast<int64_t>(rank) : axis;
+            if (resolved < 0 || resolved >= limit) {
+                throw std::invalid_argument("Axis out of range.");
+            }
+            return static_cast<size_t>(resolved);
+        }
+
+        /**
+         * @brief Reads a 2-element spatial attribute (strides/padding/kernel) or returns its default.
+         * **/
+        inline std::pair<size_t, size_t> GetSpatialPair(const TensorIndexDynamic &values, size_t defaultH, size_t defaultW, const char *what) {
+            if (values.empty()) return {defaultH, defaultW};
+            if (values.size() != 2) {
+                throw std::invalid_argument(std::string(what) + " must have two elements {h, w}.");
+            }
+            return {values[0], values[1]};
+        }
+
+        /**
+         * @brief Computes one spatial output extent of a convolution or pooling window.
+         * **/
+        inline size_t GetWindowOutputSize(size_t input, size_t window, size_t stride, size_t padding) {
+            if (window == 0 || stride == 0) {
+                throw std::invalid_argument("Window and stride must be positive.");
+            }
+            if (input + 2 * padding < window) {
+                throw std::invalid_argument("Window is larger than the padded input.");
+            }
+            return (input + 2 * padding - window) / stride + 1;
+        }
+
+        // Root of the buffer a value lives in (itself unless it is a view)
+        inline ValueId GetAliasRoot(const Graph &graph, ValueId value) {
+            const ValueId base = graph.GetValue(value).aliasOf;
+            return base == InvalidId ? value : base;
+        }
+
+        /**
+         * @brief Checks whether an operation has kernels for channel-blocked operands (see AssignLayouts).
+         * Elementwise operations work lane by lane on the padded buffer; pooling and depthwise convolution see one
+         * channel block as a channels-last tensor.
+         * **/
+        inline bool SupportsBlockedLayout(OpType op) noexcept {
+            switch (op) {
+                case OpType::ADD: case OpType::SUB: case OpType::MUL: case OpType::DIV:
+                case OpType::RELU: case OpType::SIGMOID: case OpType::TANH:
+                case OpType::MAXPOOL: case OpType::AVGPOOL: case OpType::CONV2D: case OpType::REORDER:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        /**
+         * @brief Checks the memory layouts of a node whose output metadata has been inferred.
+         * Only REORDER changes layouts. A node with a blocked output reads its activations (every operand of an
+         * elementwise node, the input of a pooling or convolution) in the same layout and shape, and a blocked
+         * convolution must be depthwise with one output channel per input channel (blocks then stay independent).
+         * Epilogue operands of a blocked node have its layout and shape. Other operands (weights, bias) and every
+         * operand of a ROW_MAJOR node must not be blocked.
+         * **/
+        inline void CheckLayouts(const Graph &graph, const Node &node, const std::vector<const TensorMetadata *> &in) {
+            const Value &output = graph.GetValue(node.outputs.front());
+            if (node.op == OpType::REORDER) return;
+            if (output.layout == MemoryLayout::ROW_MAJOR) {
+                for (ValueId input : node.inputs) {
+                    const std::optional<TensorMetadata> &meta = graph.GetValue(input).metadata;
+                    if (meta && NextTypes::IsBlockedLayout(meta->GetLayout())) {
+                        throw std::invalid_argument("Operation requires ROW_MAJOR operands; insert a REORDER.");
+                    }
+                }
+                return;
+            }
+            if (!NextTypes::IsBlockedLayout(output.layout) || !SupportsBlockedLayout(node.op)) {
+                throw std::invalid_argument("Operation has no kernel for this memory layout.");
+            }
+            const bool elementwise = node.op != OpType::MAXPOOL && node.op != OpType::AVGPOOL && node.op != OpType::CONV2D;
+            for (size_t i = 0; i < in.size(); ++i) {
+                const bool activation = elementwise || i == 0;
+                if (activation && (in[i]->GetLayout() != output.layout || (elementwise && in[i]->GetShape() != output.metadata->GetShape()))) {
+                    throw std::invalid_argument("Blocked operations require activations of the same layout and shape.");
+                }
+                if (!activation && NextTypes::IsBlockedLayout(in[i]->GetLayout())) {
+                    throw std::invalid_argument("Weights and bias must be ROW_MAJOR.");
+                }
+            }
+            if (node.op == OpType::CONV2D && (node.attributes.groups != in[0]->GetShape()[1] || output.metadata->GetShape()[1] != in[0]->GetShape()[1])) {
+                throw std::invalid_argument("Blocked CONV2D requires a depthwise convolution (groups == C == O).");
+            }
+            for (const EpilogueStep &step : node.epilogue) {
+                if (step.operand == InvalidId || step.operand >= node.inputs.size()) continue;
+                const std::optional<TensorMetadata> &meta = graph.GetValue(node.inputs[step.operand]).metadata;
+                if (meta && (meta->GetLayout() != output.layout || meta->GetShape() != output.metadata->GetShape())) {
+                    throw std::invalid_argument("Blocked epilogue operands require the layout and shape of the result.");
+                }
+            }
+        }
+
+        /**
+         * @brief Infers the data type and metadata of the output of one node from its inputs.
+         * **/
+        inline void InferNode(Graph &graph, NodeId nodeId) {
+            const Node &node = graph.GetNode(nodeId);
+            const NodeAttributes &attributes = node.attributes;
+            std::vector<const TensorMetadata *> in;
+            const size_t headInputs = GetNumHeadInputs(node);
+            for (size_t i = 0; i < headInputs; ++i) {
+                const Value &value = graph.GetValue(node.inputs[i]);
+                if (!value.metadata) {
+                    throw std::invalid_argument("Input shape is unknown.");
+                }
+                in.push_back(&*value.metadata);
+            }
+            const DataType dtype = graph.GetValue(node.inputs.front()).dtype;
+            for (ValueId input : node.inputs) {
+                if (graph.GetValue(input).dtype != dtype) {
+                    throw std::invalid_argument("Inputs have different data types.");
+                }
+            }
+
+            Value &output = graph.GetValue(node.outputs.front());
+            output.dtype = dtype;
+            output.aliasOf = InvalidId;
+            const TensorShapeDynamic &shape0 = in[0]->GetShape();
+
+            switch (node.op) {
+                case OpType::ADD: case OpType::SUB: case OpType::MUL: case OpType::DIV: {
+                    if (dtype == DataType::BOOL && (node.op == OpType::SUB || node.op == OpType::DIV)) {
+                        throw std::invalid_argument("BOOL tensors support ADD and MUL only.");
+                    }
+                    output.metadata = TensorMetadata(NextShapeUtils::NextBroadcastShape(shape0, in[1]->GetShape()));
+                    break;
+                }
+                case OpType::MATMUL: {
+                    const TensorShapeDynamic &shape1 = in[1]->GetShape();
+                    if (!IsFloatType(dtype)) throw std::invalid_argument("MATMUL requires FLOAT32 or FLOAT64 inputs.");
+                    if (shape0.size() < 2 || shape1.size() < 2) throw std::invalid_argument("MATMUL requires inputs of rank >= 2.");
+                    if (shape0[shape0.size() - 1] != shape1[shape1.size() - 2]) throw std::invalid_argument("MATMUL inner dimensions do not match.");
+                    TensorShapeDynamic shape = NextShapeUtils::NextBroadcastShape(TensorShapeDynamic(shape0.begin(), shape0.end() - 2),
+                                                                                  TensorShapeDynamic(shape1.begin(), shape1.end() - 2));
+                    shape.push_back(shape0[shape0.size() - 2]);
+                    shape.push_back(shape1[shape1.size() - 1]);
+                    output.metadata = TensorMetadata(shape);
+                    break;
+                }
+                case OpType::RELU: case OpType::SIGMOID: case OpType::TANH: {
+                    if (!IsFloatType(dtype)) throw std::invalid_argument("Activations require FLOAT32 or FLOAT64 inputs.");
+                    output.metadata = TensorMetadata(shape0);
+                    break;
+                }
+                case OpType::SOFTMAX: {
+                    if (!IsFloatType(dtype)) throw std::invalid_argument("SOFTMAX requires a FLOAT32 or FLOAT64 input.");
+                    NormalizeAxis(attributes.axis, shape0.size());
+                    output.metadata = TensorMetadata(shape0);
+                    break;
+                }
+                case OpType::CONV2D: {
+                    const TensorShapeDynamic &weight = in[1]->GetShape();
+                    if (!IsFloatType(dtype)) throw std::invalid_argument("CONV2D requires FLOAT32 or FLOAT64 inputs.");
+                    if (shape0.size() != 4 || weight.size() != 4) throw std::invalid_argument("CONV2D requires an input [N, C, H, W] and a weight [O, C / groups, KH, KW].");
+                    if (attributes.groups == 0 || shape0[1] % attributes.groups != 0 || weight[0] % attributes.groups != 0) {
+                        throw std::invalid_argument("CONV2D groups must divide the input and output channels.");
+                    }
+                    if (weight[1] * attributes.groups != shape0[1]) throw std::invalid_argument("CONV2D weight channels do not match the input.");
+                    if (in.size() == 3 && (in[2]->GetRank() != 1 || in[2]->GetShape()[0] != weight[0])) {
+                        throw std::invalid_argument("CONV2D bias must have shape [O].");
+                    }
+                    const auto [sh, sw] = GetSpatialPair(attributes.strides, 1, 1, "Strides");
+                    const auto [ph, pw] = GetSpatialPair(attributes.padding, 0, 0, "Padding");
+                    output.metadata = TensorMetadata(TensorShapeDynamic{shape0[0], weight[0],
+                                                                        GetWindowOutputSize(shape0[2], weight[2], sh, ph),
+                                                                        GetWindowOutputSize(shape0[3], weight[3], sw, pw)});
+                    break;
+                }
+                case OpType::MAXPOOL: case OpType::AVGPOOL: {
+                    if (!IsFloatType(dtype)) throw std::invalid_argument("Pooling requires a FLOAT32 or FLOAT64 input.");
+                    if (shape0.size() != 4) throw std::invalid_argument("Pooling requires an input [N, C, H, W].");
+                    if (attributes.kernel.size() != 2) throw std::invalid_argument("Pooling requires a kernel {kh, kw}.");
+                    const size_t kh = attributes.kernel[0], kw = attributes.kernel[1];
+                    const auto [sh, sw] = GetSpatialPair(attributes.strides, kh, kw, "Strides");
+                    const auto [ph, pw] = GetSpatialPair(attributes.padding, 0, 0, "Padding");
+                    if (ph >= kh || pw >= kw) throw std::invalid_argument("Pooling padding must be smaller than the kernel.");
+                    output.metadata = TensorMetadata(TensorShapeDynamic{shape0[0], shape0[1],
+                                                                        GetWindowOutputSize(shape0[2], kh, sh, ph),
+                                                                        GetWindowOutputSize(shape0[3], kw, sw, pw)});
+                    break;
+                }
+                case OpType::FLATTEN: case OpType::RESHAPE: {
+                    TensorShapeDynamic shape = attributes.shape;
+                    if (node.op == OpType::FLATTEN) {
+                        const size_t axis = NormalizeAxis(attributes.axis, shape0.size(), true);
+                        TensorSize outer = 1, inner = 1;
+                        for (size_t d = 0; d < shape0.size(); ++d) (d < axis ? outer : inner) *= shape0[d];
+                        shape = TensorShapeDynamic{outer, inner};
+                    }
+                    if (NextUtils::ComputeSize(shape) != in[0]->GetTotalSize()) {
+                        throw std::invalid_argument("New shape must have the same total size as the original tensor.");
+                    }
+                    try {
+                        output.metadata = NextShapeUtils::NextReshape(*in[0], shape); // View of the input buffer
+                        output.aliasOf = GetAliasRoot(graph, node.inputs.front());
+                    } catch (const std::invalid_argument &) {
+                        output.metadata = TensorMetadata(shape); // Strided input: the node materializes a copy
+                    }
+                    break;
+                }
+                case OpType::TRANSPOSE: {
+                    output.metadata = NextShapeUtils::NextPermute(*in[0], attributes.axes);
+                    output.aliasOf = GetAliasRoot(graph, node.inputs.front());
+                    break;
+                }
+                case OpType::REORDER: {
+                    output.metadata = TensorMetadata(shape0, output.layout);
+                    break;
+                }
+                default:
+                    throw std::invalid_argument("Operation is not supported by shape inference.");
+            }
+            if (output.layout != MemoryLayout::ROW_MAJOR && node.op != OpType::REORDER) {
+                if (output.aliasOf != InvalidId) throw std::invalid_argument("View operations produce ROW_MAJOR values.");
+                output.metadata = TensorMetadata(output.metadata->GetShape(), output.layout);
+            }
+            CheckLayouts(graph, node, in);
+
+            // Fused epilogue: the result keeps its shape through every step
+            for (const EpilogueStep &step : node.epilogue) {
+                if (output.aliasOf != InvalidId) throw std::invalid_argument("View operations cannot have an epilogue.");
+                if (!IsFloatType(dtype)) throw std::invalid_argument("Epilogues require FLOAT32 or FLOAT64 values.");
+                const bool binary = step.op == OpType::ADD || step.op == OpType::SUB || step.op == OpType::MUL || step.op == OpType::DIV;
+                const bool unary = step.op == OpType::RELU || step.op == OpType::SIGMOID || step.op == OpType::TANH;
+                if (!binary && !unary) throw std::invalid_argument("Epilogue steps must be elementwise operations.");
+                if (binary != (step.operand != InvalidId)) throw std::invalid_argument("Binary epilogue steps take exactly one operand.");
+                if (unary) continue;
+                if (step.operand < headInputs || step.operand >= node.inputs.size()) {
+                    throw std::invalid_argument("Epilogue operand index out of range.");
+                }
+                const Value &operand = graph.GetValue(node.inputs[step.operand]);
+                if (!operand.metadata) throw std::invalid_argument("Input shape is unknown.");
+                const TensorShapeDynamic &shape = output.metadata->GetShape();
+                if (NextShapeUtils::NextBroadcastShape(shape, operand.metadata->GetShape()) != shape) {
+                    throw std::invalid_argument("Epilogue operand does not broadcast to the result shape.");
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Checks whether a node only reinterprets its input (its output is a view of the input buffer).
+     * Valid after InferShapes.
+     * @param graph The graph.
+     * @param node The node.
+     * @return True for RESHAPE/FLATTEN/TRANSPOSE nodes whose output aliases the input.
+     * **/
+    [[nodiscard]] inline bool IsViewNode(const Graph &graph, NodeId node) {
+        const Node &target = graph.GetNode(node);
+        return !target.outputs.empty() && graph.GetValue(target.outputs.front()).aliasOf != InvalidId;
+    }
+
+    /**
+     * @brief Shape and dtype inference pass: propagates shapes, strides and data types through every node.
+     * Run it after building the graph (and again after rewrites); every value then has its metadata, so buffers
+     * can be sized ahead of time and execution does no shape computation.
+     * - Elementwise ops broadcast (NumPy rules); MATMUL broadcasts batch dimensions; outputs are contiguous.
+     * - CONV2D/MAXPOOL/AVGPOOL compute the spatial extents from kernel, strides and padding.
+     * - RESHAPE/FLATTEN use NextReshape and TRANSPOSE uses NextPermute on the input metadata, so their outputs are
+     *   zero-copy views (Value::aliasOf names the viewed buffer). A RESHAPE of a strided input that cannot be viewed
+     *   gets a contiguous output and is executed as a copy.
+     * - Fused epilogue steps (see FuseElementwise) keep the result shape; their operands must broadcast into it.
+     * - Values are described in their Value::layout: channel-blocked values get blocked metadata, REORDER converts
+     *   between layouts and the operands of every other node are checked against its output layout.
+     * @param graph The graph.
+     * @throws std::invalid_argument naming the node and operation on any shape or data type mismatch.
+     * **/
+    inline void InferShapes(Graph &graph) {
+        for (NodeId id : graph.TopologicalOrder()) {
+            try {
+                Detail::InferNode(graph, id);
+            } catch (const std::invalid_argument &error) {
+                const Node &node = graph.GetNode(id);
+                throw std::invalid_argument("Shape inference failed at node " + std::to_string(id) +
+                                            (node.name.empty() ? "" : " '" + node.name + "'") + " (" +
+                                            Detail::GetOpName(node.op) + "): " + error.what());
+            }
+        }
+    }
+}
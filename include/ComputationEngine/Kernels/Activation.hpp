@@ -0,0 +1,262 @@
+#pragma once
+
+#include "Elementwise.hpp"
+#include "VectorMath.hpp"
+#include <algorithm> // std::min
+#include <cmath>     // std::exp, std::tanh
+
+namespace NextKernels
+{
+    /**
+     * @brief Checks whether an operation is an elementwise activation.
+     * @param op The operation.
+     * @return True for RELU, SIGMOID and TANH.
+     * **/
+    [[nodiscard]] constexpr bool IsActivationOp(OpType op) noexcept {
+        return op == OpType::RELU || op == OpType::SIGMOID || op == OpType::TANH;
+    }
+
+    /**
+     * @enum ActivationAccuracy
+     * @brief Accuracy tier of the vectorized SIGMOID and TANH kernels (RELU is exact in both).
+     * Values : PRECISE (tanh within 1.5 ulp, sigmoid within 3 ulp of the exact result),
+     *          FAST (relative error around 1e-4, cheaper polynomials and range reduction)
+     * **/
+    enum class ActivationAccuracy {
+        PRECISE,
+        FAST
+    };
+
+    namespace Detail
+    {
+        inline std::atomic<ActivationAccuracy> &ActiveActivationAccuracy() noexcept {
+            static std::atomic<ActivationAccuracy> accuracy{ActivationAccuracy::PRECISE};
+            return accuracy;
+        }
+    }
+
+    /**
+     * @brief Returns the accuracy tier activation kernels run with.
+     * @return The active ActivationAccuracy (PRECISE unless changed with SetActivationAccuracy).
+     * **/
+    [[nodiscard]] inline ActivationAccuracy GetActivationAccuracy() noexcept {
+        return Detail::ActiveActivationAccuracy().load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Selects the accuracy tier of the activation kernels, fused epilogues included.
+     * @param accuracy The tier to use from now on.
+     * **/
+    inline void SetActivationAccuracy(ActivationAccuracy accuracy) noexcept {
+        Detail::ActiveActivationAccuracy().store(accuracy, std::memory_order_relaxed);
+    }
+
+    namespace Detail
+    {
+        template <OpType Op, typename T>
+        inline T ApplyActivation(T x) noexcept {
+            if constexpr (Op == OpType::RELU) return x > T(0) ? x : T(0);
+            else if constexpr (Op == OpType::SIGMOID) return T(1) / (T(1) + std::exp(-x));
+            else return std::tanh(x);
+        }
+
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+        template <typename T, OpType Op, bool Fast, typename V>
+        NEXT_ALWAYS_INLINE void ApplyActivationVector(V &out, const V &x) noexcept {
+            if constexpr (Op == OpType::RELU) ReluVector<T>(out, x);
+            else if constexpr (Op == OpType::SIGMOID) SigmoidVector<T, Fast>(out, x);
+            else TanhVector<T, Fast>(out, x);
+        }
+#endif
+
+        /**
+         * @brief Unit-stride activation loop (out may alias in); Bytes is the vector width (0 = scalar only).
+         * The tail goes through a zero-padded vector so every element gets the same approximation, wherever
+         * a parallel split or a strided run puts it.
+         * **/
+        template <size_t Bytes, typename T, OpType Op, bool Fast>
+        NEXT_ALWAYS_INLINE void ActivationContiguousBody(T *out, const T *in, size_t n) noexcept {
+            size_t i = 0;
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+            if constexpr (Bytes >= 2 * sizeof(T)) {
+                using V = Vector<T, Bytes>;
+                constexpr size_t Lanes = Bytes / sizeof(T);
+                for (; i + Lanes <= n; i += Lanes) {
+                    V x, r;
+                    LoadVector(x, in + i);
+                    ApplyActivationVector<T, Op, Fast>(r, x);
+                    StoreVector(out + i, r);
+                }
+                if (i < n) {
+                    T tail[Lanes] = {};
+                    std::memcpy(tail, in + i, (n - i) * sizeof(T));
+                    V x, r;
+                    LoadVector(x, tail);
+                    ApplyActivationVector<T, Op, Fast>(r, x);
+                    StoreVector(tail, r);
+                    std::memcpy(out + i, tail, (n - i) * sizeof(T));
+                    i = n;
+                }
+            }
+#endif
+            for (; i < n; ++i) out[i] = ApplyActivation<Op>(in[i]);
+        }
+
+        template <typename T, OpType Op, bool Fast>
+        NEXT_TARGET_AVX512 void ActivationContiguousAvx512(T *out, const T *in, size_t n) noexcept {
+            ActivationContiguousBody<64, T, Op, Fast>(out, in, n);
+        }
+
+        template <typename T, OpType Op, bool Fast>
+        NEXT_TARGET_AVX2 void ActivationContiguousAvx2(T *out, const T *in, size_t n) noexcept {
+            ActivationContiguousBody<32, T, Op, Fast>(out, in, n);
+        }
+
+        template <typename T, OpType Op, bool Fast>
+        NEXT_TARGET_SSE2 void ActivationContiguousSse2(T *out, const T *in, size_t n) noexcept {
+            ActivationContiguousBody<16, T, Op, Fast>(out, in, n);
+        }
+
+        template <typename T, OpType Op, bool Fast>
+        void ActivationContiguousIsa(T *out, const T *in, size_t n) noexcept {
+            switch (GetIsaLevel()) {
+                case IsaLevel::AVX512: ActivationContiguousAvx512<T, Op, Fast>(out, in, n); break;
+                case IsaLevel::AVX2:   ActivationContiguousAvx2<T, Op, Fast>(out, in, n); break;
+                case IsaLevel::SSE2:   ActivationContiguousSse2<T, Op, Fast>(out, in, n); break;
+                default:               ActivationContiguousBody<0, T, Op, Fast>(out, in, n); break;
+            }
+        }
+
+        /**
+         * @brief Runs the unit-stride activation loop compiled for the active ISA level and accuracy tier.
+         * The scalar level falls back to the standard library functions.
+         * **/
+        template <typename T, OpType Op>
+        void ActivationContiguous(T *out, const T *in, size_t n) noexcept {
+            if (Op != OpType::RELU && GetActivationAccuracy() == ActivationAccuracy::FAST) {
+                ActivationContiguousIsa<T, Op, true>(out, in, n);
+            } else {
+                ActivationContiguousIsa<T, Op, false>(out, in, n);
+            }
+        }
+
+        constexpr size_t ActivationGatherSize = 256; // Elements a strided run is gathered into at a time
+
+        /**
+         * @brief Runs an activation over the linear positions [begin, end) of an (out, in) iterator.
+         * **/
+        template <typename T, OpType Op>
+        void ActivationRange(const TensorIterator<2> &iterator, T *outData, const T *inData, size_t begin, size_t end) {
+            iterator.ForEachRange(begin, end, [&](const TensorIterator<2>::Offsets &offsets, const TensorIterator<2>::Strides &strides, TensorSize count) {
+                T *o = outData + offsets[0];
+                const T *x = inData + offsets[1];
+                if (strides[0] == 1 && strides[1] == 1) {
+                    ActivationContiguous<T, Op>(o, x, count);
+                    return;
+                }
+                // Gather strided runs so they take the vector path too
+                T buffer[ActivationGatherSize];
+                for (TensorSize start = 0; start < count; start += ActivationGatherSize) {
+                    const TensorSize m = std::min<TensorSize>(ActivationGatherSize, count - start);
+                    for (TensorSize i = 0; i < m; ++i) buffer[i] = x[(start + i) * strides[1]];
+                    ActivationContiguous<T, Op>(buffer, buffer, m);
+                    for (TensorSize i = 0; i < m; ++i) o[(start + i) * strides[0]] = buffer[i];
+                }
+            });
+        }
+
+        /**
+         * @brief Calls func(std::integral_constant<OpType, op>) for an activation known only at run time.
+         * **/
+        template <typename Func>
+        decltype(auto) DispatchActivation(OpType op, Func &&func) {
+            switch (op) {
+                case OpType::RELU:    return func(std::integral_constant<OpType, OpType::RELU>{});
+                case OpType::SIGMOID: return func(std::integral_constant<OpType, OpType::SIGMOID>{});
+                case OpType::TANH:    return func(std::integral_constant<OpType, OpType::TANH>{});
+                default: throw std::invalid_argument("Operation is not an activation.");
+            }
+        }
+
+        /**
+         * @brief Applies an activation in place to a contiguous array (used by fused epilogues).
+         * **/
+        template <typename T>
+        void ActivationInPlace(OpType op, T *data, size_t n) {
+            DispatchActivation(op, [&](auto opTag) { ActivationContiguous<T, decltype(opTag)::value>(data, data, n); });
+        }
+    }
+
+    /**
+     * @brief Computes out = op(in) elementwise for RELU, SIGMOID or TANH.
+     * SIGMOID and TANH use vectorized approximations with the accuracy tier set by SetActivationAccuracy.
+     * @param op The activation.
+     * @param dtype The data type of both tensors (FLOAT32 or FLOAT64).
+     * @param out Start of the output buffer.
+     * @param outMeta Metadata of the output.
+     * @param in Start of the input buffer.
+     * @param inMeta Metadata of the input.
+     * @param context The execution context large tensors are split over.
+     * @throws std::invalid_argument if the operation is not an activation, the shapes differ, the data type is not
+     * floating point or a tensor is channel-blocked (see Reorder).
+     * **/
+    inline void ElementwiseUnary(OpType op, DataType dtype, void *out, const TensorMetadata &outMeta, const void *in, const TensorMetadata &inMeta,
+                                 NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        if (!IsActivationOp(op)) {
+            throw std::invalid_argument("ElementwiseUnary supports RELU, SIGMOID and TANH only.");
+        }
+        NextMetadata::CheckStridedLayout(outMeta, "ElementwiseUnary");
+        NextMetadata::CheckStridedLayout(inMeta, "ElementwiseUnary");
+        if (outMeta.GetShape() != inMeta.GetShape()) {
+            throw std::invalid_argument("Activation output shape must match the input.");
+        }
+        DispatchFloatType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            T *outData = static_cast<T *>(out);
+            const T *inData = static_cast<const T *>(in);
+            const TensorSize n = outMeta.GetTotalSize();
+            Detail::DispatchActivation(op, [&](auto opTag) {
+                constexpr OpType Op = decltype(opTag)::value;
+                if (outMeta.IsContiguous() && inMeta.IsContiguous()) {
+                    T *o = outData + outMeta.GetOffset();
+                    const T *x = inData + inMeta.GetOffset();
+                    context.ParallelFor(0, n, Detail::ElementwiseGrain, [&](size_t begin, size_t end) {
+                        Detail::ActivationContiguous<T, Op>(o + begin, x + begin, end - begin);
+                    });
+                    return;
+                }
+                const TensorIterator<2> iterator(outMeta, inMeta);
+                context.ParallelFor(0, n, Detail::ElementwiseGrain, [&](size_t begin, size_t end) {
+                    Detail::ActivationRange<T, Op>(iterator, outData, inData, begin, end);
+                });
+            });
+        });
+    }
+
+    /**
+     * @brief Computes out = op(in) elementwise on tensors. See the raw-pointer overload.
+     * @throws std::invalid_argument if the data types differ, or see the raw-pointer overload.
+     * **/
+    inline void ElementwiseUnary(OpType op, const TensorInterface &in, TensorInterface &out,
+                                 NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        if (in.GetDataType() != out.GetDataType()) {
+            throw std::invalid_argument("Activation input must have the same data type as the output.");
+        }
+        ElementwiseUnary(op, out.GetDataType(), out.GetRawData(), out.GetMetadata(), in.GetRawData(), in.GetMetadata(), context);
+    }
+
+    /**
+     * @brief out = max(in, 0). See ElementwiseUnary.
+     * **/
+    inline void Relu(const TensorInterface &in, TensorInterface &out) { ElementwiseUnary(OpType::RELU, in, out); }
+
+    /**
+     * @brief out = 1 / (1 + exp(-in)). See ElementwiseUnary.
+     * **/
+    inline void Sigmoid(const TensorInterface &in, TensorInterface &out) { ElementwiseUnary(OpType::SIGMOID, in, out); }
+
+    /**
+     * @brief out = tanh(in). See ElementwiseUnary.
+     * **/
+    inline void Tanh(const TensorInterface &in, TensorInterface &out) { ElementwiseUnary(OpType::TANH, in, out); }
+}
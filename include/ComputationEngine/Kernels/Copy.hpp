@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Dispatch.hpp"
+#include "Elementwise.hpp"
+#include "Transpose.hpp"
+#include "../../Core/TensorInterface.hpp"
+#include "../../Core/TensorIterator.hpp"
+#include "../Execution/Context.hpp"
+#include <cstring> // std::memcpy
+
+namespace NextKernels
+{
+    /**
+     * @brief Copies the elements of one strided tensor into another of the same shape and data type.
+     * Used to materialize views (e.g. a RESHAPE of a non-contiguous tensor, a TRANSPOSE) and to pack constants.
+     * Unit-stride runs are copied with memcpy; when the unit-stride dimensions of the two tensors differ (a permuted
+     * view) the copy runs as tiled register transposes (see Transpose.hpp); other runs are copied element by element.
+     * @param dtype The data type of both tensors.
+     * @param out Start of the output buffer.
+     * @param outMeta Metadata of the output.
+     * @param in Start of the input buffer.
+     * @param inMeta Metadata of the input.
+     * @param context The execution context large tensors are split over.
+     * @throws std::invalid_argument if the shapes differ, the data type is unknown or a tensor is channel-blocked (see Reorder).
+     * **/
+    inline void Copy(DataType dtype, void *out, const TensorMetadata &outMeta, const void *in, const TensorMetadata &inMeta,
+                     NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        if (outMeta.GetShape() != inMeta.GetShape()) {
+            throw std::invalid_argument("Copy requires tensors of the same shape.");
+        }
+        NextMetadata::CheckStridedLayout(outMeta, "Copy");
+        NextMetadata::CheckStridedLayout(inMeta, "Copy");
+        DispatchDataType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            T *outData = static_cast<T *>(out);
+            const T *inData = static_cast<const T *>(in);
+            if (outMeta.IsContiguous() && inMeta.IsContiguous()) {
+                T *o = outData + outMeta.GetOffset();
+                const T *x = inData + inMeta.GetOffset();
+                context.ParallelFor(0, outMeta.GetTotalSize(), Detail::ElementwiseGrain, [&](size_t begin, size_t end) {
+                    std::memcpy(o + begin, x + begin, (end - begin) * sizeof(T));
+                });
+                return;
+            }
+            const TensorIterator<2> iterator(outMeta, inMeta);
+            if (Detail::TransposeCopy(iterator, outData + outMeta.GetOffset(), inData + inMeta.GetOffset(), context)) return;
+            context.ParallelFor(0, iterator.GetTotalSize(), Detail::ElementwiseGrain, [&](size_t begin, size_t end) {
+                iterator.ForEachRange(begin, end, [&](const TensorIterator<2>::Offsets &offsets, const TensorIterator<2>::Strides &strides, TensorSize count) {
+                    T *o = outData + offsets[0];
+                    const T *x = inData + offsets[1];
+                    if (strides[0] == 1 && strides[1] == 1) {
+                        std::memcpy(o, x, count * sizeof(T));
+                    } else {
+                        for (TensorSize i = 0; i < count; ++i) o[i * strides[0]] = x[i * strides[1]];
+                    }
+                });
+            });
+        });
+    }
+
+    /**
+     * @brief Materializes a strided tensor (e.g. a permuted view) into a contiguous row-major buffer. See Copy.
+     * @param dtype The data type of the tensor.
+     * @param out Start of a buffer of at least inMeta.GetTotalSize() elements.
+     * @param in Start of the input buffer.
+     * @param inMeta Metadata of the input.
+     * @param context The execution context large tensors are split over.
+     * @throws std::invalid_argument if the data type is unknown.
+     * **/
+    inline void MakeContiguous(DataType dtype, void *out, const void *in, const TensorMetadata &inMeta,
+                               NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        Copy(dtype, out, TensorMetadata(inMeta.GetShape()), in, inMeta, context);
+    }
+
+    /**
+     * @brief Copies a tensor into another of the same shape and data type. See the raw-pointer overload.
+     * @throws std::invalid_argument if the data types differ, or see the raw-pointer overload.
+     * **/
+    inline void Copy(const TensorInterface &in, TensorInterface &out,
+                     NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        if (in.GetDataType() != out.GetDataType()) {
+            throw std::invalid_argument("Copy requires tensors of the same data type.");
+        }
+        Copy(out.GetDataType(), out.GetRawData(), out.GetMetadata(), in.GetRawData(), in.GetMetadata(), context);
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../../Utils/NextTypes/NextDataType.hpp"
+#include <cstdint>   // fixed-width integer types
+#include <stdexcept> // std::invalid_argument
+
+namespace NextKernels
+{
+    /**
+     * @brief Carries an element type through a generic lambda.
+     * **/
+    template <typename T>
+    struct TypeTag {
+        using type = T;
+    };
+
+    /**
+     * @brief Calls a functor with the TypeTag of the C++ element type that stores a DataType.
+     * BOOL is stored as bool (one byte, 0 or 1).
+     * @param dtype The runtime data type.
+     * @param func Callable as func(TypeTag<T>{}).
+     * @return Whatever func returns.
+     * @throws std::invalid_argument if the data type is UNKNOWN.
+     * **/
+    template <typename Func>
+    decltype(auto) DispatchDataType(NextTypes::DataType dtype, Func &&func) {
+        using NextTypes::DataType;
+        switch (dtype) {
+            case DataType::FLOAT32: return func(TypeTag<float>{});
+            case DataType::FLOAT64: return func(TypeTag<double>{});
+            case DataType::INT32:   return func(TypeTag<int32_t>{});
+            case DataType::INT64:   return func(TypeTag<int64_t>{});
+            case DataType::UINT8:   return func(TypeTag<uint8_t>{});
+            case DataType::UINT16:  return func(TypeTag<uint16_t>{});
+            case DataType::UINT32:  return func(TypeTag<uint32_t>{});
+            case DataType::UINT64:  return func(TypeTag<uint64_t>{});
+            case DataType::INT8:    return func(TypeTag<int8_t>{});
+            case DataType::INT16:   return func(TypeTag<int16_t>{});
+            case DataType::BOOL:    return func(TypeTag<bool>{});
+            default: throw std::invalid_argument("Unsupported data type.");
+        }
+    }
+
+    /**
+     * @brief Calls a functor with the TypeTag of a floating point DataType (FLOAT32 or FLOAT64).
+     * @param dtype The runtime data type.
+     * @param func Callable as func(TypeTag<T>{}).
+     * @return Whatever func returns.
+     * @throws std::invalid_argument if the data type is not a floating point type.
+     * **/
+    template <typename Func>
+    decltype(auto) DispatchFloatType(NextTypes::DataType dtype, Func &&func) {
+        using NextTypes::DataType;
+        switch (dtype) {
+            case DataType::FLOAT32: return func(TypeTag<float>{});
+            case DataType::FLOAT64: return func(TypeTag<double>{});
+            default: throw std::invalid_argument("Operation requires a FLOAT32 or FLOAT64 tensor.");
+        }
+    }
+}
@@ -0,0 +1,297 @@
+#pragma once
+
+#include "Simd.hpp"
+#include "Dispatch.hpp"
+#include "../../Core/TensorInterface.hpp"
+#include "../../Core/TensorIterator.hpp"
+#include "../Execution/Context.hpp"
+#include "../../Utils/NextShapeUtils.hpp"
+#include "../../Utils/NextTypes/NextOpType.hpp"
+#include <type_traits> // std::conditional_t, std::is_same_v
+
+namespace NextKernels
+{
+    using OpType = NextTypes::OpType;
+    using NextTensor::TensorInterface;
+    using NextTensor::TensorIterator;
+
+    /**
+     * @brief Checks whether an operation is an elementwise binary arithmetic operation.
+     * @param op The operation.
+     * @return True for ADD, SUB, MUL and DIV.
+     * **/
+    [[nodiscard]] constexpr bool IsBinaryOp(OpType op) noexcept {
+        return op == OpType::ADD || op == OpType::SUB || op == OpType::MUL || op == OpType::DIV;
+    }
+
+    namespace Detail
+    {
+        // BOOL tensors are processed as bytes with logical semantics (ADD = or, MUL = and)
+        template <typename T>
+        using StorageOf = std::conditional_t<std::is_same_v<T, bool>, uint8_t, T>;
+
+        template <OpType Op, bool Logical, typename V>
+        NEXT_ALWAYS_INLINE void ApplyBinary(V &result, const V &a, const V &b) noexcept {
+            if constexpr (Logical) {
+                if constexpr (Op == OpType::ADD) result = a | b;
+                else result = a & b;
+            }
+            else if constexpr (Op == OpType::ADD) result = a + b;
+            else if constexpr (Op == OpType::SUB) result = a - b;
+            else if constexpr (Op == OpType::MUL) result = a * b;
+            else result = a / b;
+        }
+
+        /**
+         * @brief Operand patterns with a dedicated vector loop.
+         * FULL: both operands advance with the output. SCALAR_LHS / SCALAR_RHS: that operand is a single
+         * broadcast element (stride 0), splatted into a register once per run.
+         * Row-vector broadcasts ([N, C] + [C]) reach the FULL loop once per row through TensorIterator.
+         * **/
+        enum class BinaryPattern {
+            FULL,
+            SCALAR_LHS,
+            SCALAR_RHS
+        };
+
+        /**
+         * @brief Unit-stride binary loop; Bytes is the vector width (0 = scalar only).
+         * **/
+        template <size_t Bytes, typename T, OpType Op, bool Logical, BinaryPattern Pattern>
+        NEXT_ALWAYS_INLINE void BinaryContiguousBody(T *out, const T *a, const T *b, size_t n) noexcept {
+            constexpr bool ScalarA = Pattern == BinaryPattern::SCALAR_LHS;
+            constexpr bool ScalarB = Pattern == BinaryPattern::SCALAR_RHS;
+            size_t i = 0;
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+            if constexpr (Bytes >= 2 * sizeof(T)) {
+                using V = Vector<T, Bytes>;
+                constexpr size_t Lanes = Bytes / sizeof(T);
+                V splatA{}, splatB{};
+                if constexpr (ScalarA) BroadcastVector(splatA, a[0]);
+                if constexpr (ScalarB) BroadcastVector(splatB, b[0]);
+                for (; i + 2 * Lanes <= n; i += 2 * Lanes) {
+                    V a0 = splatA, a1 = splatA, b0 = splatB, b1 = splatB, r0, r1;
+                    if constexpr (!ScalarA) {
+                        LoadVector(a0, a + i);
+                        LoadVector(a1, a + i + Lanes);
+                    }
+                    if constexpr (!ScalarB) {
+                        LoadVector(b0, b + i);
+                        LoadVector(b1, b + i + Lanes);
+                    }
+                    ApplyBinary<Op, Logical>(r0, a0, b0);
+                    ApplyBinary<Op, Logical>(r1, a1, b1);
+                    StoreVector(out + i, r0);
+                    StoreVector(out + i + Lanes, r1);
+                }
+                for (; i + Lanes <= n; i += Lanes) {
+                    V va = splatA, vb = splatB, r;
+                    if constexpr (!ScalarA) LoadVector(va, a + i);
+                    if constexpr (!ScalarB) LoadVector(vb, b + i);
+                    ApplyBinary<Op, Logical>(r, va, vb);
+                    StoreVector(out + i, r);
+                }
+            }
+#endif
+            for (; i < n; ++i) ApplyBinary<Op, Logical>(out[i], a[ScalarA ? 0 : i], b[ScalarB ? 0 : i]);
+        }
+
+        template <typename T, OpType Op, bool Logical, BinaryPattern Pattern>
+        NEXT_TARGET_AVX512 void BinaryContiguousAvx512(T *out, const T *a, const T *b, size_t n) noexcept {
+            BinaryContiguousBody<64, T, Op, Logical, Pattern>(out, a, b, n);
+        }
+
+        template <typename T, OpType Op, bool Logical, BinaryPattern Pattern>
+        NEXT_TARGET_AVX2 void BinaryContiguousAvx2(T *out, const T *a, const T *b, size_t n) noexcept {
+            BinaryContiguousBody<32, T, Op, Logical, Pattern>(out, a, b, n);
+        }
+
+        template <typename T, OpType Op, bool Logical, BinaryPattern Pattern>
+        NEXT_TARGET_SSE2 void BinaryContiguousSse2(T *out, const T *a, const T *b, size_t n) noexcept {
+            BinaryContiguousBody<16, T, Op, Logical, Pattern>(out, a, b, n);
+        }
+
+        template <typename T, OpType Op, bool Logical, BinaryPattern Pattern>
+        void BinaryContiguousScalar(T *out, const T *a, const T *b, size_t n) noexcept {
+            BinaryContiguousBody<0, T, Op, Logical, Pattern>(out, a, b, n);
+        }
+
+        /**
+         * @brief Runs the unit-stride binary loop compiled for the active ISA level.
+         * **/
+        template <typename T, OpType Op, bool Logical, BinaryPattern Pattern = BinaryPattern::FULL>
+        void BinaryContiguous(T *out, const T *a, const T *b, size_t n) noexcept {
+            switch (GetIsaLevel()) {
+                case IsaLevel::AVX512: BinaryContiguousAvx512<T, Op, Logical, Pattern>(out, a, b, n); break;
+                case IsaLevel::AVX2:   BinaryContiguousAvx2<T, Op, Logical, Pattern>(out, a, b, n); break;
+                case IsaLevel::SSE2:   BinaryContiguousSse2<T, Op, Logical, Pattern>(out, a, b, n); break;
+                default:               BinaryContiguousScalar<T, Op, Logical, Pattern>(out, a, b, n); break;
+            }
+        }
+
+        /**
+         * @brief Strided binary loop (fallback for non-unit inner strides).
+         * **/
+        template <typename T, OpType Op, bool Logical>
+        void BinaryStrided(T *out, size_t outStride, const T *a, size_t aStride, const T *b, size_t bStride, size_t n) noexcept {
+            for (size_t i = 0; i < n; ++i) {
+                ApplyBinary<Op, Logical>(out[i * outStride], a[i * aStride], b[i * bStride]);
+            }
+        }
+
+        /**
+         * @brief Runs a binary operation over the linear positions [begin, end) of an (out, a, b) iterator,
+         * dispatching every coalesced run on its stride pattern.
+         * **/
+        template <typename S, OpType Op, bool Logical>
+        void BinaryRange(const TensorIterator<3> &iterator, S *outData, const S *aData, const S *bData, size_t begin, size_t end) {
+            iterator.ForEachRange(begin, end, [&](const TensorIterator<3>::Offsets &offsets, const TensorIterator<3>::Strides &strides, TensorSize count) {
+                S *o = outData + offsets[0];
+                const S *x = aData + offsets[1];
+                const S *y = bData + offsets[2];
+                if (strides[0] != 1) {
+                    BinaryStrided<S, Op, Logical>(o, strides[0], x, strides[1], y, strides[2], count);
+                } else if (strides[1] == 1 && strides[2] == 1) {
+                    BinaryContiguous<S, Op, Logical>(o, x, y, count);
+                } else if (strides[1] == 0 && strides[2] == 1) {
+                    BinaryContiguous<S, Op, Logical, BinaryPattern::SCALAR_LHS>(o, x, y, count);
+                } else if (strides[1] == 1 && strides[2] == 0) {
+                    BinaryContiguous<S, Op, Logical, BinaryPattern::SCALAR_RHS>(o, x, y, count);
+                } else {
+                    BinaryStrided<S, Op, Logical>(o, strides[0], x, strides[1], y, strides[2], count);
+                }
+            });
+        }
+
+        // Elementwise loops below this many elements run on the calling thread; above it, chunks of this size are the grain
+        inline constexpr size_t ElementwiseGrain = size_t(1) << 15;
+
+        template <typename T, OpType Op>
+        void RunBinary(void *out, const TensorMetadata &outMeta, const void *a, const TensorMetadata &aMeta, const void *b, const TensorMetadata &bMeta,
+                       NextExecution::ExecutionContext &context) {
+            using S = StorageOf<T>;
+            constexpr bool Logical = std::is_same_v<T, bool>;
+            S *outData = static_cast<S *>(out);
+            const S *aData = static_cast<const S *>(a);
+            const S *bData = static_cast<const S *>(b);
+            const TensorSize n = outMeta.GetTotalSize();
+
+            // Fast paths on whole buffers: full, scalar lhs, scalar rhs
+            if (outMeta.IsContiguous()) {
+                S *o = outData + outMeta.GetOffset();
+                const S *x = aData + aMeta.GetOffset();
+                const S *y = bData + bMeta.GetOffset();
+                const bool aScalar = NextUtils::ComputeStorageSize(aMeta.GetShape(), aMeta.GetStrides()) == 1;
+                const bool bScalar = NextUtils::ComputeStorageSize(bMeta.GetShape(), bMeta.GetStrides()) == 1;
+                if (aMeta.IsContiguous() && bMeta.IsContiguous()) {
+                    context.ParallelFor(0, n, ElementwiseGrain, [&](size_t begin, size_t end) {
+                        BinaryContiguous<S, Op, Logical>(o + begin, x + begin, y + begin, end - begin);
+                    });
+                    return;
+                }
+                if (bMeta.IsContiguous() && aScalar) {
+                    context.ParallelFor(0, n, ElementwiseGrain, [&](size_t begin, size_t end) {
+                        BinaryContiguous<S, Op, Logical, BinaryPattern::SCALAR_LHS>(o + begin, x, y + begin, end - begin);
+                    });
+                    return;
+                }
+                if (aMeta.IsContiguous() && bScalar) {
+                    context.ParallelFor(0, n, ElementwiseGrain, [&](size_t begin, size_t end) {
+                        BinaryContiguous<S, Op, Logical, BinaryPattern::SCALAR_RHS>(o + begin, x + begin, y, end - begin);
+                    });
+                    return;
+                }
+            }
+
+            // General case: coalesced runs, each dispatched on its stride pattern
+            const TensorIterator<3> iterator(outMeta, aMeta, bMeta);
+            context.ParallelFor(0, n, ElementwiseGrain, [&](size_t begin, size_t end) {
+                BinaryRange<S, Op, Logical>(iterator, outData, aData, bData, begin, end);
+            });
+        }
+    }
+
+    /**
+     * @brief Computes out = a <op> b elementwise for ADD, SUB, MUL or DIV, with NumPy-style broadcasting.
+     * The operands are expanded to the output shape with zero strides (NextShapeUtils::NextBroadcastTo), never materialized.
+     * Unit-stride runs use SSE2/AVX2/AVX-512 kernels chosen from the CPU at runtime, with dedicated loops for
+     * full, scalar and row-vector operands; other runs fall back to strided loops.
+     * BOOL tensors support ADD (logical or) and MUL (logical and). Integer division by zero is undefined, as in C++.
+     * @param op The operation (ADD, SUB, MUL or DIV).
+     * @param dtype The data type of all three tensors.
+     * @param out Start of the output buffer.
+     * @param outMeta Metadata of the output.
+     * @param a Start of the left operand buffer.
+     * @param aMeta Metadata of the left operand.
+     * @param b Start of the right operand buffer.
+     * @param bMeta Metadata of the right operand.
+     * @param context The execution context large tensors are split over.
+     * @throws std::invalid_argument if the operation is not supported for the data type, the output shape is not the
+     * broadcast shape or a tensor is channel-blocked (see Reorder).
+     * **/
+    inline void ElementwiseBinary(OpType op, DataType dtype, void *out, const TensorMetadata &outMeta,
+                                  const void *a, const TensorMetadata &aMeta, const void *b, const TensorMetadata &bMeta,
+                                  NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        if (!IsBinaryOp(op)) {
+            throw std::invalid_argument("ElementwiseBinary supports ADD, SUB, MUL and DIV only.");
+        }
+        NextMetadata::CheckStridedLayout(outMeta, "ElementwiseBinary");
+        NextMetadata::CheckStridedLayout(aMeta, "ElementwiseBinary");
+        NextMetadata::CheckStridedLayout(bMeta, "ElementwiseBinary");
+        if (dtype == DataType::BOOL && (op == OpType::SUB || op == OpType::DIV)) {
+            throw std::invalid_argument("BOOL tensors support ADD and MUL only.");
+        }
+        if (NextShapeUtils::NextBroadcastShape(aMeta.GetShape(), bMeta.GetShape()) != outMeta.GetShape()) {
+            throw std::invalid_argument("Elementwise output shape must be the broadcast shape of the operands.");
+        }
+        const TensorMetadata aExpanded = NextShapeUtils::NextBroadcastTo(aMeta, outMeta.GetShape());
+        const TensorMetadata bExpanded = NextShapeUtils::NextBroadcastTo(bMeta, outMeta.GetShape());
+
+        DispatchDataType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            switch (op) {
+                case OpType::ADD: Detail::RunBinary<T, OpType::ADD>(out, outMeta, a, aExpanded, b, bExpanded, context); break;
+                case OpType::SUB: Detail::RunBinary<T, OpType::SUB>(out, outMeta, a, aExpanded, b, bExpanded, context); break;
+                case OpType::MUL: Detail::RunBinary<T, OpType::MUL>(out, outMeta, a, aExpanded, b, bExpanded, context); break;
+                default:          Detail::RunBinary<T, OpType::DIV>(out, outMeta, a, aExpanded, b, bExpanded, context); break;
+            }
+        });
+    }
+
+    /**
+     * @brief Computes out = a <op> b elementwise on tensors.
+     * @param op The operation (ADD, SUB, MUL or DIV).
+     * @param a The left operand.
+     * @param b The right operand.
+     * @param out The output tensor (may alias a or b when the layouts are identical).
+     * @param context The execution context large tensors are split over.
+     * @throws std::invalid_argument if the data types differ, or see the raw-pointer overload.
+     * **/
+    inline void ElementwiseBinary(OpType op, const TensorInterface &a, const TensorInterface &b, TensorInterface &out,
+                                  NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        if (a.GetDataType() != out.GetDataType() || b.GetDataType() != out.GetDataType()) {
+            throw std::invalid_argument("Elementwise operands must have the same data type as the output.");
+        }
+        ElementwiseBinary(op, out.GetDataType(), out.GetRawData(), out.GetMetadata(), a.GetRawData(), a.GetMetadata(), b.GetRawData(), b.GetMetadata(), context);
+    }
+
+    /**
+     * @brief out = a + b. See ElementwiseBinary.
+     * **/
+    inline void Add(const TensorInterface &a, const TensorInterface &b, TensorInterface &out) { ElementwiseBinary(OpType::ADD, a, b, out); }
+
+    /**
+     * @brief out = a - b. See ElementwiseBinary.
+     * **/
+    inline void Sub(const TensorInterface &a, const TensorInterface &b, TensorInterface &out) { ElementwiseBinary(OpType::SUB, a, b, out); }
+
+    /**
+     * @brief out = a * b. See ElementwiseBinary.
+     * **/
+    inline void Mul(const TensorInterface &a, const TensorInterface &b, TensorInterface &out) { ElementwiseBinary(OpType::MUL, a, b, out); }
+
+    /**
+     * @brief out = a / b. See ElementwiseBinary.
+     * **/
+    inline void Div(const TensorInterface &a, const TensorInterface &b, TensorInterface &out) { ElementwiseBinary(OpType::DIV, a, b, out); }
+}
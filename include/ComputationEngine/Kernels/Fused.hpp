@@ -0,0 +1,197 @@
+#pragma once
+
+#include "Activation.hpp"
+#include <vector> // std::vector
+
+namespace NextKernels
+{
+    /**
+     * @brief One elementwise step applied to the result of a producer (a fused elementwise chain, a GEMM or a convolution).
+     * **/
+    struct EpilogueOperation {
+        OpType op = OpType::UNKNOWN;                      // ADD, SUB, MUL, DIV, RELU, SIGMOID or TANH
+        const void *operand = nullptr;                    // Binary steps: start of the other operand's buffer
+        TensorMetadata operandMeta{TensorShapeDynamic{}}; // Binary steps: its metadata (broadcastable to the output shape)
+        bool operandOnLeft = false;                       // Binary steps: compute operand <op> x instead of x <op> operand
+    };
+
+    /**
+     * @class Epilogue
+     * @brief A chain of elementwise steps applied in place to a contiguous output while it is still in cache.
+     *
+     * Producers call Apply on the ranges they have just finished (a GEMM after the last K block of a C block,
+     * a fused chain after its head operation), so the output is read and written once for the whole chain.
+     * Apply works on chunks small enough to stay in L1 and runs every step over a chunk before the next one.
+     * Binary operands are read through per-operand iterators, so broadcast and strided operands need no copies.
+     * Apply may be called concurrently on disjoint ranges.
+     * **/
+    class Epilogue {
+    public:
+        static constexpr size_t ChunkSize = 1024; // Elements processed by every step before moving on
+
+        /**
+         * @brief Prepares an epilogue.
+         * @param dtype The data type of the output and of every operand (FLOAT32 or FLOAT64).
+         * @param out Start of the output buffer.
+         * @param outMeta Metadata of the output (must be contiguous).
+         * @param operations The steps, in order.
+         * @throws std::invalid_argument if the output is not contiguous, a step is not elementwise, an operand does not
+         * broadcast to the output shape or the data type is not floating point.
+         * **/
+        Epilogue(DataType dtype, void *out, const TensorMetadata &outMeta, std::vector<EpilogueOperation> operations)
+            : dtype_(dtype), out_(out), outMeta_(outMeta), operations_(std::move(operations)) {
+            if (dtype != DataType::FLOAT32 && dtype != DataType::FLOAT64) {
+                throw std::invalid_argument("Epilogues require a FLOAT32 or FLOAT64 output.");
+            }
+            if (!outMeta.IsContiguous()) {
+                throw std::invalid_argument("Epilogues require a contiguous output.");
+            }
+            iterators_.reserve(operations_.size());
+            for (EpilogueOperation &operation : operations_) {
+                if (IsBinaryOp(operation.op)) {
+                    operation.operandMeta = NextShapeUtils::NextBroadcastTo(operation.operandMeta, outMeta.GetShape());
+                    iterators_.emplace_back(outMeta_, operation.operandMeta);
+                } else if (IsActivationOp(operation.op)) {
+                    iterators_.emplace_back(outMeta_, outMeta_); // Placeholder keeps indices aligned
+                } else {
+                    throw std::invalid_argument("Epilogue steps must be elementwise operations.");
+                }
+            }
+        }
+
+        /**
+         * @brief Checks whether the epilogue has no steps.
+         * **/
+        [[nodiscard]] bool IsEmpty() const noexcept { return operations_.empty(); }
+
+        /**
+         * @brief Applies every step to the output elements at linear (row-major) positions [begin, end).
+         * @param begin First position.
+         * @param end One past the last position.
+         * **/
+        void Apply(size_t begin, size_t end) const {
+            if (operations_.empty() || begin >= end) return;
+            if (dtype_ == DataType::FLOAT32) ApplyTyped<float>(begin, end);
+            else ApplyTyped<double>(begin, end);
+        }
+
+    private:
+        template <typename T, OpType Op>
+        static void BinaryRun(bool operandOnLeft, T *x, const T *operand, size_t stride, size_t count) {
+            if (stride == 1) {
+                if (operandOnLeft) Detail::BinaryContiguous<T, Op, false>(x, operand, x, count);
+                else Detail::BinaryContiguous<T, Op, false>(x, x, operand, count);
+            } else if (stride == 0) {
+                if (operandOnLeft) Detail::BinaryContiguous<T, Op, false, Detail::BinaryPattern::SCALAR_LHS>(x, operand, x, count);
+                else Detail::BinaryContiguous<T, Op, false, Detail::BinaryPattern::SCALAR_RHS>(x, x, operand, count);
+            } else {
+                for (size_t i = 0; i < count; ++i) {
+                    if (operandOnLeft) Detail::ApplyBinary<Op, false>(x[i], operand[i * stride], x[i]);
+                    else Detail::ApplyBinary<Op, false>(x[i], x[i], operand[i * stride]);
+                }
+            }
+        }
+
+        template <typename T>
+        void ApplyTyped(size_t begin, size_t end) const {
+            T *outData = static_cast<T *>(out_) + outMeta_.GetOffset();
+            for (size_t chunk = begin; chunk < end; chunk += ChunkSize) {
+                const size_t chunkEnd = std::min(end, chunk + ChunkSize);
+                for (size_t step = 0; step < operations_.size(); ++step) {
+                    const EpilogueOperation &operation = operations_[step];
+                    if (IsActivationOp(operation.op)) {
+                        Detail::ActivationInPlace(operation.op, outData + chunk, chunkEnd - chunk);
+                        continue;
+                    }
+                    const T *operand = static_cast<const T *>(operation.operand);
+                    size_t position = chunk;
+                    iterators_[step].ForEachRange(chunk, chunkEnd, [&](const TensorIterator<2>::Offsets &offsets, const TensorIterator<2>::Strides &strides, TensorSize count) {
+                        T *x = outData + position;
+                        const T *y = operand + offsets[1];
+                        switch (operation.op) {
+                            case OpType::ADD: BinaryRun<T, OpType::ADD>(operation.operandOnLeft, x, y, strides[1], count); break;
+                            case OpType::SUB: BinaryRun<T, OpType::SUB>(operation.operandOnLeft, x, y, strides[1], count); break;
+                            case OpType::MUL: BinaryRun<T, OpType::MUL>(operation.operandOnLeft, x, y, strides[1], count); break;
+                            default:          BinaryRun<T, OpType::DIV>(operation.operandOnLeft, x, y, strides[1], count); break;
+                        }
+                        position += count;
+                    });
+                }
+            }
+        }
+
+        DataType dtype_;                           // Element type
+        void *out_;                                // Start of the output buffer
+        TensorMetadata outMeta_;                   // Output metadata (contiguous)
+        std::vector<EpilogueOperation> operations_; // Steps, operands broadcast to the output shape
+        std::vector<TensorIterator<2>> iterators_;  // Per step: (output, operand) iteration space
+    };
+
+    /**
+     * @brief Runs an elementwise head operation followed by an epilogue in a single pass over the output.
+     * The head (ADD/SUB/MUL/DIV of two inputs, or RELU/SIGMOID/TANH of one) writes a chunk, then every epilogue
+     * step runs on that chunk while it is in L1, so the output is written to memory once.
+     * @param op The head operation.
+     * @param dtype The data type of every tensor (FLOAT32 or FLOAT64).
+     * @param out Start of the output buffer.
+     * @param outMeta Metadata of the output (contiguous).
+     * @param inputs Head operand buffers (two for binary heads, one for activations).
+     * @param inputMetas Head operand metadata, broadcastable to the output shape.
+     * @param epilogue The steps applied after the head.
+     * @param context The execution context large tensors are split over.
+     * @throws std::invalid_argument if the head is not elementwise, the operand count is wrong, or see Epilogue.
+     * **/
+    inline void FusedElementwise(OpType op, DataType dtype, void *out, const TensorMetadata &outMeta,
+                                 const std::vector<const void *> &inputs, const std::vector<TensorMetadata> &inputMetas,
+                                 const Epilogue &epilogue, NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        const bool binary = IsBinaryOp(op);
+        if (!binary && !IsActivationOp(op)) {
+            throw std::invalid_argument("Fused head must be an elementwise operation.");
+        }
+        if (inputs.size() != (binary ? 2u : 1u) || inputMetas.size() != inputs.size()) {
+            throw std::invalid_argument("Fused head has the wrong number of operands.");
+        }
+        if (!outMeta.IsContiguous()) {
+            throw std::invalid_argument("Fused output must be contiguous.");
+        }
+        const TensorSize n = outMeta.GetTotalSize();
+        DispatchFloatType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            T *outData = static_cast<T *>(out);
+            if (binary) {
+                const TensorIterator<3> iterator(outMeta, NextShapeUtils::NextBroadcastTo(inputMetas[0], outMeta.GetShape()),
+                                                 NextShapeUtils::NextBroadcastTo(inputMetas[1], outMeta.GetShape()));
+                const T *aData = static_cast<const T *>(inputs[0]);
+                const T *bData = static_cast<const T *>(inputs[1]);
+                context.ParallelFor(0, n, Detail::ElementwiseGrain, [&](size_t begin, size_t end) {
+                    for (size_t chunk = begin; chunk < end; chunk += Epilogue::ChunkSize) {
+                        const size_t chunkEnd = std::min(end, chunk + Epilogue::ChunkSize);
+                        switch (op) {
+                            case OpType::ADD: Detail::BinaryRange<T, OpType::ADD, false>(iterator, outData, aData, bData, chunk, chunkEnd); break;
+                            case OpType::SUB: Detail::BinaryRange<T, OpType::SUB, false>(iterator, outData, aData, bData, chunk, chunkEnd); break;
+                            case OpType::MUL: Detail::BinaryRange<T, OpType::MUL, false>(iterator, outData, aData, bData, chunk, chunkEnd); break;
+                            default:          Detail::BinaryRange<T, OpType::DIV, false>(iterator, outData, aData, bData, chunk, chunkEnd); break;
+                        }
+                        epilogue.Apply(chunk, chunkEnd);
+                    }
+                });
+            } else {
+                if (inputMetas[0].GetShape() != outMeta.GetShape()) {
+                    throw std::invalid_argument("Activation output shape must match the input.");
+                }
+                const TensorIterator<2> iterator(outMeta, inputMetas[0]);
+                const T *inData = static_cast<const T *>(inputs[0]);
+                Detail::DispatchActivation(op, [&](auto opTag) {
+                    constexpr OpType Op = decltype(opTag)::value;
+                    context.ParallelFor(0, n, Detail::ElementwiseGrain, [&](size_t begin, size_t end) {
+                        for (size_t chunk = begin; chunk < end; chunk += Epilogue::ChunkSize) {
+                            const size_t chunkEnd = std::min(end, chunk + Epilogue::ChunkSize);
+                            Detail::ActivationRange<T, Op>(iterator, outData, inData, chunk, chunkEnd);
+                            epilogue.Apply(chunk, chunkEnd);
+                        }
+                    });
+                });
+            }
+        });
+    }
+}
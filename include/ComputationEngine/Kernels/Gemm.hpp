@@ -0,0 +1,638 @@
+#pragma once
+
+#include "Simd.hpp"
+#include "Dispatch.hpp"
+#include "Fused.hpp"
+#include "../../Core/TensorInterface.hpp"
+#include "../../Core/TensorIterator.hpp"
+#include "../../Core/Memory/Allocator.hpp"
+#include "../Execution/Context.hpp"
+#include "../../Utils/NextShapeUtils.hpp"
+#include <algorithm>  // std::min
+#include <functional> // std::function
+
+namespace NextKernels
+{
+    using NextTensor::TensorInterface;
+    using NextTensor::TensorIterator;
+
+    /**
+     * @brief Callback run on every block of C as soon as its final value is written: (row, col, rows, cols).
+     * Blocks are disjoint and cover C exactly once; the callback may run concurrently on different blocks.
+     * **/
+    using GemmEpilogue = std::function<void(size_t, size_t, size_t, size_t)>;
+
+    namespace Detail
+    {
+        /**
+         * @brief Grow-only, 64-byte aligned scratch buffer used for packed GEMM panels.
+         * **/
+        class PackBuffer {
+        public:
+            PackBuffer() noexcept = default;
+            ~PackBuffer() { NextMemory::GetAlignedAllocator().Deallocate(data_, bytes_); }
+            PackBuffer(const PackBuffer&) = delete;
+            PackBuffer& operator=(const PackBuffer&) = delete;
+
+            template <typename T>
+            [[nodiscard]] T *Reserve(size_t count) {
+                const size_t bytes = NextMemory::AlignUp(count * sizeof(T), NextMemory::DefaultAlignment);
+                if (bytes > bytes_) {
+                    NextMemory::GetAlignedAllocator().Deallocate(data_, bytes_);
+                    data_ = nullptr;
+                    bytes_ = 0;
+                    data_ = NextMemory::GetAlignedAllocator().Allocate(bytes);
+                    bytes_ = bytes;
+                }
+                return static_cast<T *>(data_);
+            }
+
+        private:
+            friend class PackBufferLease;
+
+            void *data_ = nullptr; // Aligned buffer
+            size_t bytes_ = 0;     // Size of the buffer in bytes
+            bool busy_ = false;    // Held by a PackBufferLease
+        };
+
+        // Packing buffers of the calling thread (A block and B panel)
+        inline PackBuffer &ThreadPackBufferA() { thread_local PackBuffer buffer; return buffer; }
+        inline PackBuffer &ThreadPackBufferB() { thread_local PackBuffer buffer; return buffer; }
+
+        /**
+         * @brief Holds a thread packing buffer for the duration of one GEMM call, or a buffer of its own if the
+         * thread buffer is already held.
+         * A thread waiting inside ParallelFor runs other pending tasks, which may start another GEMM (nested or
+         * from another job) while the workers of the first call still read the panel it packed; the nested call
+         * then finds the buffer busy and packs into the lease's own buffer instead of overwriting (or reallocating)
+         * the shared one.
+         * **/
+        class PackBufferLease {
+        public:
+            explicit PackBufferLease(PackBuffer &buffer) noexcept : shared_(buffer.busy_ ? nullptr : &buffer) {
+                if (shared_) shared_->busy_ = true;
+            }
+            ~PackBufferLease() {
+                if (shared_) shared_->busy_ = false;
+            }
+            PackBufferLease(const PackBufferLease&) = delete;
+            PackBufferLease& operator=(const PackBufferLease&) = delete;
+
+            template <typename T>
+            [[nodiscard]] T *Reserve(size_t count) { return (shared_ ? *shared_ : owned_).Reserve<T>(count); }
+
+        private:
+            PackBuffer *shared_; // Thread buffer held by the lease, or nullptr when it was busy
+            PackBuffer owned_;   // Fallback buffer, allocated only when the thread buffer was busy
+        };
+
+        /**
+         * @brief Writes an MR x NR register tile back to C (overwrite or accumulate), clipped to mr x nr.
+         * **/
+        template <typename T, typename V, size_t MR, size_t NV>
+        NEXT_ALWAYS_INLINE void GemmStoreTile(const V (&acc)[MR][NV], T *c, size_t rsC, size_t csC, size_t mr, size_t nr, bool accumulate) noexcept {
+            constexpr size_t Lanes = sizeof(V) / sizeof(T);
+            constexpr size_t NR = NV * Lanes;
+            if (mr == MR && nr == NR && csC == 1) {
+                NEXT_UNROLL
+                for (size_t i = 0; i < MR; ++i) {
+                    NEXT_UNROLL
+                    for (size_t j = 0; j < NV; ++j) {
+                        V value = acc[i][j];
+                        if (accumulate) {
+                            V old;
+                            LoadVector(old, c + i * rsC + j * Lanes);
+                            value += old;
+                        }
+                        StoreVector(c + i * rsC + j * Lanes, value);
+                    }
+                }
+                return;
+            }
+            // Edge tile or strided C: spill the tile and copy the valid part
+            alignas(64) T tile[MR * NR];
+            for (size_t i = 0; i < MR; ++i) {
+                for (size_t j = 0; j < NV; ++j) StoreVector(tile + i * NR + j * Lanes, acc[i][j]);
+            }
+            for (size_t i = 0; i < mr; ++i) {
+                for (size_t j = 0; j < nr; ++j) {
+                    T &dst = c[i * rsC + j * csC];
+                    dst = accumulate ? dst + tile[i * NR + j] : tile[i * NR + j];
+                }
+            }
+        }
+
+#if NEXT_SIMD_X86
+        /**
+         * @brief Register-blocked micro-kernel computing an MR x (NV * 16 / 8) tile with AVX-512 FMA.
+         * a: packed MR-row panel (kc x MR), b: packed NR-column panel (kc x NR).
+         * **/
+        template <typename T, size_t MR, size_t NV>
+        NEXT_TARGET_AVX512 void GemmMicroKernelAvx512(size_t kc, const T *a, const T *b, T *c, size_t rsC, size_t csC, size_t mr, size_t nr, bool accumulate) noexcept {
+            using V = Vector<T, 64>;
+            constexpr size_t Lanes = 64 / sizeof(T);
+            constexpr size_t NR = NV * Lanes;
+            V acc[MR][NV];
+            NEXT_UNROLL
+            for (size_t i = 0; i < MR; ++i) {
+                NEXT_UNROLL
+                for (size_t j = 0; j < NV; ++j) acc[i][j] = V{};
+            }
+            for (size_t p = 0; p < kc; ++p) {
+                V bv[NV];
+                NEXT_UNROLL
+                for (size_t j = 0; j < NV; ++j) LoadVector(bv[j], b + p * NR + j * Lanes);
+                NEXT_UNROLL
+                for (size_t i = 0; i < MR; ++i) {
+                    V av;
+                    if constexpr (sizeof(T) == 4) av = _mm512_set1_ps(a[p * MR + i]);
+                    else av = _mm512_set1_pd(a[p * MR + i]);
+                    NEXT_UNROLL
+                    for (size_t j = 0; j < NV; ++j) {
+                        if constexpr (sizeof(T) == 4) acc[i][j] = _mm512_fmadd_ps(av, bv[j], acc[i][j]);
+                        else acc[i][j] = _mm512_fmadd_pd(av, bv[j], acc[i][j]);
+                    }
+                }
+            }
+            GemmStoreTile<T, V, MR, NV>(acc, c, rsC, csC, mr, nr, accumulate);
+        }
+
+        /**
+         * @brief Register-blocked micro-kernel computing an MR x NR tile with AVX2 FMA.
+         * **/
+        template <typename T, size_t MR, size_t NV>
+        NEXT_TARGET_AVX2 void GemmMicroKernelAvx2(size_t kc, const T *a, const T *b, T *c, size_t rsC, size_t csC, size_t mr, size_t nr, bool accumulate) noexcept {
+            using V = Vector<T, 32>;
+            constexpr size_t Lanes = 32 / sizeof(T);
+            constexpr size_t NR = NV * Lanes;
+            V acc[MR][NV];
+            NEXT_UNROLL
+            for (size_t i = 0; i < MR; ++i) {
+                NEXT_UNROLL
+                for (size_t j = 0; j < NV; ++j) acc[i][j] = V{};
+            }
+            for (size_t p = 0; p < kc; ++p) {
+                V bv[NV];
+                NEXT_UNROLL
+                for (size_t j = 0; j < NV; ++j) LoadVector(bv[j], b + p * NR + j * Lanes);
+                NEXT_UNROLL
+                for (size_t i = 0; i < MR; ++i) {
+                    V av;
+                    if constexpr (sizeof(T) == 4) av = _mm256_set1_ps(a[p * MR + i]);
+                    else av = _mm256_set1_pd(a[p * MR + i]);
+                    NEXT_UNROLL
+                    for (size_t j = 0; j < NV; ++j) {
+                        if constexpr (sizeof(T) == 4) acc[i][j] = _mm256_fmadd_ps(av, bv[j], acc[i][j]);
+                        else acc[i][j] = _mm256_fmadd_pd(av, bv[j], acc[i][j]);
+                    }
+                }
+            }
+            GemmStoreTile<T, V, MR, NV>(acc, c, rsC, csC, mr, nr, accumulate);
+        }
+#endif
+
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+        /**
+         * @brief Register-blocked micro-kernel computing an MR x NR tile with 16-byte vectors (SSE2, no FMA).
+         * **/
+        template <typename T, size_t MR, size_t NV>
+        NEXT_TARGET_SSE2 void GemmMicroKernelSse2(size_t kc, const T *a, const T *b, T *c, size_t rsC, size_t csC, size_t mr, size_t nr, bool accumulate) noexcept {
+            using V = Vector<T, 16>;
+            constexpr size_t Lanes = 16 / sizeof(T);
+            constexpr size_t NR = NV * Lanes;
+            V acc[MR][NV];
+            NEXT_UNROLL
+            for (size_t i = 0; i < MR; ++i) {
+                NEXT_UNROLL
+                for (size_t j = 0; j < NV; ++j) acc[i][j] = V{};
+            }
+            for (size_t p = 0; p < kc; ++p) {
+                V bv[NV];
+                NEXT_UNROLL
+                for (size_t j = 0; j < NV; ++j) LoadVector(bv[j], b + p * NR + j * Lanes);
+                NEXT_UNROLL
+                for (size_t i = 0; i < MR; ++i) {
+                    V av;
+#if NEXT_SIMD_X86
+                    if constexpr (sizeof(T) == 4) av = _mm_set1_ps(a[p * MR + i]);
+                    else av = _mm_set1_pd(a[p * MR + i]);
+#else
+                    BroadcastVector(av, a[p * MR + i]);
+#endif
+                    NEXT_UNROLL
+                    for (size_t j = 0; j < NV; ++j) acc[i][j] += av * bv[j];
+                }
+            }
+            GemmStoreTile<T, V, MR, NV>(acc, c, rsC, csC, mr, nr, accumulate);
+        }
+#endif
+
+        /**
+         * @brief Portable scalar micro-kernel (used when vector extensions are unavailable).
+         * **/
+        template <typename T, size_t MR, size_t NR>
+        void GemmMicroKernelScalar(size_t kc, const T *a, const T *b, T *c, size_t rsC, size_t csC, size_t mr, size_t nr, bool accumulate) noexcept {
+            T acc[MR][NR] = {};
+            for (size_t p = 0; p < kc; ++p) {
+                for (size_t i = 0; i < MR; ++i) {
+                    for (size_t j = 0; j < NR; ++j) acc[i][j] += a[p * MR + i] * b[p * NR + j];
+                }
+            }
+            for (size_t i = 0; i < mr; ++i) {
+                for (size_t j = 0; j < nr; ++j) {
+                    T &dst = c[i * rsC + j * csC];
+                    dst = accumulate ? dst + acc[i][j] : acc[i][j];
+                }
+            }
+        }
+
+        /**
+         * @brief Blocking parameters and micro-kernel of one (element type, ISA) pair.
+         * MR x NR is the register tile, KC x NR the B panel kept in L1, MC x KC the A block kept in L2,
+         * KC x NC the B block kept in L3.
+         * **/
+        template <typename T, IsaLevel Isa>
+        struct GemmConfig;
+
+#if NEXT_SIMD_X86
+        template <typename T>
+        struct GemmConfig<T, IsaLevel::AVX512> {
+            static constexpr size_t MR = 12;
+            static constexpr size_t NV = 2;
+            static constexpr size_t NR = NV * 64 / sizeof(T);
+            static constexpr size_t KC = 256;
+            static constexpr size_t MC = MR * (sizeof(T) == 4 ? 12 : 8);
+            static constexpr size_t NC = 3072;
+            static constexpr auto MicroKernel = &GemmMicroKernelAvx512<T, MR, NV>;
+        };
+
+        template <typename T>
+        struct GemmConfig<T, IsaLevel::AVX2> {
+            static constexpr size_t MR = 6;
+            static constexpr size_t NV = 2;
+            static constexpr size_t NR = NV * 32 / sizeof(T);
+            static constexpr size_t KC = 256;
+            static constexpr size_t MC = MR * (sizeof(T) == 4 ? 24 : 16);
+            static constexpr size_t NC = 3072;
+            static constexpr auto MicroKernel = &GemmMicroKernelAvx2<T, MR, NV>;
+        };
+#endif
+
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+
+        template <typename T>
+        struct GemmConfig<T, IsaLevel::SSE2> {
+            static constexpr size_t MR = 4;
+            static constexpr size_t NV = 2;
+            static constexpr size_t NR = NV * 16 / sizeof(T);
+            static constexpr size_t KC = 256;
+            static constexpr size_t MC = MR * 24;
+            static constexpr size_t NC = 2048;
+            static constexpr auto MicroKernel = &GemmMicroKernelSse2<T, MR, NV>;
+        };
+#endif
+
+        template <typename T>
+        struct GemmConfig<T, IsaLevel::SCALAR> {
+            static constexpr size_t MR = 4;
+            static constexpr size_t NR = 4;
+            static constexpr size_t KC = 256;
+            static constexpr size_t MC = 64;
+            static constexpr size_t NC = 1024;
+            static constexpr auto MicroKernel = &GemmMicroKernelScalar<T, MR, NR>;
+        };
+
+        /**
+         * @brief Packs an mc x kc block of A into MR-row panels (column of MR values per k), zero-padding the last panel.
+         * **/
+        template <typename T, size_t MR>
+        void GemmPackA(size_t mc, size_t kc, const T *a, size_t rsA, size_t csA, T *packed) noexcept {
+            for (size_t ir = 0; ir < mc; ir += MR) {
+                const size_t mr = std::min(MR, mc - ir);
+                const T *panel = a + ir * rsA;
+                for (size_t p = 0; p < kc; ++p) {
+                    size_t i = 0;
+                    for (; i < mr; ++i) packed[i] = panel[i * rsA + p * csA];
+                    for (; i < MR; ++i) packed[i] = T(0);
+                    packed += MR;
+                }
+            }
+        }
+
+        /**
+         * @brief Packs a kc x nc block of B into NR-column panels (row of NR values per k), zero-padding the last panel.
+         * **/
+        template <typename T, size_t NR>
+        void GemmPackB(size_t kc, size_t nc, const T *b, size_t rsB, size_t csB, T *packed) noexcept {
+            for (size_t jr = 0; jr < nc; jr += NR) {
+                const size_t nr = std::min(NR, nc - jr);
+                const T *panel = b + jr * csB;
+                for (size_t p = 0; p < kc; ++p) {
+                    const T *row = panel + p * rsB;
+                    size_t j = 0;
+                    if (csB == 1) {
+                        for (; j < nr; ++j) packed[j] = row[j];
+                    } else {
+                        for (; j < nr; ++j) packed[j] = row[j * csB];
+                    }
+                    for (; j < NR; ++j) packed[j] = T(0);
+                    packed += NR;
+                }
+            }
+        }
+
+        /**
+         * @brief Runs the macro-kernel: every MR x NR tile of an mc x nc block of C from packed A and B.
+         * **/
+        template <typename T, typename Config>
+        void GemmMacroKernel(size_t mc, size_t nc, size_t kc, const T *packedA, const T *packedB, T *c, size_t rsC, size_t csC, bool accumulate) noexcept {
+            for (size_t jr = 0; jr < nc; jr += Config::NR) {
+                const size_t nr = std::min(Config::NR, nc - jr);
+                for (size_t ir = 0; ir < mc; ir += Config::MR) {
+                    const size_t mr = std::min(Config::MR, mc - ir);
+                    Config::MicroKernel(kc, packedA + ir * kc, packedB + jr * kc, c + ir * rsC + jr * csC, rsC, csC, mr, nr, accumulate);
+                }
+            }
+        }
+
+        // Below this many multiply-adds a GEMM runs on the calling thread (thread wake-up would dominate)
+        inline constexpr size_t GemmMinParallelWork = size_t(1) << 18;
+
+        /**
+         * @brief Splits the threads of a GEMM block into an mt x nt grid over its M x N output.
+         * Picks the factorization with the smallest partition perimeter (rows + columns per part),
+         * which minimizes the A and B data every thread streams. Parts are multiples of the register tile.
+         * **/
+        struct GemmGrid {
+            size_t mt = 1;       // Parts along M
+            size_t nt = 1;       // Parts along N
+            size_t rowsPer = 0;  // Rows per part (multiple of MR)
+            size_t colsPer = 0;  // Columns per part (multiple of NR)
+        };
+
+        inline GemmGrid GemmPartition(size_t threads, size_t m, size_t n, size_t MR, size_t NR) noexcept {
+            const size_t mTiles = (m + MR - 1) / MR;
+            const size_t nTiles = (n + NR - 1) / NR;
+            GemmGrid best;
+            best.rowsPer = mTiles * MR;
+            best.colsPer = nTiles * NR;
+            size_t bestCost = best.rowsPer + best.colsPer;
+            size_t bestParts = 1;
+            for (size_t mt = 1; mt <= threads; ++mt) {
+                const size_t nt = threads / mt;
+                if (mt > mTiles || nt > nTiles) continue;
+                const size_t rowsPer = (mTiles + mt - 1) / mt * MR;
+                const size_t colsPer = (nTiles + nt - 1) / nt * NR;
+                const size_t cost = rowsPer + colsPer;
+                if (mt * nt > bestParts || (mt * nt == bestParts && cost < bestCost)) {
+                    best = GemmGrid{mt, nt, rowsPer, colsPer};
+                    bestCost = cost;
+                    bestParts = mt * nt;
+                }
+            }
+            // Drop parts that an uneven split left empty
+            best.mt = (mTiles * MR + best.rowsPer - 1) / best.rowsPer;
+            best.nt = (nTiles * NR + best.colsPer - 1) / best.colsPer;
+            return best;
+        }
+
+        /**
+         * @brief Blocked GEMM driver (GotoBLAS loop order jc -> pc -> ic -> jr -> ir).
+         * With more than one thread, every kc x nc block of B is packed once, cooperatively, into a buffer
+         * shared by all threads and held by the call until it returns (see PackBufferLease); the mc x nc block of C is then split in 2D (see GemmPartition) and every
+         * thread packs the A rows of its part into its own buffer and runs the macro-kernel on its columns.
+         * The epilogue runs on each mc x nc block right after its last K block, while it is still in cache.
+         * **/
+        template <typename T, typename Config>
+        void GemmBlocked(size_t M, size_t N, size_t K, const T *a, size_t rsA, size_t csA, const T *b, size_t rsB, size_t csB,
+                         T *c, size_t rsC, size_t csC, bool accumulate, const GemmEpilogue *epilogue, NextExecution::ExecutionContext &context) {
+            PackBufferLease bufferB(ThreadPackBufferB()); // Read by every thread until the call returns
+            T *packedB = bufferB.Reserve<T>(Config::KC * ((Config::NC + Config::NR - 1) / Config::NR) * Config::NR);
+
+            const size_t work = M * N * K;
+            size_t threads = std::min(context.GetNumThreads(), std::max<size_t>(1, work / GemmMinParallelWork));
+
+            if (threads <= 1) {
+                PackBufferLease bufferA(ThreadPackBufferA());
+                T *packedA = bufferA.Reserve<T>(Config::MC * Config::KC);
+                for (size_t jc = 0; jc < N; jc += Config::NC) {
+                    const size_t nc = std::min(Config::NC, N - jc);
+                    for (size_t pc = 0; pc < K; pc += Config::KC) {
+                        const size_t kc = std::min(Config::KC, K - pc);
+                        GemmPackB<T, Config::NR>(kc, nc, b + pc * rsB + jc * csB, rsB, csB, packedB);
+                        const bool accumulateBlock = accumulate || pc > 0;
+                        const bool lastBlock = pc + kc == K;
+                        for (size_t ic = 0; ic < M; ic += Config::MC) {
+                            const size_t mc = std::min(Config::MC, M - ic);
+                            GemmPackA<T, Config::MR>(mc, kc, a + ic * rsA + pc * csA, rsA, csA, packedA);
+                            GemmMacroKernel<T, Config>(mc, nc, kc, packedA, packedB, c + ic * rsC + jc * csC, rsC, csC, accumulateBlock);
+                            if (epilogue && lastBlock) (*epilogue)(ic, jc, mc, nc);
+                        }
+                    }
+                }
+                return;
+            }
+
+            for (size_t jc = 0; jc < N; jc += Config::NC) {
+                const size_t nc = std::min(Config::NC, N - jc);
+                const size_t nPanels = (nc + Config::NR - 1) / Config::NR;
+                const GemmGrid grid = GemmPartition(threads, M, nc, Config::MR, Config::NR);
+
+                for (size_t pc = 0; pc < K; pc += Config::KC) {
+                    const size_t kc = std::min(Config::KC, K - pc);
+                    const bool accumulateBlock = accumulate || pc > 0;
+                    const bool lastBlock = pc + kc == K;
+
+                    // Pack the shared B block, one range of NR panels per thread
+                    const T *bBlock = b + pc * rsB + jc * csB;
+                    context.ParallelFor(0, nPanels, (nPanels + threads - 1) / threads, [&](size_t panelBegin, size_t panelEnd) {
+                        const size_t n0 = panelBegin * Config::NR;
+                        const size_t n1 = std::min(nc, panelEnd * Config::NR);
+                        GemmPackB<T, Config::NR>(kc, n1 - n0, bBlock + n0 * csB, rsB, csB, packedB + n0 * kc);
+                    });
+
+                    // Compute the 2D parts of C
+                    context.ParallelFor(0, grid.mt * grid.nt, 1, [&](size_t partBegin, size_t partEnd) {
+                        PackBufferLease bufferA(ThreadPackBufferA());
+                        T *packedA = bufferA.Reserve<T>(Config::MC * Config::KC);
+                        for (size_t part = partBegin; part < partEnd; ++part) {
+                            const size_t m0 = (part / grid.nt) * grid.rowsPer;
+                            const size_t n0 = (part % grid.nt) * grid.colsPer;
+                            const size_t m1 = std::min(M, m0 + grid.rowsPer);
+                            const size_t n1 = std::min(nc, n0 + grid.colsPer);
+                            for (size_t ic = m0; ic < m1; ic += Config::MC) {
+                                const size_t mc = std::min(Config::MC, m1 - ic);
+                                GemmPackA<T, Config::MR>(mc, kc, a + ic * rsA + pc * csA, rsA, csA, packedA);
+                                GemmMacroKernel<T, Config>(mc, n1 - n0, kc, packedA, packedB + n0 * kc,
+                                                           c + ic * rsC + (jc + n0) * csC, rsC, csC, accumulateBlock);
+                                if (epilogue && lastBlock) (*epilogue)(ic, jc + n0, mc, n1 - n0);
+                            }
+                        }
+                    });
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief General matrix multiply C = A * B (or C += A * B) on strided operands.
+     * A BLIS/GotoBLAS style implementation: A and B are packed into cache-sized panels and an
+     * MR x NR register-blocked micro-kernel (AVX-512 / AVX2+FMA / SSE2, chosen at runtime) computes each tile.
+     * Any row/column strides are accepted, so transposed views (NextTranspose) are consumed without a copy:
+     * the transpose is absorbed by the packing step.
+     * @tparam T float or double.
+     * @param M Rows of A and C.
+     * @param N Columns of B and C.
+     * @param K Columns of A and rows of B.
+     * @param a Pointer to A[0][0]; element (i, p) is a[i * rsA + p * csA].
+     * @param b Pointer to B[0][0]; element (p, j) is b[p * rsB + j * csB].
+     * @param c Pointer to C[0][0]; element (i, j) is c[i * rsC + j * csC].
+     * @param accumulate If true, C += A * B; otherwise C = A * B.
+     * @param context The execution context large products are spread over (small ones run on the caller).
+     * @param epilogue Optional callback run on every finished block of C (see GemmEpilogue), e.g. a fused bias + activation.
+     * **/
+    template <typename T>
+    void Gemm(size_t M, size_t N, size_t K, const T *a, size_t rsA, size_t csA, const T *b, size_t rsB, size_t csB,
+              T *c, size_t rsC, size_t csC, bool accumulate = false,
+              NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext(), const GemmEpilogue *epilogue = nullptr) {
+        static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "Gemm supports float and double.");
+        if (M == 0 || N == 0) return;
+        if (K == 0) {
+            if (!accumulate) {
+                for (size_t i = 0; i < M; ++i) {
+                    for (size_t j = 0; j < N; ++j) c[i * rsC + j * csC] = T(0);
+                }
+            }
+            if (epilogue) (*epilogue)(0, 0, M, N);
+            return;
+        }
+
+        switch (GetIsaLevel()) {
+#if NEXT_SIMD_X86
+            case IsaLevel::AVX512:
+                Detail::GemmBlocked<T, Detail::GemmConfig<T, IsaLevel::AVX512>>(M, N, K, a, rsA, csA, b, rsB, csB, c, rsC, csC, accumulate, epilogue, context);
+                break;
+            case IsaLevel::AVX2:
+                Detail::GemmBlocked<T, Detail::GemmConfig<T, IsaLevel::AVX2>>(M, N, K, a, rsA, csA, b, rsB, csB, c, rsC, csC, accumulate, epilogue, context);
+                break;
+#endif
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+            case IsaLevel::SSE2:
+                Detail::GemmBlocked<T, Detail::GemmConfig<T, IsaLevel::SSE2>>(M, N, K, a, rsA, csA, b, rsB, csB, c, rsC, csC, accumulate, epilogue, context);
+                break;
+#endif
+            default:
+                Detail::GemmBlocked<T, Detail::GemmConfig<T, IsaLevel::SCALAR>>(M, N, K, a, rsA, csA, b, rsB, csB, c, rsC, csC, accumulate, epilogue, context);
+                break;
+        }
+    }
+
+    /**
+     * @brief Matrix product out = a @ b for FLOAT32/FLOAT64 tensors of rank >= 2.
+     * The last two dimensions are multiplied ([.., M, K] x [.., K, N] -> [.., M, N]); leading batch
+     * dimensions broadcast (NumPy matmul rules). Operands may be arbitrary strided views.
+     * @param dtype The data type of all three tensors.
+     * @param out Start of the output buffer.
+     * @param outMeta Metadata of the output.
+     * @param a Start of the left operand buffer.
+     * @param aMeta Metadata of the left operand.
+     * @param b Start of the right operand buffer.
+     * @param bMeta Metadata of the right operand.
+     * @param context The execution context the products run on.
+     * @param epilogue Optional elementwise steps applied to every block of the output as soon as it is final
+     * (requires a contiguous output; its positions are the linear positions of out).
+     * @throws std::invalid_argument if the shapes are incompatible, the data type is not floating point, an epilogue
+     * is given with a non-contiguous output or a tensor is channel-blocked (see Reorder).
+     * **/
+    inline void MatMul(DataType dtype, void *out, const TensorMetadata &outMeta,
+                       const void *a, const TensorMetadata &aMeta, const void *b, const TensorMetadata &bMeta,
+                       NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext(), const Epilogue *epilogue = nullptr) {
+        NextMetadata::CheckStridedLayout(outMeta, "MatMul");
+        NextMetadata::CheckStridedLayout(aMeta, "MatMul");
+        NextMetadata::CheckStridedLayout(bMeta, "MatMul");
+        const TensorRank aRank = aMeta.GetRank();
+        const TensorRank bRank = bMeta.GetRank();
+        const TensorRank outRank = outMeta.GetRank();
+        if (aRank < 2 || bRank < 2 || outRank < 2) {
+            throw std::invalid_argument("MatMul requires operands of rank >= 2.");
+        }
+        const TensorSize M = aMeta.GetShape()[aRank - 2];
+        const TensorSize K = aMeta.GetShape()[aRank - 1];
+        const TensorSize N = bMeta.GetShape()[bRank - 1];
+        if (bMeta.GetShape()[bRank - 2] != K) {
+            throw std::invalid_argument("MatMul inner dimensions do not match.");
+        }
+
+        // Broadcast the batch dimensions
+        const TensorShapeDynamic aBatch(aMeta.GetShape().begin(), aMeta.GetShape().end() - 2);
+        const TensorShapeDynamic bBatch(bMeta.GetShape().begin(), bMeta.GetShape().end() - 2);
+        TensorShapeDynamic expectedShape = NextShapeUtils::NextBroadcastShape(aBatch, bBatch);
+        const TensorShapeDynamic batchShape = expectedShape;
+        expectedShape.push_back(M);
+        expectedShape.push_back(N);
+        if (expectedShape != outMeta.GetShape()) {
+            throw std::invalid_argument("MatMul output shape does not match the operands.");
+        }
+        if (epilogue && !epilogue->IsEmpty() && !outMeta.IsContiguous()) {
+            throw std::invalid_argument("MatMul epilogues require a contiguous output.");
+        }
+        if (epilogue && epilogue->IsEmpty()) epilogue = nullptr;
+
+        // Batch iteration space: metadata of the leading dimensions only (matrix origin = offset)
+        const TensorMetadata aBatchMeta = NextShapeUtils::NextBroadcastTo(
+            TensorMetadata(aBatch, TensorStrideDynamic(aMeta.GetStrides().begin(), aMeta.GetStrides().end() - 2), aMeta.GetOffset()), batchShape);
+        const TensorMetadata bBatchMeta = NextShapeUtils::NextBroadcastTo(
+            TensorMetadata(bBatch, TensorStrideDynamic(bMeta.GetStrides().begin(), bMeta.GetStrides().end() - 2), bMeta.GetOffset()), batchShape);
+        const TensorMetadata outBatchMeta(batchShape, TensorStrideDynamic(outMeta.GetStrides().begin(), outMeta.GetStrides().end() - 2), outMeta.GetOffset());
+
+        const TensorSize rsA = aMeta.GetStrides()[aRank - 2], csA = aMeta.GetStrides()[aRank - 1];
+        const TensorSize rsB = bMeta.GetStrides()[bRank - 2], csB = bMeta.GetStrides()[bRank - 1];
+        const TensorSize rsC = outMeta.GetStrides()[outRank - 2], csC = outMeta.GetStrides()[outRank - 1];
+
+        DispatchFloatType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            T *outData = static_cast<T *>(out);
+            const T *aData = static_cast<const T *>(a);
+            const T *bData = static_cast<const T *>(b);
+            const TensorIterator<3> batches(outBatchMeta, aBatchMeta, bBatchMeta);
+            auto runBatches = [&](const TensorIterator<3>::Offsets &offsets, const TensorIterator<3>::Strides &strides, TensorSize count) {
+                for (TensorSize i = 0; i < count; ++i) {
+                    const size_t outOffset = offsets[0] + i * strides[0];
+                    GemmEpilogue blockEpilogue;
+                    if (epilogue) {
+                        // Contiguous output: row r of this product starts at linear position base + r * N
+                        const size_t base = outOffset - outMeta.GetOffset();
+                        blockEpilogue = [&, base](size_t row, size_t col, size_t rows, size_t cols) {
+                            for (size_t r = row; r < row + rows; ++r) epilogue->Apply(base + r * N + col, base + r * N + col + cols);
+                        };
+                    }
+                    Gemm<T>(M, N, K, aData + offsets[1] + i * strides[1], rsA, csA, bData + offsets[2] + i * strides[2], rsB, csB,
+                            outData + outOffset, rsC, csC, false, context, epilogue ? &blockEpilogue : nullptr);
+                }
+            };
+
+            // Many small products: spread whole matrices over the threads; otherwise every product is parallel itself
+            const TensorSize numBatches = batches.GetTotalSize();
+            if (numBatches > 1 && M * N * K < Detail::GemmMinParallelWork * context.GetNumThreads()) {
+                const size_t grain = std::max<size_t>(1, Detail::GemmMinParallelWork / std::max<size_t>(1, M * N * K));
+                context.ParallelFor(0, numBatches, grain, [&](size_t begin, size_t end) {
+                    batches.ForEachRange(begin, end, runBatches);
+                });
+            } else {
+                batches.ForEach(runBatches);
+            }
+        });
+    }
+
+    /**
+     * @brief Matrix product out = a @ b on tensors. See the raw-pointer overload.
+     * @throws std::invalid_argument if the data types differ, or see the raw-pointer overload.
+     * **/
+    inline void MatMul(const TensorInterface &a, const TensorInterface &b, TensorInterface &out,
+                       NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext(), const Epilogue *epilogue = nullptr) {
+        if (a.GetDataType() != out.GetDataType() || b.GetDataType() != out.GetDataType()) {
+            throw std::invalid_argument("MatMul operands must have the same data type as the output.");
+        }
+        MatMul(out.GetDataType(), out.GetRawData(), out.GetMetadata(), a.GetRawData(), a.GetMetadata(), b.GetRawData(), b.GetMetadata(), context, epilogue);
+    }
+}
@@ -0,0 +1,354 @@
+#pragma once
+
+#include "Fused.hpp"
+#include <algorithm> // std::min, std::max, std::copy
+#include <limits>    // std::numeric_limits
+#include <vector>    // std::vector
+
+namespace NextKernels
+{
+    /**
+     * @brief Window, stride and padding of a 2D pooling.
+     * Padded positions are ignored: they never win the max and are not counted in the average.
+     * **/
+    struct Pool2DParams {
+        size_t kernelH = 1, kernelW = 1; // Window
+        size_t strideH = 1, strideW = 1; // Window step
+        size_t padH = 0, padW = 0;       // Padding on both sides (smaller than the window)
+    };
+
+    namespace Detail
+    {
+        constexpr size_t PoolGrain = size_t(1) << 15;  // Elements of work below which a loop is not split
+        constexpr size_t PoolChannelBlock = 512;       // Channels reduced together by the channels-last global pool
+
+        template <OpType Op, typename V>
+        NEXT_ALWAYS_INLINE void PoolCombine(V &acc, const V &x) noexcept {
+            if constexpr (Op == OpType::MAXPOOL) acc = x > acc ? x : acc;
+            else acc += x;
+        }
+
+        /**
+         * @brief acc[i] = max(acc[i], x[i]) or acc[i] += x[i] (Bytes is the vector width, 0 = scalar only).
+         * **/
+        template <size_t Bytes, typename T, OpType Op>
+        NEXT_ALWAYS_INLINE void PoolAccumulateBody(T *acc, const T *x, size_t n) noexcept {
+            size_t i = 0;
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+            if constexpr (Bytes >= 2 * sizeof(T)) {
+                using V = Vector<T, Bytes>;
+                constexpr size_t Lanes = Bytes / sizeof(T);
+                for (; i + Lanes <= n; i += Lanes) {
+                    V a, b;
+                    LoadVector(a, acc + i);
+                    LoadVector(b, x + i);
+                    PoolCombine<Op>(a, b);
+                    StoreVector(acc + i, a);
+                }
+            }
+#endif
+            for (; i < n; ++i) PoolCombine<Op>(acc[i], x[i]);
+        }
+
+        /**
+         * @brief Max or sum of a contiguous array (Bytes is the vector width, 0 = scalar only).
+         * **/
+        template <size_t Bytes, typename T, OpType Op>
+        NEXT_ALWAYS_INLINE T PoolReduceBody(const T *x, size_t n) noexcept {
+            T result = Op == OpType::MAXPOOL ? -std::numeric_limits<T>::infinity() : T(0);
+            size_t i = 0;
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+            if constexpr (Bytes >= 2 * sizeof(T)) {
+                using V = Vector<T, Bytes>;
+                constexpr size_t Lanes = Bytes / sizeof(T);
+                if (n >= Lanes) {
+                    V acc;
+                    BroadcastVector(acc, result);
+                    for (; i + Lanes <= n; i += Lanes) {
+                        V v;
+                        LoadVector(v, x + i);
+                        PoolCombine<Op>(acc, v);
+                    }
+                    T lanes[Lanes];
+                    StoreVector(lanes, acc);
+                    for (size_t l = 0; l < Lanes; ++l) PoolCombine<Op>(result, lanes[l]);
+                }
+            }
+#endif
+            for (; i < n; ++i) PoolCombine<Op>(result, x[i]);
+            return result;
+        }
+
+        template <typename T, OpType Op>
+        NEXT_TARGET_AVX512 void PoolAccumulateAvx512(T *acc, const T *x, size_t n) noexcept { PoolAccumulateBody<64, T, Op>(acc, x, n); }
+
+        template <typename T, OpType Op>
+        NEXT_TARGET_AVX2 void PoolAccumulateAvx2(T *acc, const T *x, size_t n) noexcept { PoolAccumulateBody<32, T, Op>(acc, x, n); }
+
+        template <typename T, OpType Op>
+        NEXT_TARGET_SSE2 void PoolAccumulateSse2(T *acc, const T *x, size_t n) noexcept { PoolAccumulateBody<16, T, Op>(acc, x, n); }
+
+        template <typename T, OpType Op>
+        NEXT_TARGET_AVX512 T PoolReduceAvx512(const T *x, size_t n) noexcept { return PoolReduceBody<64, T, Op>(x, n); }
+
+        template <typename T, OpType Op>
+        NEXT_TARGET_AVX2 T PoolReduceAvx2(const T *x, size_t n) noexcept { return PoolReduceBody<32, T, Op>(x, n); }
+
+        template <typename T, OpType Op>
+        NEXT_TARGET_SSE2 T PoolReduceSse2(const T *x, size_t n) noexcept { return PoolReduceBody<16, T, Op>(x, n); }
+
+        /**
+         * @brief Runs the unit-stride max/sum accumulation compiled for the active ISA level.
+         * **/
+        template <typename T, OpType Op>
+        void PoolAccumulate(T *acc, const T *x, size_t n) noexcept {
+            switch (GetIsaLevel()) {
+                case IsaLevel::AVX512: PoolAccumulateAvx512<T, Op>(acc, x, n); break;
+                case IsaLevel::AVX2:   PoolAccumulateAvx2<T, Op>(acc, x, n); break;
+                case IsaLevel::SSE2:   PoolAccumulateSse2<T, Op>(acc, x, n); break;
+                default:               PoolAccumulateBody<0, T, Op>(acc, x, n); break;
+            }
+        }
+
+        /**
+         * @brief Runs the unit-stride max/sum reduction compiled for the active ISA level.
+         * **/
+        template <typename T, OpType Op>
+        T PoolReduce(const T *x, size_t n) noexcept {
+            switch (GetIsaLevel()) {
+                case IsaLevel::AVX512: return PoolReduceAvx512<T, Op>(x, n);
+                case IsaLevel::AVX2:   return PoolReduceAvx2<T, Op>(x, n);
+                case IsaLevel::SSE2:   return PoolReduceSse2<T, Op>(x, n);
+                default:               return PoolReduceBody<0, T, Op>(x, n);
+            }
+        }
+
+        /**
+         * @brief Typed operands of a pooling, with the sizes resolved.
+         * **/
+        template <typename T>
+        struct PoolOperands {
+            size_t n = 0, c = 0, h = 0, w = 0, oh = 0, ow = 0;
+            Pool2DParams params;
+            const T *in = nullptr; // Input origin (offset applied)
+            size_t inStrides[4] = {};
+            T *out = nullptr;      // Output origin (offset applied)
+            size_t outStrides[4] = {};
+
+            // Valid input range [first, last) of a window along one axis
+            [[nodiscard]] static std::pair<size_t, size_t> Window(size_t o, size_t stride, size_t pad, size_t kernel, size_t extent) noexcept {
+                const size_t start = o * stride;
+                const size_t first = start < pad ? 0 : start - pad;
+                const size_t last = std::min(start + kernel - pad, extent);
+                return {first, last};
+            }
+        };
+
+        /**
+         * @brief Channels-last pooling of output row (n, oy): every window combines whole channel vectors.
+         * acc holds C elements (used when the output channels are not contiguous).
+         * **/
+        template <typename T, OpType Op>
+        void PoolRowChannelsLast(const PoolOperands<T> &ops, size_t n, size_t oy, T *acc) {
+            const auto [y0, y1] = PoolOperands<T>::Window(oy, ops.params.strideH, ops.params.padH, ops.params.kernelH, ops.h);
+            for (size_t ox = 0; ox < ops.ow; ++ox) {
+                const auto [x0, x1] = PoolOperands<T>::Window(ox, ops.params.strideW, ops.params.padW, ops.params.kernelW, ops.w);
+                T *o = ops.out + n * ops.outStrides[0] + oy * ops.outStrides[2] + ox * ops.outStrides[3];
+                T *a = ops.outStrides[1] == 1 ? o : acc;
+                const T *base = ops.in + n * ops.inStrides[0];
+                std::copy(base + y0 * ops.inStrides[2] + x0 * ops.inStrides[3], base + y0 * ops.inStrides[2] + x0 * ops.inStrides[3] + ops.c, a);
+                for (size_t y = y0; y < y1; ++y) {
+                    for (size_t x = y == y0 ? x0 + 1 : x0; x < x1; ++x) PoolAccumulate<T, Op>(a, base + y * ops.inStrides[2] + x * ops.inStrides[3], ops.c);
+                }
+                if constexpr (Op == OpType::AVGPOOL) {
+                    const T scale = T(1) / static_cast<T>((y1 - y0) * (x1 - x0));
+                    for (size_t c = 0; c < ops.c; ++c) a[c] *= scale;
+                }
+                if (a != o) {
+                    for (size_t c = 0; c < ops.c; ++c) o[c * ops.outStrides[1]] = a[c];
+                }
+            }
+        }
+
+        /**
+         * @brief Planar (NCHW) pooling of output row (n, c, oy), separably: the window rows are combined into one row
+         * (vectorized along the width when the input rows are contiguous), then every output reduces its columns.
+         * row holds W elements.
+         * **/
+        template <typename T, OpType Op>
+        void PoolRowPlanar(const PoolOperands<T> &ops, size_t n, size_t c, size_t oy, T *row) {
+            const auto [y0, y1] = PoolOperands<T>::Window(oy, ops.params.strideH, ops.params.padH, ops.params.kernelH, ops.h);
+            const T *plane = ops.in + n * ops.inStrides[0] + c * ops.inStrides[1];
+            const size_t xs = ops.inStrides[3];
+            for (size_t y = y0; y < y1; ++y) {
+                const T *src = plane + y * ops.inStrides[2];
+                if (y == y0) {
+                    for (size_t x = 0; x < ops.w; ++x) row[x] = src[x * xs];
+                } else if (xs == 1) {
+                    PoolAccumulate<T, Op>(row, src, ops.w);
+                } else {
+                    for (size_t x = 0; x < ops.w; ++x) PoolCombine<Op>(row[x], src[x * xs]);
+                }
+            }
+            T *o = ops.out + n * ops.outStrides[0] + c * ops.outStrides[1] + oy * ops.outStrides[2];
+            for (size_t ox = 0; ox < ops.ow; ++ox) {
+                const auto [x0, x1] = PoolOperands<T>::Window(ox, ops.params.strideW, ops.params.padW, ops.params.kernelW, ops.w);
+                T value = row[x0];
+                for (size_t x = x0 + 1; x < x1; ++x) PoolCombine<Op>(value, row[x]);
+                if constexpr (Op == OpType::AVGPOOL) value /= static_cast<T>((y1 - y0) * (x1 - x0));
+                o[ox * ops.outStrides[3]] = value;
+            }
+        }
+
+        /**
+         * @brief Global pooling (one window covering the whole unpadded input) in a single streaming pass.
+         * Contiguous planes reduce as one run per (n, c); channels-last inputs accumulate pixel after pixel into
+         * blocks of channels. Other layouts return false and take the windowed path.
+         * **/
+        template <typename T, OpType Op>
+        bool PoolGlobal(const PoolOperands<T> &ops, NextExecution::ExecutionContext &context) {
+            const size_t pixels = ops.h * ops.w;
+            const T scale = T(1) / static_cast<T>(pixels);
+            if (ops.inStrides[3] == 1 && ops.inStrides[2] == ops.w) {
+                context.ParallelFor(0, ops.n * ops.c, std::max<size_t>(1, PoolGrain / pixels), [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        const size_t n = i / ops.c, c = i % ops.c;
+                        T value = PoolReduce<T, Op>(ops.in + n * ops.inStrides[0] + c * ops.inStrides[1], pixels);
+                        if constexpr (Op == OpType::AVGPOOL) value *= scale;
+                        ops.out[n * ops.outStrides[0] + c * ops.outStrides[1]] = value;
+                    }
+                });
+                return true;
+            }
+            if (ops.inStrides[1] == 1 && ops.inStrides[2] == ops.w * ops.inStrides[3]) {
+                const size_t blocks = (ops.c + PoolChannelBlock - 1) / PoolChannelBlock;
+                context.ParallelFor(0, ops.n * blocks, std::max<size_t>(1, PoolGrain / (pixels * std::min(ops.c, PoolChannelBlock))), [&](size_t begin, size_t end) {
+                    T acc[PoolChannelBlock];
+                    for (size_t i = begin; i < end; ++i) {
+                        const size_t n = i / blocks, c0 = i % blocks * PoolChannelBlock, width = std::min(PoolChannelBlock, ops.c - c0);
+                        const T *base = ops.in + n * ops.inStrides[0] + c0;
+                        std::copy(base, base + width, acc);
+                        for (size_t p = 1; p < pixels; ++p) PoolAccumulate<T, Op>(acc, base + p * ops.inStrides[3], width);
+                        for (size_t c = 0; c < width; ++c) {
+                            ops.out[n * ops.outStrides[0] + (c0 + c) * ops.outStrides[1]] = Op == OpType::AVGPOOL ? acc[c] * scale : acc[c];
+                        }
+                    }
+                });
+                return true;
+            }
+            return false;
+        }
+    }
+
+    /**
+     * @brief 2D max or average pooling of an NCHW input; padded positions are ignored (never the max, not counted
+     * in the average).
+     * Operands may be strided views, so a channels-last (NHWC) tensor is accepted as the NCHW view of its buffer:
+     * - channels-last inputs (unit channel stride) combine whole channel vectors per window position;
+     * - planar inputs pool separably, combining the window rows vectorized along the width, then the columns;
+     * - a window covering the whole unpadded input (global pooling) reduces the spatial dimensions in one pass.
+     * @param op MAXPOOL or AVGPOOL.
+     * @param dtype The data type of both tensors (FLOAT32 or FLOAT64).
+     * @param out Start of the output buffer.
+     * @param outMeta Metadata of the output [N, C, OH, OW].
+     * @param in Start of the input buffer.
+     * @param inMeta Metadata of the input [N, C, H, W].
+     * @param params Window, strides and padding.
+     * @param context The execution context the rows are split over.
+     * @param epilogue Optional elementwise steps applied to the output once computed (requires a contiguous output).
+     * @throws std::invalid_argument if the operation is not a pooling, the shapes do not match, the window or padding
+     * is invalid, the data type is not floating point, an epilogue is given with a non-contiguous output or a tensor is
+     * channel-blocked (see Reorder; the graph runs blocked pools through this kernel on a channels-last view).
+     * **/
+    inline void Pool2D(OpType op, DataType dtype, void *out, const TensorMetadata &outMeta, const void *in, const TensorMetadata &inMeta,
+                       const Pool2DParams &params, NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext(),
+                       const Epilogue *epilogue = nullptr) {
+        if (op != OpType::MAXPOOL && op != OpType::AVGPOOL) {
+            throw std::invalid_argument("Pool2D supports MAXPOOL and AVGPOOL only.");
+        }
+        NextMetadata::CheckStridedLayout(outMeta, "Pool2D");
+        NextMetadata::CheckStridedLayout(inMeta, "Pool2D");
+        if (inMeta.GetRank() != 4) {
+            throw std::invalid_argument("Pool2D requires an input [N, C, H, W].");
+        }
+        if (params.kernelH == 0 || params.kernelW == 0 || params.strideH == 0 || params.strideW == 0 ||
+            params.padH >= params.kernelH || params.padW >= params.kernelW) {
+            throw std::invalid_argument("Pool2D requires a non-empty window, positive strides and padding smaller than the window.");
+        }
+        const TensorShapeDynamic &x = inMeta.GetShape();
+        if (x[2] + 2 * params.padH < params.kernelH || x[3] + 2 * params.padW < params.kernelW) {
+            throw std::invalid_argument("Pool2D window is larger than the padded input.");
+        }
+        const size_t oh = (x[2] + 2 * params.padH - params.kernelH) / params.strideH + 1;
+        const size_t ow = (x[3] + 2 * params.padW - params.kernelW) / params.strideW + 1;
+        if (outMeta.GetShape() != TensorShapeDynamic{x[0], x[1], oh, ow}) {
+            throw std::invalid_argument("Pool2D output shape does not match the input.");
+        }
+        if (epilogue && epilogue->IsEmpty()) epilogue = nullptr;
+        if (epilogue && !outMeta.IsContiguous()) {
+            throw std::invalid_argument("Pool2D epilogues require a contiguous output.");
+        }
+        if (outMeta.GetTotalSize() == 0) return;
+
+        DispatchFloatType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            Detail::PoolOperands<T> ops;
+            ops.n = x[0]; ops.c = x[1]; ops.h = x[2]; ops.w = x[3]; ops.oh = oh; ops.ow = ow;
+            ops.params = params;
+            ops.in = static_cast<const T *>(in) + inMeta.GetOffset();
+            ops.out = static_cast<T *>(out) + outMeta.GetOffset();
+            for (size_t d = 0; d < 4; ++d) {
+                ops.inStrides[d] = inMeta.GetStrides()[d];
+                ops.outStrides[d] = outMeta.GetStrides()[d];
+            }
+            const size_t window = params.kernelH * params.kernelW;
+            const bool global = params.kernelH == ops.h && params.kernelW == ops.w && params.padH == 0 && params.padW == 0;
+
+            auto run = [&](auto opTag) {
+                constexpr OpType Op = decltype(opTag)::value;
+                if (global && Detail::PoolGlobal<T, Op>(ops, context)) return;
+                if (ops.inStrides[1] == 1 && ops.c > 1) {
+                    const size_t grain = std::max<size_t>(1, Detail::PoolGrain / std::max<size_t>(1, ow * ops.c * window));
+                    context.ParallelFor(0, ops.n * oh, grain, [&](size_t begin, size_t end) {
+                        std::vector<T> acc(ops.outStrides[1] == 1 ? 0 : ops.c);
+                        for (size_t r = begin; r < end; ++r) Detail::PoolRowChannelsLast<T, Op>(ops, r / oh, r % oh, acc.data());
+                    });
+                } else {
+                    const size_t grain = std::max<size_t>(1, Detail::PoolGrain / std::max<size_t>(1, ops.w * params.kernelH + ow * params.kernelW));
+                    context.ParallelFor(0, ops.n * ops.c * oh, grain, [&](size_t begin, size_t end) {
+                        std::vector<T> row(ops.w);
+                        for (size_t r = begin; r < end; ++r) Detail::PoolRowPlanar<T, Op>(ops, r / (ops.c * oh), r / oh % ops.c, r % oh, row.data());
+                    });
+                }
+            };
+            if (op == OpType::MAXPOOL) run(std::integral_constant<OpType, OpType::MAXPOOL>{});
+            else run(std::integral_constant<OpType, OpType::AVGPOOL>{});
+        });
+
+        if (epilogue) {
+            context.ParallelFor(0, outMeta.GetTotalSize(), Detail::ElementwiseGrain, [&](size_t begin, size_t end) { epilogue->Apply(begin, end); });
+        }
+    }
+
+    /**
+     * @brief 2D max or average pooling on tensors. See the raw-pointer overload.
+     * @throws std::invalid_argument if the data types differ, or see the raw-pointer overload.
+     * **/
+    inline void Pool2D(OpType op, const TensorInterface &in, TensorInterface &out, const Pool2DParams &params,
+                       NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        if (in.GetDataType() != out.GetDataType()) {
+            throw std::invalid_argument("Pool2D input must have the same data type as the output.");
+        }
+        Pool2D(op, out.GetDataType(), out.GetRawData(), out.GetMetadata(), in.GetRawData(), in.GetMetadata(), params, context);
+    }
+
+    /**
+     * @brief out = max over every window of in. See Pool2D.
+     * **/
+    inline void MaxPool2D(const TensorInterface &in, TensorInterface &out, const Pool2DParams &params) { Pool2D(OpType::MAXPOOL, in, out, params); }
+
+    /**
+     * @brief out = mean over every window of in (padding excluded). See Pool2D.
+     * **/
+    inline void AvgPool2D(const TensorInterface &in, TensorInterface &out, const Pool2DParams &params) { Pool2D(OpType::AVGPOOL, in, out, params); }
+}
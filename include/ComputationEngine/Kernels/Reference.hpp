@@ -0,0 +1,289 @@
+#pragma once
+
+#include "Dispatch.hpp"
+#include "Fused.hpp"
+#include "../../Core/TensorInterface.hpp"
+#include "../../Utils/NextShapeUtils.hpp"
+#include <algorithm> // std::max
+#include <cmath>     // std::exp, std::tanh
+#include <limits>    // std::numeric_limits
+#include <vector>    // std::vector
+
+/**
+ * Reference kernels: plain scalar loops written for obviously correct results, not speed.
+ * Every element is addressed through its multi-index and the metadata strides, floating point sums accumulate
+ * in double, and nothing is vectorized or threaded. They back the reference engine, which validates the
+ * numerics of the optimized kernels and runs operations no optimized kernel covers.
+ * **/
+namespace NextKernels::Reference
+{
+    namespace Detail
+    {
+        // Offset of index i along dimension d (channel-blocked layouts split the channel index into block and lane)
+        inline size_t DimensionOffset(const TensorMetadata &meta, size_t d, size_t i) noexcept {
+            const size_t block = meta.GetChannelBlock();
+            if (block != 0 && d == 1) return i / block * meta.GetBlockStride() + i % block;
+            return i * meta.GetStrides()[d];
+        }
+
+        /**
+         * @brief Element offset of the row-major linear position of a tensor (offset included), in any layout.
+         * **/
+        inline size_t OffsetOf(const TensorMetadata &meta, size_t linear) noexcept {
+            const TensorShapeDynamic &shape = meta.GetShape();
+            size_t offset = meta.GetOffset();
+            for (size_t d = shape.size(); d-- > 0;) {
+                offset += DimensionOffset(meta, d, linear % shape[d]);
+                linear /= shape[d];
+            }
+            return offset;
+        }
+
+        // Element offset of a rank-4 multi-index, in any layout
+        inline size_t OffsetOf4(const TensorMetadata &meta, size_t i0, size_t i1, size_t i2, size_t i3) noexcept {
+            const TensorStrideDynamic &strides = meta.GetStrides();
+            return meta.GetOffset() + i0 * strides[0] + DimensionOffset(meta, 1, i1) + i2 * strides[2] + i3 * strides[3];
+        }
+
+        template <typename T>
+        T ApplyBinary(OpType op, T a, T b) noexcept {
+            if constexpr (std::is_same_v<T, bool>) {
+                return op == OpType::ADD ? (a || b) : (a && b);
+            } else {
+                switch (op) {
+                    case OpType::ADD: return static_cast<T>(a + b);
+                    case OpType::SUB: return static_cast<T>(a - b);
+                    case OpType::MUL: return static_cast<T>(a * b);
+                    default:          return static_cast<T>(a / b);
+                }
+            }
+        }
+
+        template <typename T>
+        T ApplyActivation(OpType op, T x) noexcept {
+            const double value = static_cast<double>(x);
+            switch (op) {
+                case OpType::RELU:    return x > T(0) ? x : T(0);
+                case OpType::SIGMOID: return static_cast<T>(1.0 / (1.0 + std::exp(-value)));
+                default:              return static_cast<T>(std::tanh(value));
+            }
+        }
+    }
+
+    /**
+     * @brief out = a <op> b with broadcasting (ADD, SUB, MUL, DIV; BOOL: ADD = or, MUL = and).
+     * @throws std::invalid_argument if the output shape is not the broadcast shape of the operands.
+     * **/
+    inline void Binary(OpType op, DataType dtype, void *out, const TensorMetadata &outMeta,
+                       const void *a, const TensorMetadata &aMeta, const void *b, const TensorMetadata &bMeta) {
+        if (NextShapeUtils::NextBroadcastShape(aMeta.GetShape(), bMeta.GetShape()) != outMeta.GetShape()) {
+            throw std::invalid_argument("Elementwise output shape must be the broadcast shape of the operands.");
+        }
+        // Operands of the output shape are read as they are (they may be channel-blocked)
+        const TensorMetadata aExpanded = aMeta.GetShape() == outMeta.GetShape() ? aMeta : NextShapeUtils::NextBroadcastTo(aMeta, outMeta.GetShape());
+        const TensorMetadata bExpanded = bMeta.GetShape() == outMeta.GetShape() ? bMeta : NextShapeUtils::NextBroadcastTo(bMeta, outMeta.GetShape());
+        DispatchDataType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            for (size_t i = 0; i < outMeta.GetTotalSize(); ++i) {
+                static_cast<T *>(out)[Detail::OffsetOf(outMeta, i)] =
+                    Detail::ApplyBinary<T>(op, static_cast<const T *>(a)[Detail::OffsetOf(aExpanded, i)], static_cast<const T *>(b)[Detail::OffsetOf(bExpanded, i)]);
+            }
+        });
+    }
+
+    /**
+     * @brief out = op(in) for RELU, SIGMOID and TANH.
+     * **/
+    inline void Unary(OpType op, DataType dtype, void *out, const TensorMetadata &outMeta, const void *in, const TensorMetadata &inMeta) {
+        if (outMeta.GetShape() != inMeta.GetShape()) {
+            throw std::invalid_argument("Activation output shape must match the input.");
+        }
+        DispatchFloatType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            for (size_t i = 0; i < outMeta.GetTotalSize(); ++i) {
+                static_cast<T *>(out)[Detail::OffsetOf(outMeta, i)] = Detail::ApplyActivation<T>(op, static_cast<const T *>(in)[Detail::OffsetOf(inMeta, i)]);
+            }
+        });
+    }
+
+    /**
+     * @brief Copies in into out element by element in row-major order; the shapes may differ if the sizes match (RESHAPE)
+     * and the layouts may differ (REORDER).
+     * **/
+    inline void CopyElements(DataType dtype, void *out, const TensorMetadata &outMeta, const void *in, const TensorMetadata &inMeta) {
+        if (outMeta.GetTotalSize() != inMeta.GetTotalSize()) {
+            throw std::invalid_argument("Copy requires tensors of the same size.");
+        }
+        DispatchDataType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            for (size_t i = 0; i < outMeta.GetTotalSize(); ++i) {
+                static_cast<T *>(out)[Detail::OffsetOf(outMeta, i)] = static_cast<const T *>(in)[Detail::OffsetOf(inMeta, i)];
+            }
+        });
+    }
+
+    /**
+     * @brief out = a @ b with broadcast batch dimensions ([.., M, K] x [.., K, N] -> [.., M, N]).
+     * **/
+    inline void MatMul(DataType dtype, void *out, const TensorMetadata &outMeta,
+                       const void *a, const TensorMetadata &aMeta, const void *b, const TensorMetadata &bMeta) {
+        const TensorRank aRank = aMeta.GetRank(), bRank = bMeta.GetRank(), outRank = outMeta.GetRank();
+        if (aRank < 2 || bRank < 2 || outRank < 2 || aMeta.GetShape()[aRank - 1] != bMeta.GetShape()[bRank - 2]) {
+            throw std::invalid_argument("MatMul shapes are incompatible.");
+        }
+        const size_t M = outMeta.GetShape()[outRank - 2], N = outMeta.GetShape()[outRank - 1], K = aMeta.GetShape()[aRank - 1];
+        // Operands broadcast to [.., M, K] and [.., K, N] with the batch dimensions of the output
+        TensorShapeDynamic aShape(outMeta.GetShape().begin(), outMeta.GetShape().end() - 2);
+        TensorShapeDynamic bShape = aShape;
+        aShape.push_back(M); aShape.push_back(K);
+        bShape.push_back(K); bShape.push_back(N);
+        const TensorMetadata aExpanded = NextShapeUtils::NextBroadcastTo(aMeta, aShape);
+        const TensorMetadata bExpanded = NextShapeUtils::NextBroadcastTo(bMeta, bShape);
+        DispatchFloatType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            const size_t batches = outMeta.GetTotalSize() / std::max<size_t>(1, M * N);
+            for (size_t batch = 0; batch < batches; ++batch) {
+                for (size_t i = 0; i < M; ++i) {
+                    for (size_t j = 0; j < N; ++j) {
+                        double sum = 0.0;
+                        for (size_t p = 0; p < K; ++p) {
+                            sum += static_cast<double>(static_cast<const T *>(a)[Detail::OffsetOf(aExpanded, (batch * M + i) * K + p)]) *
+                                   static_cast<double>(static_cast<const T *>(b)[Detail::OffsetOf(bExpanded, (batch * K + p) * N + j)]);
+                        }
+                        static_cast<T *>(out)[Detail::OffsetOf(outMeta, (batch * M + i) * N + j)] = static_cast<T>(sum);
+                    }
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief out = softmax(in) along an axis (already resolved to [0, rank)).
+     * **/
+    inline void Softmax(DataType dtype, void *out, const TensorMetadata &outMeta, const void *in, const TensorMetadata &inMeta, size_t axis) {
+        const TensorShapeDynamic &shape = inMeta.GetShape();
+        size_t outer = 1, inner = 1;
+        for (size_t d = 0; d < axis; ++d) outer *= shape[d];
+        for (size_t d = axis + 1; d < shape.size(); ++d) inner *= shape[d];
+        const size_t extent = shape[axis];
+        DispatchFloatType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            for (size_t o = 0; o < outer; ++o) {
+                for (size_t i = 0; i < inner; ++i) {
+                    auto linear = [&](size_t k) { return (o * extent + k) * inner + i; };
+                    double max = -std::numeric_limits<double>::infinity();
+                    for (size_t k = 0; k < extent; ++k) max = std::max(max, static_cast<double>(static_cast<const T *>(in)[Detail::OffsetOf(inMeta, linear(k))]));
+                    double sum = 0.0;
+                    for (size_t k = 0; k < extent; ++k) sum += std::exp(static_cast<double>(static_cast<const T *>(in)[Detail::OffsetOf(inMeta, linear(k))]) - max);
+                    for (size_t k = 0; k < extent; ++k) {
+                        const double x = static_cast<double>(static_cast<const T *>(in)[Detail::OffsetOf(inMeta, linear(k))]);
+                        static_cast<T *>(out)[Detail::OffsetOf(outMeta, linear(k))] = static_cast<T>(std::exp(x - max) / sum);
+                    }
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Direct NCHW convolution: out[n, o, y, x] = bias[o] + sum over (c, ky, kx) of in[n, g * C / groups + c, y * sh - ph + ky, x * sw - pw + kx] * w[o, c, ky, kx]
+     * with g = o / (O / groups). Positions in the zero padding contribute nothing.
+     * @param bias Bias buffer of shape [O], or nullptr.
+     * **/
+    inline void Conv2D(DataType dtype, void *out, const TensorMetadata &outMeta, const void *in, const TensorMetadata &inMeta,
+                       const void *weight, const TensorMetadata &weightMeta, const void *bias, const TensorMetadata *biasMeta,
+                       size_t sh, size_t sw, size_t ph, size_t pw, size_t groups = 1) {
+        const TensorShapeDynamic &x = inMeta.GetShape(), &w = weightMeta.GetShape(), &y = outMeta.GetShape();
+        DispatchFloatType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            const T *inData = static_cast<const T *>(in);
+            const T *weightData = static_cast<const T *>(weight);
+            for (size_t n = 0; n < y[0]; ++n) {
+                for (size_t o = 0; o < y[1]; ++o) {
+                    const size_t firstChannel = o / (y[1] / groups) * w[1];
+                    const double initial = bias ? static_cast<double>(static_cast<const T *>(bias)[biasMeta->GetOffset() + o * biasMeta->GetStrides()[0]]) : 0.0;
+                    for (size_t oy = 0; oy < y[2]; ++oy) {
+                        for (size_t ox = 0; ox < y[3]; ++ox) {
+                            double sum = initial;
+                            for (size_t c = 0; c < w[1]; ++c) {
+                                for (size_t ky = 0; ky < w[2]; ++ky) {
+                                    const size_t iy = oy * sh + ky;
+                                    if (iy < ph || iy - ph >= x[2]) continue;
+                                    for (size_t kx = 0; kx < w[3]; ++kx) {
+                                        const size_t ix = ox * sw + kx;
+                                        if (ix < pw || ix - pw >= x[3]) continue;
+                                        sum += static_cast<double>(inData[Detail::OffsetOf4(inMeta, n, firstChannel + c, iy - ph, ix - pw)]) *
+                                               static_cast<double>(weightData[Detail::OffsetOf4(weightMeta, o, c, ky, kx)]);
+                                    }
+                                }
+                            }
+                            static_cast<T *>(out)[Detail::OffsetOf4(outMeta, n, o, oy, ox)] = static_cast<T>(sum);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief NCHW max or average pooling over kh x kw windows.
+     * Padded positions are ignored: they never win the max and are not counted in the average.
+     * **/
+    inline void Pool2D(OpType op, DataType dtype, void *out, const TensorMetadata &outMeta, const void *in, const TensorMetadata &inMeta,
+                       size_t kh, size_t kw, size_t sh, size_t sw, size_t ph, size_t pw) {
+        const TensorShapeDynamic &x = inMeta.GetShape(), &y = outMeta.GetShape();
+        DispatchFloatType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            const T *inData = static_cast<const T *>(in);
+            for (size_t n = 0; n < y[0]; ++n) {
+                for (size_t c = 0; c < y[1]; ++c) {
+                    for (size_t oy = 0; oy < y[2]; ++oy) {
+                        for (size_t ox = 0; ox < y[3]; ++ox) {
+                            double max = -std::numeric_limits<double>::infinity(), sum = 0.0;
+                            size_t count = 0;
+                            for (size_t ky = 0; ky < kh; ++ky) {
+                                const size_t iy = oy * sh + ky;
+                                if (iy < ph || iy - ph >= x[2]) continue;
+                                for (size_t kx = 0; kx < kw; ++kx) {
+                                    const size_t ix = ox * sw + kx;
+                                    if (ix < pw || ix - pw >= x[3]) continue;
+                                    const double value = static_cast<double>(inData[Detail::OffsetOf4(inMeta, n, c, iy - ph, ix - pw)]);
+                                    max = std::max(max, value);
+                                    sum += value;
+                                    ++count;
+                                }
+                            }
+                            static_cast<T *>(out)[Detail::OffsetOf4(outMeta, n, c, oy, ox)] =
+                                static_cast<T>(op == OpType::MAXPOOL ? max : sum / static_cast<double>(std::max<size_t>(count, 1)));
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Applies epilogue steps to out, one element at a time.
+     * **/
+    inline void ApplyEpilogue(DataType dtype, void *out, const TensorMetadata &outMeta, const std::vector<EpilogueOperation> &operations) {
+        std::vector<TensorMetadata> operandMetas;
+        for (const EpilogueOperation &operation : operations) {
+            const bool expand = operation.operand && operation.operandMeta.GetShape() != outMeta.GetShape();
+            operandMetas.push_back(expand ? NextShapeUtils::NextBroadcastTo(operation.operandMeta, outMeta.GetShape()) : operation.operandMeta);
+        }
+        DispatchFloatType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            for (size_t i = 0; i < outMeta.GetTotalSize(); ++i) {
+                T &x = static_cast<T *>(out)[Detail::OffsetOf(outMeta, i)];
+                for (size_t step = 0; step < operations.size(); ++step) {
+                    const EpilogueOperation &operation = operations[step];
+                    if (!operation.operand) {
+                        x = Detail::ApplyActivation<T>(operation.op, x);
+                        continue;
+                    }
+                    const T y = static_cast<const T *>(operation.operand)[Detail::OffsetOf(operandMetas[step], i)];
+                    x = operation.operandOnLeft ? Detail::ApplyBinary<T>(operation.op, y, x) : Detail::ApplyBinary<T>(operation.op, x, y);
+                }
+            }
+        });
+    }
+}
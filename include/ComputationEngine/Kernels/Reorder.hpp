@@ -0,0 +1,171 @@
+#pragma once
+
+#include "Copy.hpp"
+#include <algorithm> // std::min, std::max, std::fill
+#include <cstring>   // std::memcpy
+
+namespace NextKernels
+{
+    namespace Detail
+    {
+        /**
+         * @brief A tensor [N, C, spatial...] seen as (n, c, s) with its spatial dimensions flattened.
+         * Blocked: offset + n * nStride + c / block * blockStride + c % block + s * block.
+         * Plain:   offset + n * nStride + c * cStride + s * sStride.
+         * **/
+        struct ChannelView {
+            size_t n = 0, c = 0, s = 1; // Batch, channels, spatial positions
+            size_t block = 0;           // Channel block (0 = plain)
+            size_t nStride = 0, cStride = 0, sStride = 0, blockStride = 0;
+            size_t offset = 0;
+        };
+
+        /**
+         * @brief Describes a tensor of rank >= 2 as a ChannelView.
+         * @return False if the spatial dimensions of a plain tensor cannot be flattened into a single stride.
+         * **/
+        inline bool GetChannelView(const TensorMetadata &meta, ChannelView &view) {
+            const TensorShapeDynamic &shape = meta.GetShape();
+            const TensorStrideDynamic &strides = meta.GetStrides();
+            view.n = shape[0];
+            view.c = shape[1];
+            view.block = meta.GetChannelBlock();
+            view.nStride = strides[0];
+            view.cStride = strides[1];
+            view.blockStride = meta.GetBlockStride();
+            view.offset = meta.GetOffset();
+            view.s = 1;
+            view.sStride = view.block != 0 ? view.block : 1;
+            size_t expected = 0; // Stride the next outer spatial dimension needs to merge (0 = none seen yet)
+            for (size_t d = shape.size(); d-- > 2;) {
+                if (shape[d] == 1) continue;
+                if (expected == 0) view.sStride = strides[d];
+                else if (strides[d] != expected) return false;
+                expected = strides[d] * shape[d];
+                view.s *= shape[d];
+            }
+            return true;
+        }
+
+        /**
+         * @brief Moves channel block cb of batch n between a plain and a blocked tensor (either direction).
+         * Planar plain tensors (unit spatial stride) go through tiled transposes, channels-last ones through
+         * block-wide copies. The channel padding of a blocked destination is zero-filled.
+         * **/
+        template <typename U>
+        void ReorderChannelBlock(const ChannelView &dst, U *out, const ChannelView &src, const U *in, size_t n, size_t cb) noexcept {
+            const bool toBlocked = dst.block != 0;
+            const ChannelView &blocked = toBlocked ? dst : src;
+            const ChannelView &plain = toBlocked ? src : dst;
+            const size_t b = blocked.block, c0 = cb * b, valid = std::min(b, blocked.c - c0), spatial = blocked.s;
+            const size_t blockedStart = blocked.offset + n * blocked.nStride + cb * blocked.blockStride;
+            const size_t plainStart = plain.offset + n * plain.nStride + c0 * plain.cStride;
+            if (toBlocked) {
+                U *o = out + blockedStart;
+                const U *x = in + plainStart;
+                if (plain.sStride == 1) {
+                    TransposeRecursive(x, plain.cStride, o, b, valid, spatial);
+                } else if (plain.cStride == 1) {
+                    for (size_t s = 0; s < spatial; ++s) std::memcpy(o + s * b, x + s * plain.sStride, valid * sizeof(U));
+                } else {
+                    for (size_t s = 0; s < spatial; ++s) {
+                        for (size_t j = 0; j < valid; ++j) o[s * b + j] = x[j * plain.cStride + s * plain.sStride];
+                    }
+                }
+                if (valid < b) {
+                    for (size_t s = 0; s < spatial; ++s) std::fill(o + s * b + valid, o + (s + 1) * b, U(0));
+                }
+            } else {
+                U *o = out + plainStart;
+                const U *x = in + blockedStart;
+                if (plain.sStride == 1) {
+                    TransposeRecursive(x, b, o, plain.cStride, spatial, valid);
+                } else if (plain.cStride == 1) {
+                    for (size_t s = 0; s < spatial; ++s) std::memcpy(o + s * plain.sStride, x + s * b, valid * sizeof(U));
+                } else {
+                    for (size_t s = 0; s < spatial; ++s) {
+                        for (size_t j = 0; j < valid; ++j) o[j * plain.cStride + s * plain.sStride] = x[s * b + j];
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Element-by-element reorder between any layouts (used between two blocked layouts and for plain
+         * tensors whose spatial dimensions do not flatten). A blocked destination is zero-filled first.
+         * **/
+        template <typename U>
+        void ReorderElements(U *out, const TensorMetadata &outMeta, const U *in, const TensorMetadata &inMeta,
+                             NextExecution::ExecutionContext &context) {
+            if (outMeta.GetChannelBlock() != 0) {
+                std::fill(out + outMeta.GetOffset(), out + outMeta.GetOffset() + outMeta.GetStorageSize(), U(0));
+            }
+            const TensorShapeDynamic &shape = outMeta.GetShape();
+            context.ParallelFor(0, outMeta.GetTotalSize(), ElementwiseGrain, [&](size_t begin, size_t end) {
+                TensorIndexDynamic index(shape.size(), 0);
+                for (size_t i = begin; i < end; ++i) {
+                    size_t linear = i;
+                    for (size_t d = shape.size(); d-- > 0;) {
+                        index[d] = linear % shape[d];
+                        linear /= shape[d];
+                    }
+                    out[outMeta.GetElementOffset(index)] = in[inMeta.GetElementOffset(index)];
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief Copies a tensor into another memory layout (REORDER), e.g. NCHW -> nChw8c and back.
+     * Between a channel-blocked tensor and a plain one, every (batch, channel block) pair is moved at once: with
+     * tiled register transposes when the plain tensor is planar (NCHW), with block-wide copies when it is
+     * channels-last (NHWC). The channel padding of a blocked output is zero-filled. Plain to plain is a Copy.
+     * @param dtype The data type of both tensors.
+     * @param out Start of the output buffer.
+     * @param outMeta Metadata of the output (any layout).
+     * @param in Start of the input buffer.
+     * @param inMeta Metadata of the input (any layout).
+     * @param context The execution context the channel blocks are split over.
+     * @throws std::invalid_argument if the shapes differ or the data type is unknown.
+     * **/
+    inline void Reorder(DataType dtype, void *out, const TensorMetadata &outMeta, const void *in, const TensorMetadata &inMeta,
+                        NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        if (outMeta.GetShape() != inMeta.GetShape()) {
+            throw std::invalid_argument("Reorder requires tensors of the same shape.");
+        }
+        if (outMeta.GetChannelBlock() == 0 && inMeta.GetChannelBlock() == 0) {
+            Copy(dtype, out, outMeta, in, inMeta, context);
+            return;
+        }
+        if (outMeta.GetTotalSize() == 0) return;
+        DispatchDataType(dtype, [&](auto tag) {
+            using U = typename Detail::UnsignedOfSize<sizeof(typename decltype(tag)::type)>::type;
+            U *o = static_cast<U *>(out);
+            const U *x = static_cast<const U *>(in);
+            Detail::ChannelView dst, src;
+            if ((outMeta.GetChannelBlock() == 0) == (inMeta.GetChannelBlock() == 0) ||
+                !Detail::GetChannelView(outMeta, dst) || !Detail::GetChannelView(inMeta, src)) {
+                Detail::ReorderElements(o, outMeta, x, inMeta, context);
+                return;
+            }
+            const size_t block = std::max(dst.block, src.block);
+            const size_t blocks = (dst.c + block - 1) / block;
+            const size_t grain = std::max<size_t>(1, Detail::ElementwiseGrain / std::max<size_t>(1, dst.s * block));
+            context.ParallelFor(0, dst.n * blocks, grain, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) Detail::ReorderChannelBlock(dst, o, src, x, i / blocks, i % blocks);
+            });
+        });
+    }
+
+    /**
+     * @brief Copies a tensor into another of the same shape stored in another layout. See the raw-pointer overload.
+     * @throws std::invalid_argument if the data types differ, or see the raw-pointer overload.
+     * **/
+    inline void Reorder(const TensorInterface &in, TensorInterface &out,
+                        NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        if (in.GetDataType() != out.GetDataType()) {
+            throw std::invalid_argument("Reorder requires tensors of the same data type.");
+        }
+        Reorder(out.GetDataType(), out.GetRawData(), out.GetMetadata(), in.GetRawData(), in.GetMetadata(), context);
+    }
+}
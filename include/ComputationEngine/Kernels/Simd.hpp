@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef> // size_t
+#include <cstring> // std::memcpy
+#include <atomic>  // std::atomic
+
+/**
+ * SIMD support macros.
+ * Kernels are compiled for several instruction sets inside the same translation unit by tagging
+ * functions with a target attribute; the variant to run is chosen at runtime from CPUID (see GetIsaLevel).
+ * Vector code uses GCC/Clang vector extensions so one kernel body serves every ISA and every element type.
+ * Other compilers get the scalar kernels only.
+ * **/
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define NEXT_SIMD_X86 1
+    #define NEXT_TARGET_SSE2 __attribute__((target("sse2")))
+    #define NEXT_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #define NEXT_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,fma")))
+#else
+    #define NEXT_SIMD_X86 0
+    #define NEXT_TARGET_SSE2
+    #define NEXT_TARGET_AVX2
+    #define NEXT_TARGET_AVX512
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define NEXT_SIMD_VECTOR_EXTENSIONS 1
+    #define NEXT_ALWAYS_INLINE inline __attribute__((always_inline))
+    #define NEXT_UNROLL _Pragma("GCC unroll 32") // Fully unroll a short fixed-count loop (register tiles)
+#else
+    #define NEXT_SIMD_VECTOR_EXTENSIONS 0
+    #define NEXT_ALWAYS_INLINE inline
+    #define NEXT_UNROLL
+#endif
+
+// __builtin_shufflevector (constant lane permutations of vector extension types)
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 12)
+    #define NEXT_SIMD_SHUFFLE 1
+#else
+    #define NEXT_SIMD_SHUFFLE 0
+#endif
+
+#if NEXT_SIMD_X86
+    #include <immintrin.h> // FMA intrinsics used inside target-attributed kernels
+#endif
+
+namespace NextKernels
+{
+    /**
+     * @enum IsaLevel
+     * @brief Instruction set levels a kernel can be compiled for, in increasing order of capability.
+     * Values : SCALAR, SSE2, AVX2 (with FMA), AVX512 (F/BW/DQ/VL)
+     * **/
+    enum class IsaLevel {
+        SCALAR,
+        SSE2,
+        AVX2,
+        AVX512
+    };
+
+    /**
+     * @brief Returns the vector register width of an ISA level.
+     * @param level The ISA level.
+     * @return The register width in bytes (the element size for SCALAR is handled by the kernels).
+     * **/
+    [[nodiscard]] constexpr size_t GetVectorBytes(IsaLevel level) noexcept {
+        switch (level) {
+            case IsaLevel::AVX512: return 64;
+            case IsaLevel::AVX2:   return 32;
+            case IsaLevel::SSE2:   return 16;
+            default:               return 0;
+        }
+    }
+
+    /**
+     * @brief Detects the best ISA level supported by the CPU and the compiler.
+     * @return The detected IsaLevel.
+     * **/
+    [[nodiscard]] inline IsaLevel DetectIsaLevel() noexcept {
+#if NEXT_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+            __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) {
+            return IsaLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return IsaLevel::AVX2;
+        if (__builtin_cpu_supports("sse2")) return IsaLevel::SSE2;
+#endif
+        return IsaLevel::SCALAR;
+    }
+
+    /**
+     * @brief Returns the ISA level detected at first use (CPUID is queried only once).
+     * @return The detected IsaLevel.
+     * **/
+    [[nodiscard]] inline IsaLevel GetDetectedIsaLevel() noexcept {
+        static const IsaLevel level = DetectIsaLevel();
+        return level;
+    }
+
+    namespace Detail
+    {
+        inline std::atomic<IsaLevel> &ActiveIsaLevel() noexcept {
+            static std::atomic<IsaLevel> level{GetDetectedIsaLevel()};
+            return level;
+        }
+    }
+
+    /**
+     * @brief Returns the ISA level kernels dispatch to.
+     * @return The active IsaLevel (the detected one unless lowered with SetIsaLevel).
+     * **/
+    [[nodiscard]] inline IsaLevel GetIsaLevel() noexcept {
+        return Detail::ActiveIsaLevel().load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Restricts kernels to an ISA level (e.g. to compare variants or to avoid AVX-512 frequency drops).
+     * Requests above the detected level are clamped to it.
+     * @param level The maximum ISA level to use.
+     * **/
+    inline void SetIsaLevel(IsaLevel level) noexcept {
+        const IsaLevel detected = GetDetectedIsaLevel();
+        Detail::ActiveIsaLevel().store(level > detected ? detected : level, std::memory_order_relaxed);
+    }
+
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+    /**
+     * @brief A GCC/Clang vector of Bytes / sizeof(T) elements of type T.
+     * **/
+    template <typename T, size_t Bytes>
+    struct VectorOf {
+        typedef T type __attribute__((vector_size(Bytes)));
+    };
+
+    template <typename T, size_t Bytes>
+    using Vector = typename VectorOf<T, Bytes>::type;
+
+    /**
+     * @brief Loads a vector from unaligned memory.
+     * Vectors are passed by reference so the helpers are ABI-neutral across target attributes.
+     * **/
+    template <typename V, typename T>
+    NEXT_ALWAYS_INLINE void LoadVector(V &dst, const T *src) noexcept { std::memcpy(&dst, src, sizeof(V)); }
+
+    /**
+     * @brief Stores a vector to unaligned memory.
+     * **/
+    template <typename V, typename T>
+    NEXT_ALWAYS_INLINE void StoreVector(T *dst, const V &src) noexcept { std::memcpy(dst, &src, sizeof(V)); }
+
+    /**
+     * @brief Sets every lane of a vector to the same value.
+     * **/
+    template <typename V, typename T>
+    NEXT_ALWAYS_INLINE void BroadcastVector(V &dst, T value) noexcept {
+        dst = value - V{}; // Scalar-vector arithmetic splats the scalar
+    }
+#endif
+}
@@ -0,0 +1,354 @@
+#pragma once
+
+#include "Activation.hpp"
+#include <algorithm> // std::min, std::max
+#include <cmath>     // std::exp
+#include <limits>    // std::numeric_limits
+
+namespace NextKernels
+{
+    namespace Detail
+    {
+        constexpr size_t SoftmaxChunk = 1024;      // Row elements reduced before the running sum is rescaled (stays in L1)
+        constexpr size_t SoftmaxColumnBlock = 256; // Columns updated together when the softmax axis is not innermost
+
+        /**
+         * @brief Maximum of a contiguous array (-inf if empty).
+         * **/
+        template <size_t Bytes, typename T>
+        NEXT_ALWAYS_INLINE T SoftmaxMaxBody(const T *x, size_t n) noexcept {
+            T max = -std::numeric_limits<T>::infinity();
+            size_t i = 0;
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+            if constexpr (Bytes >= 2 * sizeof(T)) {
+                using V = Vector<T, Bytes>;
+                constexpr size_t Lanes = Bytes / sizeof(T);
+                if (n >= Lanes) {
+                    V vmax;
+                    BroadcastVector(vmax, max);
+                    for (; i + Lanes <= n; i += Lanes) {
+                        V v;
+                        LoadVector(v, x + i);
+                        vmax = v > vmax ? v : vmax;
+                    }
+                    T lanes[Lanes];
+                    StoreVector(lanes, vmax);
+                    for (size_t l = 0; l < Lanes; ++l) max = lanes[l] > max ? lanes[l] : max;
+                }
+            }
+#endif
+            for (; i < n; ++i) max = x[i] > max ? x[i] : max;
+            return max;
+        }
+
+        /**
+         * @brief Sum of exp(x - max) over a contiguous array.
+         * **/
+        template <size_t Bytes, typename T, bool Fast>
+        NEXT_ALWAYS_INLINE T SoftmaxExpSumBody(const T *x, size_t n, T max) noexcept {
+            T sum = T(0);
+            size_t i = 0;
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+            if constexpr (Bytes >= 2 * sizeof(T)) {
+                using V = Vector<T, Bytes>;
+                constexpr size_t Lanes = Bytes / sizeof(T);
+                if (n >= Lanes) {
+                    V vsum{}, vmax;
+                    BroadcastVector(vmax, max);
+                    for (; i + Lanes <= n; i += Lanes) {
+                        V v, e;
+                        LoadVector(v, x + i);
+                        ExpVector<T, Fast>(e, v - vmax);
+                        vsum += e;
+                    }
+                    T lanes[Lanes];
+                    StoreVector(lanes, vsum);
+                    for (size_t l = 0; l < Lanes; ++l) sum += lanes[l];
+                }
+            }
+#endif
+            for (; i < n; ++i) sum += std::exp(x[i] - max);
+            return sum;
+        }
+
+        /**
+         * @brief out = exp(x - max) * scale over a contiguous array (out may alias x).
+         * **/
+        template <size_t Bytes, typename T, bool Fast>
+        NEXT_ALWAYS_INLINE void SoftmaxNormalizeBody(T *out, const T *x, size_t n, T max, T scale) noexcept {
+            size_t i = 0;
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+            if constexpr (Bytes >= 2 * sizeof(T)) {
+                using V = Vector<T, Bytes>;
+                constexpr size_t Lanes = Bytes / sizeof(T);
+                V vmax, vscale;
+                BroadcastVector(vmax, max);
+                BroadcastVector(vscale, scale);
+                for (; i + Lanes <= n; i += Lanes) {
+                    V v, e;
+                    LoadVector(v, x + i);
+                    ExpVector<T, Fast>(e, v - vmax);
+                    e *= vscale;
+                    StoreVector(out + i, e);
+                }
+            }
+#endif
+            for (; i < n; ++i) out[i] = std::exp(x[i] - max) * scale;
+        }
+
+        /**
+         * @brief Softmax of one contiguous row, reading the input twice.
+         * The first pass keeps a running maximum and a running sum of exp(x - maximum) chunk by chunk: each chunk
+         * is reduced to its maximum, the running sum is rescaled by exp(old - new) when the maximum grows, then the
+         * chunk (still in L1) adds its exponentials. The second pass writes exp(x - maximum) / sum.
+         * **/
+        template <size_t Bytes, typename T, bool Fast>
+        NEXT_ALWAYS_INLINE void SoftmaxRowBody(T *out, const T *in, size_t n) noexcept {
+            T max = -std::numeric_limits<T>::infinity();
+            double sum = 0.0;
+            for (size_t c = 0; c < n; c += SoftmaxChunk) {
+                const size_t m = std::min(SoftmaxChunk, n - c);
+                const T chunkMax = SoftmaxMaxBody<Bytes, T>(in + c, m);
+                if (chunkMax > max) {
+                    sum *= std::exp(static_cast<double>(max) - static_cast<double>(chunkMax));
+                    max = chunkMax;
+                }
+                if (max == -std::numeric_limits<T>::infinity()) continue; // Only -inf so far: nothing to add yet
+                sum += static_cast<double>(SoftmaxExpSumBody<Bytes, T, Fast>(in + c, m, max));
+            }
+            SoftmaxNormalizeBody<Bytes, T, Fast>(out, in, n, max, static_cast<T>(1.0 / sum));
+        }
+
+        /**
+         * @brief One online update of a column's running maximum and sum with a new value x.
+         * The rescale factor and the new term are 1 when their exponent would be -inf - (-inf), so columns
+         * starting with -inf (masked positions) stay well defined.
+         * **/
+        template <typename T>
+        inline void SoftmaxOnlineUpdate(T &max, T &sum, T x) noexcept {
+            const T next = x > max ? x : max;
+            const T rescale = max == next ? T(1) : std::exp(max - next);
+            const T term = x == next ? T(1) : std::exp(x - next);
+            sum = sum * rescale + term;
+            max = next;
+        }
+
+        /**
+         * @brief Softmax over the rows of `width` adjacent columns (unit stride) whose softmax axis has stride
+         * inStride / outStride: running maxima and sums are updated online one row at a time, then the rows are
+         * normalized, so the input is read twice.
+         * **/
+        template <size_t Bytes, typename T, bool Fast>
+        NEXT_ALWAYS_INLINE void SoftmaxColumnsBody(T *out, size_t outStride, const T *in, size_t inStride, size_t extent, size_t width) noexcept {
+            T max[SoftmaxColumnBlock], sum[SoftmaxColumnBlock];
+            std::fill(max, max + width, -std::numeric_limits<T>::infinity());
+            std::fill(sum, sum + width, T(0));
+            for (size_t k = 0; k < extent; ++k) {
+                const T *x = in + k * inStride;
+                size_t j = 0;
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+                if constexpr (Bytes >= 2 * sizeof(T)) {
+                    using V = Vector<T, Bytes>;
+                    constexpr size_t Lanes = Bytes / sizeof(T);
+                    for (; j + Lanes <= width; j += Lanes) {
+                        V v, m, s, rescale, term;
+                        LoadVector(v, x + j);
+                        LoadVector(m, max + j);
+                        LoadVector(s, sum + j);
+                        const V next = v > m ? v : m;
+                        ExpVector<T, Fast>(rescale, m - next);
+                        ExpVector<T, Fast>(term, v - next);
+                        rescale = m == next ? T(1) - V{} : rescale;
+                        term = v == next ? T(1) - V{} : term;
+                        s = s * rescale + term;
+                        StoreVector(max + j, next);
+                        StoreVector(sum + j, s);
+                    }
+                }
+#endif
+                for (; j < width; ++j) SoftmaxOnlineUpdate(max[j], sum[j], x[j]);
+            }
+            for (size_t j = 0; j < width; ++j) sum[j] = T(1) / sum[j];
+            for (size_t k = 0; k < extent; ++k) {
+                const T *x = in + k * inStride;
+                T *o = out + k * outStride;
+                size_t j = 0;
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+                if constexpr (Bytes >= 2 * sizeof(T)) {
+                    using V = Vector<T, Bytes>;
+                    constexpr size_t Lanes = Bytes / sizeof(T);
+                    for (; j + Lanes <= width; j += Lanes) {
+                        V v, m, scale, e;
+                        LoadVector(v, x + j);
+                        LoadVector(m, max + j);
+                        LoadVector(scale, sum + j);
+                        ExpVector<T, Fast>(e, v - m);
+                        e *= scale;
+                        StoreVector(o + j, e);
+                    }
+                }
+#endif
+                for (; j < width; ++j) o[j] = std::exp(x[j] - max[j]) * sum[j];
+            }
+        }
+
+        template <typename T, bool Fast>
+        NEXT_TARGET_AVX512 void SoftmaxRowAvx512(T *out, const T *in, size_t n) noexcept { SoftmaxRowBody<64, T, Fast>(out, in, n); }
+
+        template <typename T, bool Fast>
+        NEXT_TARGET_AVX2 void SoftmaxRowAvx2(T *out, const T *in, size_t n) noexcept { SoftmaxRowBody<32, T, Fast>(out, in, n); }
+
+        template <typename T, bool Fast>
+        NEXT_TARGET_SSE2 void SoftmaxRowSse2(T *out, const T *in, size_t n) noexcept { SoftmaxRowBody<16, T, Fast>(out, in, n); }
+
+        template <typename T, bool Fast>
+        NEXT_TARGET_AVX512 void SoftmaxColumnsAvx512(T *out, size_t outStride, const T *in, size_t inStride, size_t extent, size_t width) noexcept {
+            SoftmaxColumnsBody<64, T, Fast>(out, outStride, in, inStride, extent, width);
+        }
+
+        template <typename T, bool Fast>
+        NEXT_TARGET_AVX2 void SoftmaxColumnsAvx2(T *out, size_t outStride, const T *in, size_t inStride, size_t extent, size_t width) noexcept {
+            SoftmaxColumnsBody<32, T, Fast>(out, outStride, in, inStride, extent, width);
+        }
+
+        template <typename T, bool Fast>
+        NEXT_TARGET_SSE2 void SoftmaxColumnsSse2(T *out, size_t outStride, const T *in, size_t inStride, size_t extent, size_t width) noexcept {
+            SoftmaxColumnsBody<16, T, Fast>(out, outStride, in, inStride, extent, width);
+        }
+
+        /**
+         * @brief Runs the contiguous-row softmax compiled for the active ISA level.
+         * **/
+        template <typename T, bool Fast>
+        void SoftmaxRow(T *out, const T *in, size_t n) noexcept {
+            switch (GetIsaLevel()) {
+                case IsaLevel::AVX512: SoftmaxRowAvx512<T, Fast>(out, in, n); break;
+                case IsaLevel::AVX2:   SoftmaxRowAvx2<T, Fast>(out, in, n); break;
+                case IsaLevel::SSE2:   SoftmaxRowSse2<T, Fast>(out, in, n); break;
+                default:               SoftmaxRowBody<0, T, Fast>(out, in, n); break;
+            }
+        }
+
+        /**
+         * @brief Runs the column-block softmax compiled for the active ISA level.
+         * **/
+        template <typename T, bool Fast>
+        void SoftmaxColumns(T *out, size_t outStride, const T *in, size_t inStride, size_t extent, size_t width) noexcept {
+            switch (GetIsaLevel()) {
+                case IsaLevel::AVX512: SoftmaxColumnsAvx512<T, Fast>(out, outStride, in, inStride, extent, width); break;
+                case IsaLevel::AVX2:   SoftmaxColumnsAvx2<T, Fast>(out, outStride, in, inStride, extent, width); break;
+                case IsaLevel::SSE2:   SoftmaxColumnsSse2<T, Fast>(out, outStride, in, inStride, extent, width); break;
+                default:               SoftmaxColumnsBody<0, T, Fast>(out, outStride, in, inStride, extent, width); break;
+            }
+        }
+
+        /**
+         * @brief Softmax of one row with arbitrary strides (online update, then normalize).
+         * **/
+        template <typename T>
+        void SoftmaxStridedRow(T *out, size_t outStride, const T *in, size_t inStride, size_t extent) noexcept {
+            T max = -std::numeric_limits<T>::infinity(), sum = T(0);
+            for (size_t k = 0; k < extent; ++k) SoftmaxOnlineUpdate(max, sum, in[k * inStride]);
+            const T scale = T(1) / sum;
+            for (size_t k = 0; k < extent; ++k) out[k * outStride] = std::exp(in[k * inStride] - max) * scale;
+        }
+    }
+
+    /**
+     * @brief Computes out = softmax(in) along one axis: exp(x - max) / sum of exp(x - max) over the axis.
+     *
+     * Each row (the elements along the axis) is read twice: once to build the maximum and the sum of exponentials
+     * together (online rescaling of the sum whenever the maximum grows), once to write the normalized result.
+     * - Innermost axis with unit stride: rows are vectorized along the axis, chunk by chunk.
+     * - Other axes: blocks of adjacent rows with unit stride between them are vectorized across the rows.
+     * - Anything else runs one strided row at a time.
+     * Rows are split over the execution context. exp follows the accuracy tier of SetActivationAccuracy.
+     * A row of -inf, or with +inf or NaN, gives NaN like the reference formula.
+     * @param dtype The data type of both tensors (FLOAT32 or FLOAT64).
+     * @param out Start of the output buffer (may alias the input when both have the same metadata).
+     * @param outMeta Metadata of the output.
+     * @param in Start of the input buffer.
+     * @param inMeta Metadata of the input.
+     * @param axis The softmax axis (already normalized to [0, rank)).
+     * @param context The execution context rows are split over.
+     * @throws std::invalid_argument if the shapes differ, the data type is not floating point or a tensor is channel-blocked (see Reorder).
+     * @throws std::out_of_range if the axis is not below the rank.
+     * **/
+    inline void Softmax(DataType dtype, void *out, const TensorMetadata &outMeta, const void *in, const TensorMetadata &inMeta, size_t axis,
+                        NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        if (outMeta.GetShape() != inMeta.GetShape()) {
+            throw std::invalid_argument("Softmax output shape must match the input.");
+        }
+        NextMetadata::CheckStridedLayout(outMeta, "Softmax");
+        NextMetadata::CheckStridedLayout(inMeta, "Softmax");
+        if (axis >= inMeta.GetRank()) {
+            throw std::out_of_range("Softmax axis is out of range.");
+        }
+        const TensorShapeDynamic &shape = inMeta.GetShape();
+        const size_t extent = shape[axis];
+        const size_t inStride = inMeta.GetStrides()[axis], outStride = outMeta.GetStrides()[axis];
+
+        // One iteration position per row: the tensor with the softmax axis removed
+        TensorShapeDynamic rowShape;
+        TensorStrideDynamic inRowStrides, outRowStrides;
+        for (size_t d = 0; d < shape.size(); ++d) {
+            if (d == axis) continue;
+            rowShape.push_back(shape[d]);
+            inRowStrides.push_back(inMeta.GetStrides()[d]);
+            outRowStrides.push_back(outMeta.GetStrides()[d]);
+        }
+        const TensorMetadata outRows(rowShape, outRowStrides, outMeta.GetOffset());
+        const TensorMetadata inRows(rowShape, inRowStrides, inMeta.GetOffset());
+        const TensorIterator<2> iterator(outRows, inRows);
+        if (extent == 0 || iterator.GetTotalSize() == 0) return;
+        const size_t grain = std::max<size_t>(1, Detail::ElementwiseGrain / extent);
+
+        DispatchFloatType(dtype, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            T *outData = static_cast<T *>(out);
+            const T *inData = static_cast<const T *>(in);
+            const bool fast = GetActivationAccuracy() == ActivationAccuracy::FAST;
+            context.ParallelFor(0, iterator.GetTotalSize(), grain, [&](size_t begin, size_t end) {
+                iterator.ForEachRange(begin, end, [&](const TensorIterator<2>::Offsets &offsets, const TensorIterator<2>::Strides &strides, TensorSize count) {
+                    T *o = outData + offsets[0];
+                    const T *x = inData + offsets[1];
+                    if (inStride == 1 && outStride == 1) {
+                        for (TensorSize r = 0; r < count; ++r) {
+                            if (fast) Detail::SoftmaxRow<T, true>(o + r * strides[0], x + r * strides[1], extent);
+                            else Detail::SoftmaxRow<T, false>(o + r * strides[0], x + r * strides[1], extent);
+                        }
+                    } else if (strides[0] == 1 && strides[1] == 1) {
+                        for (TensorSize c = 0; c < count; c += Detail::SoftmaxColumnBlock) {
+                            const size_t width = std::min<size_t>(Detail::SoftmaxColumnBlock, count - c);
+                            if (fast) Detail::SoftmaxColumns<T, true>(o + c, outStride, x + c, inStride, extent, width);
+                            else Detail::SoftmaxColumns<T, false>(o + c, outStride, x + c, inStride, extent, width);
+                        }
+                    } else {
+                        for (TensorSize r = 0; r < count; ++r) {
+                            Detail::SoftmaxStridedRow(o + r * strides[0], outStride, x + r * strides[1], inStride, extent);
+                        }
+                    }
+                });
+            });
+        });
+    }
+
+    /**
+     * @brief Computes out = softmax(in) along one axis on tensors. See the raw-pointer overload.
+     * @param axis The softmax axis; negative values count from the last dimension.
+     * @throws std::invalid_argument if the data types differ, or see the raw-pointer overload.
+     * @throws std::out_of_range if the axis is outside [-rank, rank).
+     * **/
+    inline void Softmax(const TensorInterface &in, TensorInterface &out, int64_t axis = -1,
+                        NextExecution::ExecutionContext &context = NextExecution::GetDefaultContext()) {
+        if (in.GetDataType() != out.GetDataType()) {
+            throw std::invalid_argument("Softmax input must have the same data type as the output.");
+        }
+        const int64_t rank = static_cast<int64_t>(in.GetMetadata().GetRank());
+        if (axis < -rank || axis >= rank) {
+            throw std::out_of_range("Softmax axis is out of range.");
+        }
+        Softmax(out.GetDataType(), out.GetRawData(), out.GetMetadata(), in.GetRawData(), in.GetMetadata(),
+                static_cast<size_t>(axis < 0 ? axis + rank : axis), context);
+    }
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "Elementwise.hpp"
+#include "../../Core/TensorIterator.hpp"
+#include "../Execution/Context.hpp"
+#include <algorithm> // std::min, std::max
+#include <cstdint>   // fixed-width integer types
+#include <utility>   // std::index_sequence
+#include <vector>    // std::vector
+
+/**
+ * Tiled transposition used to materialize permuted views.
+ * A copy whose unit-stride dimension differs between the input and the output is a batch of 2D transposes:
+ * rows are read along the input's unit-stride dimension and written along the output's. The matrix is split into
+ * panels shared between threads, each panel is halved recursively (cache-oblivious) down to blocks that fit L1,
+ * and blocks are transposed by L x L register tiles (8x8 or 16x16 depending on the element size and ISA).
+ * Only the element size matters, so every data type goes through the unsigned integer of its size.
+ * **/
+namespace NextKernels
+{
+    namespace Detail
+    {
+        constexpr size_t TransposePanel = 64;              // Rows and columns of the panels split between threads
+        constexpr size_t TransposeBaseBytes = 4 << 10;     // Blocks up to this size are transposed without further splitting
+        constexpr size_t TransposeMinExtent = 8;           // Narrower transposes are left to the strided copy loops
+        constexpr size_t TransposeMaxLanes = 16;           // Largest register tile (16 x 16)
+
+        template <size_t Size> struct UnsignedOfSize;
+        template <> struct UnsignedOfSize<1> { using type = std::uint8_t; };
+        template <> struct UnsignedOfSize<2> { using type = std::uint16_t; };
+        template <> struct UnsignedOfSize<4> { using type = std::uint32_t; };
+        template <> struct UnsignedOfSize<8> { using type = std::uint64_t; };
+
+        /**
+         * @brief Vector width of the register tiles for Bytes-wide registers (0 = scalar only).
+         * Capped so a tile never exceeds TransposeMaxLanes rows.
+         * **/
+        template <size_t Bytes, typename U>
+        constexpr size_t TransposeTileBytes = Bytes < TransposeMaxLanes * sizeof(U) ? Bytes : TransposeMaxLanes * sizeof(U);
+
+#if NEXT_SIMD_VECTOR_EXTENSIONS && NEXT_SIMD_SHUFFLE
+        // Lanes 0, L, 1, L + 1, ... of the concatenation a:b (first halves interleaved)
+        template <typename V, size_t... I>
+        NEXT_ALWAYS_INLINE void InterleaveLow(V &out, const V &a, const V &b, std::index_sequence<I...>) noexcept {
+            out = __builtin_shufflevector(a, b, (I / 2 + I % 2 * sizeof...(I))...);
+        }
+
+        // Lanes L / 2, 3L / 2, L / 2 + 1, ... of the concatenation a:b (second halves interleaved)
+        template <typename V, size_t... I>
+        NEXT_ALWAYS_INLINE void InterleaveHigh(V &out, const V &a, const V &b, std::index_sequence<I...>) noexcept {
+            out = __builtin_shufflevector(a, b, (sizeof...(I) / 2 + I / 2 + I % 2 * sizeof...(I))...);
+        }
+
+        /**
+         * @brief Transposes one L x L tile held in registers, L = Bytes / sizeof(U).
+         * Interleaving rows k and k + L/2 into rows 2k and 2k + 1 rotates the (row, column) bit string by one,
+         * so log2(L) rounds turn (row, column) into (column, row).
+         * **/
+        template <size_t Bytes, typename U>
+        NEXT_ALWAYS_INLINE void TransposeRegisterTile(const U *in, size_t ldi, U *out, size_t ldo) noexcept {
+            using V = Vector<U, Bytes>;
+            constexpr size_t L = Bytes / sizeof(U);
+            constexpr auto lanes = std::make_index_sequence<L>{};
+            V rows[L];
+            NEXT_UNROLL
+            for (size_t r = 0; r < L; ++r) LoadVector(rows[r], in + r * ldi);
+            NEXT_UNROLL
+            for (size_t round = 1; round < L; round *= 2) {
+                V next[L];
+                NEXT_UNROLL
+                for (size_t k = 0; k < L / 2; ++k) {
+                    InterleaveLow(next[2 * k], rows[k], rows[k + L / 2], lanes);
+                    InterleaveHigh(next[2 * k + 1], rows[k], rows[k + L / 2], lanes);
+                }
+                NEXT_UNROLL
+                for (size_t r = 0; r < L; ++r) rows[r] = next[r];
+            }
+            NEXT_UNROLL
+            for (size_t r = 0; r < L; ++r) StoreVector(out + r * ldo, rows[r]);
+        }
+#endif
+
+        /**
+         * @brief out[c * ldo + r] = in[r * ldi + c] for a rows x cols block (Bytes is the vector width, 0 = scalar only).
+         * Full L x L tiles go through registers; the edges are copied element by element.
+         * **/
+        template <size_t Bytes, typename U>
+        NEXT_ALWAYS_INLINE void TransposeBlockBody(const U *in, size_t ldi, U *out, size_t ldo, size_t rows, size_t cols) noexcept {
+            size_t r = 0;
+#if NEXT_SIMD_VECTOR_EXTENSIONS && NEXT_SIMD_SHUFFLE
+            constexpr size_t TileBytes = TransposeTileBytes<Bytes, U>;
+            if constexpr (TileBytes >= 2 * sizeof(U)) {
+                constexpr size_t L = TileBytes / sizeof(U);
+                for (; r + L <= rows; r += L) {
+                    size_t c = 0;
+                    for (; c + L <= cols; c += L) TransposeRegisterTile<TileBytes>(in + r * ldi + c, ldi, out + c * ldo + r, ldo);
+                    for (; c < cols; ++c) {
+                        for (size_t i = 0; i < L; ++i) out[c * ldo + r + i] = in[(r + i) * ldi + c];
+                    }
+                }
+            }
+#endif
+            for (size_t c = 0; c < cols && r < rows; ++c) {
+                for (size_t i = r; i < rows; ++i) out[c * ldo + i] = in[i * ldi + c];
+            }
+        }
+
+        template <typename U>
+        NEXT_TARGET_AVX512 void TransposeBlockAvx512(const U *in, size_t ldi, U *out, size_t ldo, size_t rows, size_t cols) noexcept {
+            TransposeBlockBody<64, U>(in, ldi, out, ldo, rows, cols);
+        }
+
+        template <typename U>
+        NEXT_TARGET_AVX2 void TransposeBlockAvx2(const U *in, size_t ldi, U *out, size_t ldo, size_t rows, size_t cols) noexcept {
+            TransposeBlockBody<32, U>(in, ldi, out, ldo, rows, cols);
+        }
+
+        template <typename U>
+        NEXT_TARGET_SSE2 void TransposeBlockSse2(const U *in, size_t ldi, U *out, size_t ldo, size_t rows, size_t cols) noexcept {
+            TransposeBlockBody<16, U>(in, ldi, out, ldo, rows, cols);
+        }
+
+        /**
+         * @brief Transposes a block with the register tiles of the active ISA level.
+         * **/
+        template <typename U>
+        void TransposeBlock(const U *in, size_t ldi, U *out, size_t ldo, size_t rows, size_t cols) noexcept {
+            switch (GetIsaLevel()) {
+                case IsaLevel::AVX512: TransposeBlockAvx512(in, ldi, out, ldo, rows, cols); break;
+                case IsaLevel::AVX2:   TransposeBlockAvx2(in, ldi, out, ldo, rows, cols); break;
+                case IsaLevel::SSE2:   TransposeBlockSse2(in, ldi, out, ldo, rows, cols); break;
+                default:               TransposeBlockBody<0>(in, ldi, out, ldo, rows, cols); break;
+            }
+        }
+
+        /**
+         * @brief out[c * ldo + r] = in[r * ldi + c], halving the longer side until the block fits TransposeBaseBytes.
+         * Split points stay multiples of the largest tile so only the outer edges fall back to scalar copies.
+         * **/
+        template <typename U>
+        void TransposeRecursive(const U *in, size_t ldi, U *out, size_t ldo, size_t rows, size_t cols) noexcept {
+            if (rows * cols * sizeof(U) <= TransposeBaseBytes || (rows <= 2 * TransposeMaxLanes && cols <= 2 * TransposeMaxLanes)) {
+                TransposeBlock(in, ldi, out, ldo, rows, cols);
+            } else if (rows >= cols) {
+                const size_t half = std::max(TransposeMaxLanes, rows / 2 / TransposeMaxLanes * TransposeMaxLanes);
+                TransposeRecursive(in, ldi, out, ldo, half, cols);
+                TransposeRecursive(in + half * ldi, ldi, out + half, ldo, rows - half, cols);
+            } else {
+                const size_t half = std::max(TransposeMaxLanes, cols / 2 / TransposeMaxLanes * TransposeMaxLanes);
+                TransposeRecursive(in, ldi, out, ldo, rows, half);
+                TransposeRecursive(in + half, ldi, out + half * ldo, ldo, rows, cols - half);
+            }
+        }
+
+        /**
+         * @brief Copies through tiled transposes when the unit-stride dimensions of the two operands differ.
+         * @param iterator Iterator over (out, in), which puts the output's smallest stride innermost.
+         * @param out Output origin (offset applied).
+         * @param in Input origin (offset applied).
+         * @param context The execution context the panels are split over.
+         * @return False if the copy is not a transpose of at least TransposeMinExtent x TransposeMinExtent elements
+         * (nothing has been written).
+         * **/
+        template <typename T>
+        bool TransposeCopy(const TensorIterator<2> &iterator, T *out, const T *in, NextExecution::ExecutionContext &context) {
+            using U = typename UnsignedOfSize<sizeof(T)>::type;
+            const TensorShapeDynamic &shape = iterator.GetShape();
+            const TensorStrideDynamic &outStrides = iterator.GetStrides(0);
+            const TensorStrideDynamic &inStrides = iterator.GetStrides(1);
+            const size_t rank = shape.size(), a = rank - 1; // a: unit stride in the output
+            if (rank < 2 || outStrides[a] != 1 || inStrides[a] == 1) return false;
+            size_t b = a;                                   // b: unit stride in the input
+            for (size_t d = 0; d < a; ++d) {
+                if (inStrides[d] == 1) b = d;
+            }
+            if (b == a || shape[a] < TransposeMinExtent || shape[b] < TransposeMinExtent) return false;
+
+            struct BatchDim {
+                size_t extent, outStride, inStride;
+            };
+            std::vector<BatchDim> batchDims;
+            size_t batch = 1;
+            for (size_t d = 0; d < a; ++d) {
+                if (d == b) continue;
+                batchDims.push_back({shape[d], outStrides[d], inStrides[d]});
+                batch *= shape[d];
+            }
+
+            const size_t rows = shape[a], cols = shape[b], ldi = inStrides[a], ldo = outStrides[b];
+            const size_t rowPanels = (rows + TransposePanel - 1) / TransposePanel, colPanels = (cols + TransposePanel - 1) / TransposePanel;
+            U *o = reinterpret_cast<U *>(out);
+            const U *x = reinterpret_cast<const U *>(in);
+            const size_t grain = std::max<size_t>(1, ElementwiseGrain / (TransposePanel * TransposePanel));
+            context.ParallelFor(0, batch * rowPanels * colPanels, grain, [&](size_t begin, size_t end) {
+                for (size_t task = begin; task < end; ++task) {
+                    const size_t colPanel = task % colPanels, rowPanel = task / colPanels % rowPanels;
+                    size_t index = task / (colPanels * rowPanels), outOffset = 0, inOffset = 0;
+                    for (size_t d = batchDims.size(); d-- > 0;) {
+                        const size_t i = index % batchDims[d].extent;
+                        index /= batchDims[d].extent;
+                        outOffset += i * batchDims[d].outStride;
+                        inOffset += i * batchDims[d].inStride;
+                    }
+                    const size_t r0 = rowPanel * TransposePanel, c0 = colPanel * TransposePanel;
+                    TransposeRecursive(x + inOffset + r0 * ldi + c0, ldi, o + outOffset + c0 * ldo + r0, ldo,
+                                       std::min(TransposePanel, rows - r0), std::min(TransposePanel, cols - c0));
+                }
+            });
+            return true;
+        }
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Simd.hpp"
+#include <cstdint> // std::int32_t, std::int64_t
+
+/**
+ * Vectorized approximations of exp, sigmoid and tanh.
+ * Every function works on a GCC/Clang vector of float or double lanes and is always inlined, so it is compiled
+ * for the ISA of the kernel calling it. Two accuracy tiers are provided (see ActivationAccuracy):
+ *  - precise: Cody-Waite range reduction with a split ln(2) and the Cephes minimax polynomial (float) or Pade
+ *    approximant (double) of exp; tanh uses the Cephes odd polynomial / rational function near zero.
+ *  - fast: single-constant range reduction and a degree-4 polynomial for exp, a degree-5 odd polynomial for tanh
+ *    near zero; relative error stays around 1e-4 for both element types.
+ * Both tiers handle the whole input range: overflow gives +inf, underflow gives subnormals then 0, NaN propagates.
+ * **/
+namespace NextKernels
+{
+#if NEXT_SIMD_VECTOR_EXTENSIONS
+    namespace Detail
+    {
+        /**
+         * @brief IEEE-754 layout of a floating-point element type.
+         * **/
+        template <typename T>
+        struct FloatBits;
+
+        template <>
+        struct FloatBits<float> {
+            using Int = std::int32_t;
+            static constexpr int Mantissa = 23;
+            static constexpr Int Bias = 127;
+            static constexpr float Magic = 12582912.0f;                    // 1.5 * 2^23: adding it rounds to an integer
+            static constexpr Int MagicBits = 0x4B400000;
+            static constexpr float ExpLow = -104.0f;                       // exp(x) rounds to 0 below
+            static constexpr float ExpHigh = 89.0f;                        // exp(x) overflows above
+        };
+
+        template <>
+        struct FloatBits<double> {
+            using Int = std::int64_t;
+            static constexpr int Mantissa = 52;
+            static constexpr Int Bias = 1023;
+            static constexpr double Magic = 6755399441055744.0;            // 1.5 * 2^52
+            static constexpr Int MagicBits = 0x4338000000000000LL;
+            static constexpr double ExpLow = -746.0;
+            static constexpr double ExpHigh = 710.0;
+        };
+
+        /**
+         * @brief Integer vector with the lane count of V (the type vector comparisons return).
+         * **/
+        template <typename V>
+        using MaskOf = decltype(V{} < V{});
+
+        /**
+         * @brief Rounds every lane to the nearest integer, both as a floating-point and as an integer vector.
+         * Valid for |x| < 2^22 (float) or 2^51 (double), which the exp clamp guarantees.
+         * **/
+        template <typename T, typename V>
+        NEXT_ALWAYS_INLINE void RoundVector(V &rounded, MaskOf<V> &integer, const V &x) noexcept {
+            using Traits = FloatBits<T>;
+            const V shifted = x + Traits::Magic;
+            rounded = shifted - Traits::Magic;
+            integer = (MaskOf<V>)shifted - Traits::MagicBits;
+        }
+
+        /**
+         * @brief Builds 2^k from integer exponents k within the normal range.
+         * **/
+        template <typename T, typename V>
+        NEXT_ALWAYS_INLINE void Exp2Vector(V &out, const MaskOf<V> &k) noexcept {
+            using Traits = FloatBits<T>;
+            out = (V)((k + Traits::Bias) << Traits::Mantissa);
+        }
+
+        /**
+         * @brief out = exp(x) lane by lane.
+         * x = k ln2 + r with |r| <= ln2 / 2, exp(x) = 2^k exp(r). 2^k is applied in two halves so results reaching
+         * the subnormal range or overflowing are still rounded correctly.
+         * **/
+        template <typename T, bool Fast, typename V>
+        NEXT_ALWAYS_INLINE void ExpVector(V &out, const V &in) noexcept {
+            using Traits = FloatBits<T>;
+            V x = in < Traits::ExpLow ? Traits::ExpLow - V{} : in; // NaN fails both comparisons and propagates
+            x = x > Traits::ExpHigh ? Traits::ExpHigh - V{} : x;
+
+            V n;
+            MaskOf<V> k;
+            RoundVector<T>(n, k, x * T(1.44269504088896340736));
+
+            V p;
+            if constexpr (Fast) {
+                const V r = x - n * T(0.693147180559945309417);
+                p = T(1) + r * (T(1) + r * (T(0.5) + r * (T(1.0 / 6.0) + r * T(1.0 / 24.0))));
+            } else if constexpr (sizeof(T) == 4) {
+                V r = x - n * T(0.693359375);
+                r = r - n * T(-2.12194440e-4);
+                const V poly = ((((T(1.9875691500e-4) * r + T(1.3981999507e-3)) * r + T(8.3334519073e-3)) * r +
+                                 T(4.1665795894e-2)) * r + T(1.6666665459e-1)) * r + T(5.0000001201e-1);
+                p = poly * (r * r) + r + T(1);
+            } else {
+                V r = x - n * T(6.93145751953125e-1);
+                r = r - n * T(1.42860682030941723212e-6);
+                const V rr = r * r;
+                const V px = r * ((T(1.26177193074810590878e-4) * rr + T(3.02994407707441961300e-2)) * rr +
+                                  T(9.99999999999999999910e-1));
+                const V qx = ((T(3.00198505138664455042e-6) * rr + T(2.52448340349684104192e-3)) * rr +
+                              T(2.27265548208155028766e-1)) * rr + T(2.00000000000000000009e0);
+                p = T(1) + T(2) * px / (qx - px);
+            }
+
+            const MaskOf<V> half = k >> 1;
+            V scale0, scale1;
+            Exp2Vector<T>(scale0, half);
+            Exp2Vector<T>(scale1, k - half);
+            out = p * scale0 * scale1;
+        }
+
+        /**
+         * @brief out = 1 / (1 + exp(-x)) lane by lane.
+         * Evaluated through e = exp(-|x|) so exp never overflows: 1 / (1 + e) for x >= 0, e / (1 + e) otherwise.
+         * **/
+        template <typename T, bool Fast, typename V>
+        NEXT_ALWAYS_INLINE void SigmoidVector(V &out, const V &x) noexcept {
+            const MaskOf<V> negative = x < T(0);
+            V e;
+            ExpVector<T, Fast>(e, negative ? x : -x);
+            const V s = T(1) / (T(1) + e);
+            out = negative ? e * s : s;
+        }
+
+        /**
+         * @brief out = tanh(x) lane by lane.
+         * Near zero an odd polynomial (rational for precise doubles) avoids the cancellation of the exp form;
+         * elsewhere tanh(|x|) = 1 - 2 / (exp(2|x|) + 1) with the sign of x restored.
+         * **/
+        template <typename T, bool Fast, typename V>
+        NEXT_ALWAYS_INLINE void TanhVector(V &out, const V &x) noexcept {
+            const MaskOf<V> negative = x < T(0);
+            const V a = negative ? -x : x;
+            const V z = x * x;
+
+            V small;
+            MaskOf<V> isSmall;
+            if constexpr (Fast) {
+                small = x + x * z * (T(-1.0 / 3.0) + z * T(2.0 / 15.0));
+                isSmall = a < T(0.3);
+            } else if constexpr (sizeof(T) == 4) {
+                const V poly = (((T(-5.70498872745e-3) * z + T(2.06390887954e-2)) * z + T(-5.37397155531e-2)) * z +
+                                T(1.33314422036e-1)) * z + T(-3.33332819422e-1);
+                small = x + x * z * poly;
+                isSmall = a < T(0.625);
+            } else {
+                const V p = (T(-9.64399179425052238628e-1) * z + T(-9.92877231001918586564e1)) * z + T(-1.61468768441708447952e3);
+                const V q = ((z + T(1.12811678491632931402e2)) * z + T(2.23548839060100448583e3)) * z + T(4.84406305325125486048e3);
+                small = x + x * (z * p / q);
+                isSmall = a < T(0.625);
+            }
+
+            V e;
+            ExpVector<T, Fast>(e, a + a);
+            const V large = T(1) - T(2) / (e + T(1));
+            out = isSmall ? small : (negative ? -large : large);
+        }
+
+        /**
+         * @brief out = max(x, 0) lane by lane (NaN gives 0, like the scalar kernel).
+         * **/
+        template <typename T, typename V>
+        NEXT_ALWAYS_INLINE void ReluVector(V &out, const V &x) noexcept {
+            out = x > T(0) ? x : V{};
+        }
+    }
+#endif
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef> // size_t
+#include <new>     // std::align_val_t, std::bad_alloc
+
+namespace NextMemory
+{
+    /**
+     * @brief Default alignment (in bytes) of every tensor buffer.
+     * 64 bytes covers a full cache line and the widest SIMD register (AVX-512).
+     * **/
+    inline constexpr size_t DefaultAlignment = 64;
+
+    /**
+     * @brief Rounds a size up to the next multiple of the given alignment.
+     * @param size The size to round up.
+     * @param alignment The alignment (must be a power of two).
+     * @return The rounded size.
+     * **/
+    [[nodiscard]] constexpr size_t AlignUp(size_t size, size_t alignment) noexcept {
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+    /**
+     * @class Allocator
+     * @brief An interface for the memory resources that back tensor storage.
+     *
+     * Tensors never call new/delete directly; they request their buffers from an Allocator so
+     * the memory strategy (aligned heap, pool, arena, ...) can be swapped without touching the tensor classes.
+     *
+     * Methods:
+     * - Allocate: Returns a buffer of at least `bytes` bytes aligned to `alignment`. Throws std::bad_alloc on failure.
+     * - Deallocate: Returns a buffer previously obtained from Allocate with the same size and alignment.
+     * **/
+    class Allocator {
+    public:
+        virtual ~Allocator() = default;
+
+        [[nodiscard]] virtual void *Allocate(size_t bytes, size_t alignment = DefaultAlignment) = 0;
+
+        virtual void Deallocate(void *ptr, size_t bytes, size_t alignment = DefaultAlignment) noexcept = 0;
+    };
+
+    /**
+     * @class AlignedAllocator
+     * @brief Allocator that forwards every request to the aligned global operator new/delete.
+     * **/
+    class AlignedAllocator : public Allocator {
+    public:
+        /**
+         * @brief Allocates an aligned buffer from the global heap.
+         * @param bytes The number of bytes to allocate.
+         * @param alignment The requested alignment (power of two).
+         * @return A pointer to the allocated buffer, or nullptr when bytes is 0.
+         * @throws std::bad_alloc if the allocation fails.
+         * **/
+        [[nodiscard]] void *Allocate(size_t bytes, size_t alignment = DefaultAlignment) override {
+            if (bytes == 0) return nullptr;
+            return ::operator new(bytes, std::align_val_t(alignment));
+        }
+
+        /**
+         * @brief Frees a buffer obtained from Allocate.
+         * @param ptr The buffer to free (nullptr is ignored).
+         * @param bytes The size that was passed to Allocate.
+         * @param alignment The alignment that was passed to Allocate.
+         * **/
+        void Deallocate(void *ptr, size_t bytes, size_t alignment = DefaultAlignment) noexcept override {
+            if (ptr == nullptr) return;
+            ::operator delete(ptr, bytes, std::align_val_t(alignment));
+        }
+    };
+
+    /**
+     * @brief Returns the process-wide aligned heap allocator.
+     * @return A reference to a static AlignedAllocator instance.
+     * **/
+    inline AlignedAllocator &GetAlignedAllocator() noexcept {
+        static AlignedAllocator allocator;
+        return allocator;
+    }
+}
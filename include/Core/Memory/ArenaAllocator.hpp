@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Allocator.hpp"
+#include <vector>  // std::vector
+#include <cstdint> // uintptr_t
+
+namespace NextMemory
+{
+    /**
+     * @class ArenaAllocator
+     * @brief Bump-pointer allocator for short-lived scratch tensors (e.g. the activations of one forward pass).
+     *
+     * Allocate only advances a pointer inside the current chunk; Deallocate is a no-op.
+     * All memory is reclaimed at once by Reset(), which is meant to be called once per forward pass.
+     * When a pass needed more than one chunk, Reset() replaces them with a single chunk large enough
+     * for the whole pass, so steady-state passes never touch the upstream allocator.
+     *
+     * An arena is not thread-safe: give every worker thread its own arena (see GetThreadArena) so
+     * concurrent inferences never contend on a shared heap lock.
+     * Tensors allocated from an arena must not outlive the next Reset().
+     * **/
+    class ArenaAllocator : public Allocator {
+    public:
+        static constexpr size_t DefaultChunkSize = size_t(1) << 20; // 1 MiB
+
+        /**
+         * @brief Constructs an arena.
+         * @param chunkSize The minimum size of every chunk requested from upstream.
+         * @param upstream The allocator that provides the chunks (default is the aligned heap allocator).
+         * **/
+        explicit ArenaAllocator(size_t chunkSize = DefaultChunkSize, Allocator &upstream = GetAlignedAllocator()) noexcept
+            : upstream_(upstream), chunkSize_(AlignUp(chunkSize, DefaultAlignment)) {}
+
+        ~ArenaAllocator() override { ReleaseChunks(); }
+        ArenaAllocator(const ArenaAllocator&) = delete;
+        ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+        /**
+         * @brief Allocates a buffer by bumping the pointer of the current chunk.
+         * @param bytes The number of bytes to allocate.
+         * @param alignment The requested alignment (power of two).
+         * @return A pointer to the buffer, or nullptr when bytes is 0.
+         * @throws std::bad_alloc if a new chunk cannot be obtained from upstream.
+         * **/
+        [[nodiscard]] void *Allocate(size_t bytes, size_t alignment = DefaultAlignment) override {
+            if (bytes == 0) return nullptr;
+
+            if (!chunks_.empty()) {
+                Chunk &chunk = chunks_.back();
+                const size_t start = AlignUp(reinterpret_cast<uintptr_t>(chunk.data) + used_, alignment) - reinterpret_cast<uintptr_t>(chunk.data);
+                if (start + bytes <= chunk.size) {
+                    used_ = start + bytes;
+                    totalUsed_ += bytes;
+                    return chunk.data + start;
+                }
+            }
+
+            // Current chunk is exhausted: start a new one that fits the request
+            const size_t chunkBytes = AlignUp(bytes + alignment, DefaultAlignment) > chunkSize_ ? AlignUp(bytes + alignment, DefaultAlignment) : chunkSize_;
+            AddChunk(chunkBytes);
+            Chunk &chunk = chunks_.back();
+            const size_t start = AlignUp(reinterpret_cast<uintptr_t>(chunk.data), alignment) - reinterpret_cast<uintptr_t>(chunk.data);
+            used_ = start + bytes;
+            totalUsed_ += bytes;
+            return chunk.data + start;
+        }
+
+        /**
+         * @brief No-op: arena memory is only reclaimed by Reset().
+         * **/
+        void Deallocate(void *, size_t, size_t = DefaultAlignment) noexcept override {}
+
+        /**
+         * @brief Reclaims every allocation made since the last reset.
+         * If several chunks were needed, they are merged into one chunk sized for the high-water mark.
+         * The merged chunk is obtained before the old ones are released: if that fails, the arena is still reset and
+         * keeps its old chunks, allocating from the last one again.
+         * @throws std::bad_alloc if the merged chunk cannot be obtained from upstream.
+         * **/
+        void Reset() {
+            used_ = 0;
+            totalUsed_ = 0;
+            if (chunks_.size() > 1) {
+                size_t total = 0;
+                for (const Chunk &chunk : chunks_) total += chunk.size;
+                const Chunk merged{static_cast<char *>(upstream_.Allocate(total, DefaultAlignment)), total};
+                ReleaseChunks();
+                chunks_.push_back(merged); // Cannot throw: ReleaseChunks keeps the capacity
+            }
+        }
+
+        /**
+         * @brief Returns the number of bytes handed out since the last reset (alignment padding excluded).
+         * @return The number of allocated bytes.
+         * **/
+        [[nodiscard]] size_t GetUsedBytes() const noexcept { return totalUsed_; }
+
+        /**
+         * @brief Returns the number of bytes currently reserved from upstream.
+         * @return The total size of all chunks.
+         * **/
+        [[nodiscard]] size_t GetReservedBytes() const noexcept {
+            size_t total = 0;
+            for (const Chunk &chunk : chunks_) total += chunk.size;
+            return total;
+        }
+
+    private:
+        struct Chunk {
+            char *data;  // Start of the chunk
+            size_t size; // Size of the chunk in bytes
+        };
+
+        void AddChunk(size_t bytes) {
+            chunks_.reserve(chunks_.size() + 1);
+            chunks_.push_back({static_cast<char *>(upstream_.Allocate(bytes, DefaultAlignment)), bytes});
+            used_ = 0;
+        }
+
+        void ReleaseChunks() noexcept {
+            for (const Chunk &chunk : chunks_) upstream_.Deallocate(chunk.data, chunk.size, DefaultAlignment);
+            chunks_.clear();
+        }
+
+        Allocator &upstream_;         // Allocator that provides the chunks
+        size_t chunkSize_;            // Minimum size of a chunk
+        std::vector<Chunk> chunks_;   // Chunks owned by the arena, the last one is the active one
+        size_t used_ = 0;             // Bytes used in the active chunk
+        size_t totalUsed_ = 0;        // Bytes handed out since the last reset
+    };
+
+    /**
+     * @brief Returns the scratch arena of the calling thread.
+     * Every thread gets its own arena, so allocations never contend between threads.
+     * @return A reference to the thread-local ArenaAllocator.
+     * **/
+    inline ArenaAllocator &GetThreadArena() noexcept {
+        thread_local ArenaAllocator arena;
+        return arena;
+    }
+
+    /**
+     * @class ArenaScope
+     * @brief RAII helper that resets an arena when it goes out of scope (e.g. at the end of a forward pass).
+     * **/
+    class ArenaScope {
+    public:
+        explicit ArenaScope(ArenaAllocator &arena = GetThreadArena()) noexcept : arena_(arena) {}
+        ~ArenaScope() {
+            try { arena_.Reset(); } catch (...) {} // Keep the old chunks if merging them failed
+        }
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+        [[nodiscard]] ArenaAllocator &GetArena() noexcept { return arena_; }
+
+    private:
+        ArenaAllocator &arena_; // Arena reset at the end of the scope
+    };
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Allocator.hpp"
+#include <array>   // std::array
+#include <vector>  // std::vector
+#include <mutex>   // std::mutex, std::lock_guard
+
+namespace NextMemory
+{
+    /**
+     * @class PoolAllocator
+     * @brief Allocator that caches freed buffers in power-of-two size classes and hands them out again.
+     *
+     * Tensors with a changing batch size keep hitting the same few size classes, so after warm-up
+     * nearly every allocation is served from a free list instead of the global heap.
+     * Requests larger than MaxPooledSize or with an alignment above DefaultAlignment bypass the pool.
+     * Every size class has its own mutex, so the allocator can be shared between threads.
+     * **/
+    class PoolAllocator : public Allocator {
+    public:
+        static constexpr size_t MinPooledSize = DefaultAlignment; // Smallest size class (64 B)
+        static constexpr size_t MaxPooledSize = size_t(1) << 24;  // Largest size class (16 MiB)
+
+        /**
+         * @brief Constructs a pool on top of an upstream allocator.
+         * @param upstream The allocator used to refill the pool (default is the aligned heap allocator).
+         * **/
+        explicit PoolAllocator(Allocator &upstream = GetAlignedAllocator()) noexcept
+            : upstream_(upstream) {}
+
+        ~PoolAllocator() override { Release(); }
+        PoolAllocator(const PoolAllocator&) = delete;
+        PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+        /**
+         * @brief Allocates a buffer, reusing a cached one of the same size class when possible.
+         * @param bytes The number of bytes to allocate.
+         * @param alignment The requested alignment (power of two).
+         * @return A pointer to the buffer, or nullptr when bytes is 0.
+         * @throws std::bad_alloc if the upstream allocator fails.
+         * **/
+        [[nodiscard]] void *Allocate(size_t bytes, size_t alignment = DefaultAlignment) override {
+            if (bytes == 0) return nullptr;
+            if (!IsPooled(bytes, alignment)) return upstream_.Allocate(bytes, alignment);
+
+            const size_t sizeClass = GetSizeClass(bytes);
+            Bucket &bucket = buckets_[sizeClass];
+            {
+                std::lock_guard<std::mutex> lock(bucket.mutex);
+                if (!bucket.freeList.empty()) {
+                    void *ptr = bucket.freeList.back();
+                    bucket.freeList.pop_back();
+                    return ptr;
+                }
+            }
+            return upstream_.Allocate(GetClassSize(sizeClass), DefaultAlignment);
+        }
+
+        /**
+         * @brief Returns a buffer to its size class free list.
+         * @param ptr The buffer to return (nullptr is ignored).
+         * @param bytes The size that was passed to Allocate.
+         * @param alignment The alignment that was passed to Allocate.
+         * **/
+        void Deallocate(void *ptr, size_t bytes, size_t alignment = DefaultAlignment) noexcept override {
+            if (ptr == nullptr) return;
+            if (!IsPooled(bytes, alignment)) {
+                upstream_.Deallocate(ptr, bytes, alignment);
+                return;
+            }
+
+            const size_t sizeClass = GetSizeClass(bytes);
+            Bucket &bucket = buckets_[sizeClass];
+            try {
+                std::lock_guard<std::mutex> lock(bucket.mutex);
+                bucket.freeList.push_back(ptr);
+            } catch (...) {
+                // Growing the free list failed; give the block back instead of leaking it
+                upstream_.Deallocate(ptr, GetClassSize(sizeClass), DefaultAlignment);
+            }
+        }
+
+        /**
+         * @brief Returns every cached buffer to the upstream allocator.
+         * Buffers that are still in use are not affected.
+         * **/
+        void Release() noexcept {
+            for (size_t sizeClass = 0; sizeClass < NumSizeClasses; ++sizeClass) {
+                Bucket &bucket = buckets_[sizeClass];
+                std::lock_guard<std::mutex> lock(bucket.mutex);
+                for (void *ptr : bucket.freeList) {
+                    upstream_.Deallocate(ptr, GetClassSize(sizeClass), DefaultAlignment);
+                }
+                bucket.freeList.clear();
+            }
+        }
+
+    private:
+        static constexpr size_t MinClassLog2 = 6;  // log2(MinPooledSize)
+        static constexpr size_t MaxClassLog2 = 24; // log2(MaxPooledSize)
+        static constexpr size_t NumSizeClasses = MaxClassLog2 - MinClassLog2 + 1;
+
+        struct Bucket {
+            std::mutex mutex;
+            std::vector<void *> freeList;
+        };
+
+        [[nodiscard]] static bool IsPooled(size_t bytes, size_t alignment) noexcept {
+            return bytes <= MaxPooledSize && alignment <= DefaultAlignment;
+        }
+
+        [[nodiscard]] static size_t GetSizeClass(size_t bytes) noexcept {
+            size_t sizeClass = 0;
+            while ((MinPooledSize << sizeClass) < bytes) ++sizeClass;
+            return sizeClass;
+        }
+
+        [[nodiscard]] static size_t GetClassSize(size_t sizeClass) noexcept {
+            return MinPooledSize << sizeClass;
+        }
+
+        Allocator &upstream_;                            // Allocator used to refill the pool
+        std::array<Bucket, NumSizeClasses> buckets_;     // One free list per power-of-two size class
+    };
+
+    /**
+     * @brief Returns the process-wide default allocator used by tensors when none is given.
+     * @return A reference to a static PoolAllocator instance.
+     * **/
+    inline Allocator &GetDefaultAllocator() noexcept {
+        static PoolAllocator allocator;
+        return allocator;
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "PoolAllocator.hpp"
+#include <memory> // std::shared_ptr, std::allocate_shared
+
+namespace NextMemory
+{
+    /**
+     * @class StdAllocatorAdapter
+     * @brief Adapts a NextMemory::Allocator to the standard Allocator requirements.
+     * Used so that the control block of a shared Storage comes from the same allocator as its buffer.
+     * **/
+    template <typename U>
+    class StdAllocatorAdapter {
+    public:
+        using value_type = U;
+
+        explicit StdAllocatorAdapter(Allocator &allocator) noexcept : allocator_(&allocator) {}
+
+        template <typename V>
+        StdAllocatorAdapter(const StdAllocatorAdapter<V> &other) noexcept : allocator_(other.GetAllocator()) {}
+
+        [[nodiscard]] U *allocate(size_t n) {
+            return static_cast<U *>(allocator_->Allocate(n * sizeof(U), alignof(U)));
+        }
+
+        void deallocate(U *ptr, size_t n) noexcept {
+            allocator_->Deallocate(ptr, n * sizeof(U), alignof(U));
+        }
+
+        [[nodiscard]] Allocator *GetAllocator() const noexcept { return allocator_; }
+
+        template <typename V>
+        bool operator==(const StdAllocatorAdapter<V> &other) const noexcept { return allocator_ == other.GetAllocator(); }
+
+        template <typename V>
+        bool operator!=(const StdAllocatorAdapter<V> &other) const noexcept { return allocator_ != other.GetAllocator(); }
+
+    private:
+        Allocator *allocator_; // Allocator every request is forwarded to
+    };
+
+    class Storage;
+    using StoragePtr = std::shared_ptr<Storage>; // Reference-counted handle to a Storage
+
+    /**
+     * @class Storage
+     * @brief A reference-counted, aligned byte buffer shared by a tensor and all of its views.
+     *
+     * A Storage knows nothing about shape or element type; tensors and views pair it with a TensorMetadata.
+     * The buffer is returned to its allocator when the last StoragePtr referencing it is released.
+     * Always create instances through Storage::Create.
+     * **/
+    class Storage {
+        struct PrivateTag {};
+    public:
+        /**
+         * @brief Allocates a new shared storage buffer.
+         * @param bytes The size of the buffer in bytes.
+         * @param allocator The allocator that provides the buffer and the reference count block.
+         * @param alignment The alignment of the buffer (default is NextMemory::DefaultAlignment).
+         * @return A StoragePtr owning the new buffer.
+         * @throws std::bad_alloc if the allocation fails.
+         * **/
+        [[nodiscard]] static StoragePtr Create(size_t bytes, Allocator &allocator = GetDefaultAllocator(), size_t alignment = DefaultAlignment) {
+            return std::allocate_shared<Storage>(StdAllocatorAdapter<Storage>(allocator), PrivateTag{}, bytes, allocator, alignment);
+        }
+
+        Storage(PrivateTag, size_t bytes, Allocator &allocator, size_t alignment)
+            : allocator_(allocator), bytes_(bytes), alignment_(alignment),
+              data_(allocator.Allocate(bytes, alignment)) {}
+
+        ~Storage() { allocator_.Deallocate(data_, bytes_, alignment_); }
+        Storage(const Storage&) = delete;
+        Storage& operator=(const Storage&) = delete;
+
+        /**
+         * @brief Returns the start of the buffer.
+         * @return The raw pointer to the buffer.
+         * **/
+        [[nodiscard]] void *GetData() noexcept { return data_; }
+
+        /**
+         * @brief Returns the start of the buffer.
+         * @return The raw pointer to the buffer.
+         * Note: Const version read-only access.
+         * **/
+        [[nodiscard]] const void *GetData() const noexcept { return data_; }
+
+        /**
+         * @brief Returns the size of the buffer.
+         * @return The size of the buffer in bytes.
+         * **/
+        [[nodiscard]] size_t GetSize() const noexcept { return bytes_; }
+
+        /**
+         * @brief Returns the allocator that owns the buffer.
+         * @return A reference to the allocator.
+         * **/
+        [[nodiscard]] Allocator &GetAllocator() const noexcept { return allocator_; }
+
+    private:
+        Allocator &allocator_; // Allocator that owns the buffer
+        size_t bytes_;         // Size of the buffer in bytes
+        size_t alignment_;     // Alignment of the buffer
+        void *data_;           // Start of the buffer
+    };
+}
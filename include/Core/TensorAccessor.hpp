@@ -1,6 +1,132 @@
 #pragma once
 
+#include "TensorInterface.hpp"
+#include <type_traits> // std::conditional_t, std::is_const_v, std::remove_const_t
+
 namespace NextTensor
 {
-    
-}
\ No newline at end of file
+    /**
+     * @class TensorAccessor
+     * @brief A typed, non-owning accessor for strided element access with a compile-time rank.
+     * @tparam T The element type (use a const type for read-only access).
+     * @tparam Rank The rank (number of dimensions) of the accessed tensor.
+     *
+     * The accessor caches the data pointer (already advanced by the metadata offset), the shape and the
+     * strides in fixed-size arrays, so operator() is a plain multiply-add over Rank indices:
+     * no virtual calls, no heap-allocated index vectors. It uses the constexpr NextUtils::FlattenIndex<Rank>.
+     * The accessor does not extend the lifetime of the tensor it was created from.
+     * **/
+    template <typename T, TensorRank Rank>
+    class TensorAccessor {
+        using TensorReference = std::conditional_t<std::is_const_v<T>, const TensorInterface &, TensorInterface &>;
+    public:
+        // Constructor
+
+        /**
+         * @brief TensorAccessor Constructor with Data pointer and Metadata params
+         * @param data: Pointer to the start of the underlying buffer (the metadata offset is applied)
+         * @param metadata: Metadata describing the tensor inside the buffer
+         * @throws std::invalid_argument if the metadata rank does not match Rank or the layout is channel-blocked
+         * **/
+        TensorAccessor(T *data, const TensorMetadata &metadata)
+            : data_(data + metadata.GetOffset()) {
+            if (metadata.GetRank() != Rank) {
+                throw std::invalid_argument("TensorAccessor rank does not match the tensor's rank.");
+            }
+            NextMetadata::CheckStridedLayout(metadata, "TensorAccessor");
+            for (size_t i = 0; i < Rank; ++i) {
+                shape_[i] = metadata.GetShape()[i];
+                strides_[i] = metadata.GetStrides()[i];
+            }
+        }
+
+        /**
+         * @brief TensorAccessor Constructor with Tensor param
+         * @param tensor: Tensor to access (TensorStatic, TensorDynamic, TensorView, ...)
+         * @throws std::invalid_argument if the tensor data type does not match T or the rank does not match Rank
+         * **/
+        explicit TensorAccessor(TensorReference tensor)
+            : TensorAccessor(CheckedData(tensor), tensor.GetMetadata()) {}
+
+        /**
+         * @brief Accesses the element at the given indices.
+         * @param indices: One index per dimension
+         * @return A reference to the element.
+         * **/
+        template <typename... Indices>
+        [[nodiscard]] T &operator()(Indices... indices) const noexcept {
+            static_assert(sizeof...(Indices) == Rank, "TensorAccessor requires exactly one index per dimension.");
+            return data_[NextUtils::FlattenIndex<Rank>(strides_, TensorIndexStatic<Rank>{static_cast<TensorIndex>(indices)...})];
+        }
+
+        /**
+         * @brief Accesses the element at the given index array.
+         * @param indices: One index per dimension
+         * @return A reference to the element.
+         * **/
+        [[nodiscard]] T &operator[](const TensorIndexStatic<Rank> &indices) const noexcept {
+            return data_[NextUtils::FlattenIndex<Rank>(strides_, indices)];
+        }
+
+        /**
+         * @brief Returns the pointer to the first element (offset applied).
+         * @return The typed pointer to the first element.
+         * **/
+        [[nodiscard]] T *GetData() const noexcept { return data_; }
+
+        /**
+         * @brief Gets the shape of the accessed tensor.
+         * @return A reference to the static shape array.
+         * **/
+        [[nodiscard]] const TensorShapeStatic<Rank> &GetShape() const noexcept { return shape_; }
+
+        /**
+         * @brief Gets the strides of the accessed tensor.
+         * @return A reference to the static stride array.
+         * **/
+        [[nodiscard]] const TensorStrideStatic<Rank> &GetStrides() const noexcept { return strides_; }
+
+        /**
+         * @brief Gets the size of one dimension.
+         * @param dim The dimension.
+         * @return The number of elements along dim.
+         * **/
+        [[nodiscard]] TensorSize GetSize(size_t dim) const noexcept { return shape_[dim]; }
+
+    private:
+        static T *CheckedData(TensorReference tensor) {
+            if (tensor.GetDataType() != NextTypes::GetDTypeFromTemplate<std::remove_const_t<T>>()) {
+                throw std::invalid_argument("TensorAccessor element type does not match the tensor's data type.");
+            }
+            return static_cast<T *>(tensor.GetRawData());
+        }
+
+        T *data_;                            // Pointer to the first element (offset applied)
+        TensorShapeStatic<Rank> shape_{};    // Shape of the accessed tensor
+        TensorStrideStatic<Rank> strides_{}; // Strides of the accessed tensor
+    };
+
+    /**
+     * @brief Creates a read-write accessor for a tensor.
+     * @tparam T The element type.
+     * @tparam Rank The rank of the tensor.
+     * @param tensor The tensor to access.
+     * @return A TensorAccessor<T, Rank>.
+     * **/
+    template <typename T, TensorRank Rank>
+    [[nodiscard]] TensorAccessor<T, Rank> MakeAccessor(TensorInterface &tensor) {
+        return TensorAccessor<T, Rank>(tensor);
+    }
+
+    /**
+     * @brief Creates a read-only accessor for a tensor.
+     * @tparam T The element type.
+     * @tparam Rank The rank of the tensor.
+     * @param tensor The tensor to access.
+     * @return A TensorAccessor<const T, Rank>.
+     * **/
+    template <typename T, TensorRank Rank>
+    [[nodiscard]] TensorAccessor<const T, Rank> MakeAccessor(const TensorInterface &tensor) {
+        return TensorAccessor<const T, Rank>(tensor);
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "TensorInterface.hpp"
+#include "Memory/Storage.hpp"
+#include <type_traits> // std::is_trivially_copyable_v
+
+namespace NextTensor
+{
+
+    /**
+     * @class TensorDynamic
+     * @brief A class representing a tensor whose shape is only known at runtime, inheriting from TensorInterface.
+     *
+     * The data buffer is requested from a NextMemory::Allocator and is always aligned to
+     * NextMemory::DefaultAlignment (64 bytes), so SIMD kernels can use aligned loads on contiguous tensors.
+     * By default buffers come from the pooled default allocator, which makes repeated allocations of
+     * similar sizes (e.g. a changing batch size) cheap.
+     * The buffer lives in a reference-counted NextMemory::Storage, so views created from the tensor
+     * (see TensorView) keep it alive without copying. The buffer is left uninitialized.
+     */
+    template <typename T>
+    class TensorDynamic : public TensorInterface {
+        static_assert(std::is_trivially_copyable_v<T>, "TensorDynamic only supports trivially copyable element types.");
+    public:
+        ~TensorDynamic() override = default;
+        TensorDynamic(const TensorDynamic&) = delete;
+        TensorDynamic& operator=(const TensorDynamic&) = delete;
+        TensorDynamic(TensorDynamic&&) noexcept = default;
+        TensorDynamic& operator=(TensorDynamic&&) noexcept = default;
+
+        // Constructor
+
+        /**
+         * @brief TensorDynamic Constructor with Shape param
+         * @param shape: Shape of the tensor
+         * @param allocator: Allocator that provides the data buffer (default is the pooled allocator)
+         * @throws std::bad_alloc if the allocation fails
+         * **/
+        explicit TensorDynamic(const TensorShapeDynamic &shape, NextMemory::Allocator &allocator = NextMemory::GetDefaultAllocator())
+            : metadata_(shape),
+              dtype_(NextTypes::GetDTypeFromTemplate<T>()),
+              storage_(AllocateStorage(metadata_, allocator)),
+              data_(static_cast<T *>(storage_->GetData())) {}
+
+        /**
+         * @brief TensorDynamic Constructor with Metadata param
+         * The buffer is sized to cover every element addressed by the metadata (offset and strides included).
+         * @param metadata: Metadata of the tensor
+         * @param allocator: Allocator that provides the data buffer (default is the pooled allocator)
+         * @throws std::bad_alloc if the allocation fails
+         * **/
+        explicit TensorDynamic(const TensorMetadata &metadata, NextMemory::Allocator &allocator = NextMemory::GetDefaultAllocator())
+            : metadata_(metadata),
+              dtype_(NextTypes::GetDTypeFromTemplate<T>()),
+              storage_(AllocateStorage(metadata_, allocator)),
+              data_(static_cast<T *>(storage_->GetData())) {}
+
+        // Interface implementations
+        /**
+         * @brief Returns the metadata of the tensor (shape, strides, offset, etc.).
+         * Note: Implementation of TensorInterface virtual function
+         * @return A constant reference to the TensorMetadata object.
+         * **/
+        [[nodiscard]] const TensorMetadata &GetMetadata() const noexcept override { return metadata_; }
+
+        /**
+         * @brief Returns the Data Type of the Tensor elements.
+         * Note: Implementation of TensorInterface virtual function
+         * @return The DataType of the tensor elements.
+         * **/
+        [[nodiscard]] DataType GetDataType() const noexcept override { return dtype_; }
+
+        /**
+         * @brief Returns the Raw pointer of the tensor data buffer.
+         * Note: Implementation of TensorInterface virtual function
+         * @return The Raw pointer to the Tensor data.
+         * **/
+        void *GetRawData() noexcept override { return data_; }
+
+        /**
+         * @brief Returns The Raw pointer of the Tensor data buffer.
+         * Note: Implementation of TensorInterface virtual function
+         * @return The Raw pointer to the Tensor data.
+         * Note: Const version read-only access.
+         * **/
+        [[nodiscard]] const void *GetRawData() const noexcept override { return data_; }
+
+        /**
+         * @brief Returns the typed pointer of the tensor data buffer.
+         * @return The typed pointer to the Tensor data.
+         * **/
+        [[nodiscard]] T *GetData() noexcept { return data_; }
+
+        /**
+         * @brief Returns the typed pointer of the tensor data buffer.
+         * @return The typed pointer to the Tensor data.
+         * Note: Const version read-only access.
+         * **/
+        [[nodiscard]] const T *GetData() const noexcept { return data_; }
+
+        /**
+         * @brief Returns the number of elements the data buffer can hold.
+         * @return The capacity of the buffer in elements.
+         * **/
+        [[nodiscard]] TensorSize GetCapacity() const noexcept { return storage_->GetSize() / sizeof(T); }
+
+        /**
+         * @brief Returns the shared storage that holds the tensor data.
+         * @return A StoragePtr sharing ownership of the buffer.
+         * **/
+        [[nodiscard]] const NextMemory::StoragePtr &GetStorage() const noexcept { return storage_; }
+
+    private:
+        static NextMemory::StoragePtr AllocateStorage(const TensorMetadata &metadata, NextMemory::Allocator &allocator) {
+            const TensorSize capacity = NextUtils::ComputeStorageSize(metadata.GetShape(), metadata.GetStrides(), metadata.GetOffset());
+            return NextMemory::Storage::Create(capacity * sizeof(T), allocator);
+        }
+
+        TensorMetadata metadata_;            // Metadata of the tensor (shape, strides, offset, etc.)
+        DataType dtype_;                     // Data type of the tensor elements
+        NextMemory::StoragePtr storage_;     // Shared storage that owns the data buffer
+        T *data_;                            // Cached typed pointer to the start of the storage
+    };
+}
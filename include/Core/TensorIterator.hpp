@@ -0,0 +1,211 @@
+#pragma once
+
+#include "TensorMetadata.hpp"
+#include <array>   // std::array
+#include <utility> // std::swap
+#include <type_traits> // std::enable_if_t
+
+using TensorMetadata = NextMetadata::TensorMetadata;
+
+namespace NextTensor
+{
+    /**
+     * @class TensorIterator
+     * @brief An N-dimensional iteration engine for elementwise loops over one or more strided tensors.
+     * @tparam NumOperands The number of operands iterated together (operand 0 is usually the output).
+     *
+     * At construction the iterator:
+     * - drops dimensions of size 1,
+     * - reorders the remaining dimensions so the one with the smallest stride of operand 0 is innermost,
+     * - merges adjacent dimensions whose strides are compatible for every operand
+     *   (stride[outer] == stride[inner] * shape[inner]).
+     * A contiguous tensor therefore collapses to a single dimension, and a slice of a matrix to two.
+     *
+     * Kernels receive the longest possible inner run: the element offset of every operand (metadata offset included),
+     * the inner stride of every operand and the run length. The outer loop advances the offsets incrementally,
+     * so there is no divide or modulo per element; only ForEachRange does one unflatten of its start position.
+     *
+     * All operands must have the same shape (broadcast inputs beforehand with zero strides) and a strided layout
+     * (channel-blocked tensors go through Reorder first).
+     * **/
+    template <size_t NumOperands>
+    class TensorIterator {
+        static_assert(NumOperands > 0, "TensorIterator requires at least one operand.");
+    public:
+        using Offsets = std::array<TensorOffset, NumOperands>; // Element offset of every operand
+        using Strides = std::array<TensorSize, NumOperands>;   // Inner stride of every operand
+
+        // Constructor
+
+        /**
+         * @brief TensorIterator Constructor with Metadata params
+         * @param operands: Metadata of every operand, in order
+         * @throws std::invalid_argument if the operand shapes differ or an operand is channel-blocked
+         * **/
+        explicit TensorIterator(const std::array<const TensorMetadata *, NumOperands> &operands) {
+            const TensorShapeDynamic &shape = operands[0]->GetShape();
+            for (size_t op = 0; op < NumOperands; ++op) {
+                if (operands[op]->GetShape() != shape) {
+                    throw std::invalid_argument("TensorIterator operands must have the same shape.");
+                }
+                NextMetadata::CheckStridedLayout(*operands[op], "TensorIterator");
+                baseOffsets_[op] = operands[op]->GetOffset();
+            }
+            totalSize_ = NextUtils::ComputeSize(shape);
+
+            // Keep the dimensions that actually advance (size > 1)
+            TensorIndexDynamic dims;
+            for (size_t d = 0; d < shape.size(); ++d) {
+                if (shape[d] != 1) dims.push_back(d);
+            }
+
+            // Order dimensions by decreasing stride of operand 0 (stable, so ties keep their order)
+            const TensorStrideDynamic &leadStrides = operands[0]->GetStrides();
+            for (size_t i = 1; i < dims.size(); ++i) {
+                for (size_t j = i; j > 0 && leadStrides[dims[j - 1]] < leadStrides[dims[j]]; --j) {
+                    std::swap(dims[j - 1], dims[j]);
+                }
+            }
+
+            // Coalesce from the innermost dimension outwards
+            for (size_t i = dims.size(); i-- > 0;) {
+                const size_t d = dims[i];
+                if (!shape_.empty()) {
+                    bool mergeable = true;
+                    for (size_t op = 0; op < NumOperands && mergeable; ++op) {
+                        mergeable = operands[op]->GetStrides()[d] == strides_[op].front() * shape_.front();
+                    }
+                    if (mergeable) {
+                        shape_.front() *= shape[d];
+                        continue;
+                    }
+                }
+                shape_.insert(shape_.begin(), shape[d]);
+                for (size_t op = 0; op < NumOperands; ++op) {
+                    strides_[op].insert(strides_[op].begin(), operands[op]->GetStrides()[d]);
+                }
+            }
+
+            // Scalars and all-ones shapes iterate as a single element
+            if (shape_.empty()) {
+                shape_.push_back(1);
+                for (size_t op = 0; op < NumOperands; ++op) strides_[op].push_back(0);
+            }
+        }
+
+        /**
+         * @brief TensorIterator Constructor with a list of Metadata params
+         * @param first: Metadata of operand 0
+         * @param rest: Metadata of the remaining operands
+         * @throws std::invalid_argument if the operand shapes differ or an operand is channel-blocked
+         * **/
+        template <typename... Rest, typename = std::enable_if_t<sizeof...(Rest) + 1 == NumOperands>>
+        explicit TensorIterator(const TensorMetadata &first, const Rest &...rest)
+            : TensorIterator(std::array<const TensorMetadata *, NumOperands>{&first, &rest...}) {}
+
+        /**
+         * @brief Gets the number of dimensions left after coalescing (at least 1).
+         * @return The coalesced rank.
+         * **/
+        [[nodiscard]] TensorRank GetRank() const noexcept { return shape_.size(); }
+
+        /**
+         * @brief Gets the coalesced shape (outermost first).
+         * @return A reference to the coalesced shape.
+         * **/
+        [[nodiscard]] const TensorShapeDynamic &GetShape() const noexcept { return shape_; }
+
+        /**
+         * @brief Gets the coalesced strides of one operand.
+         * @param op The operand.
+         * @return A reference to the operand's coalesced strides.
+         * **/
+        [[nodiscard]] const TensorStrideDynamic &GetStrides(size_t op) const noexcept { return strides_[op]; }
+
+        /**
+         * @brief Gets the length of the innermost run.
+         * @return The number of elements of the innermost coalesced dimension.
+         * **/
+        [[nodiscard]] TensorSize GetInnerSize() const noexcept { return shape_.back(); }
+
+        /**
+         * @brief Gets the inner stride of every operand.
+         * @return The strides of the innermost coalesced dimension.
+         * **/
+        [[nodiscard]] Strides GetInnerStrides() const noexcept {
+            Strides inner{};
+            for (size_t op = 0; op < NumOperands; ++op) inner[op] = strides_[op].back();
+            return inner;
+        }
+
+        /**
+         * @brief Gets the total number of elements iterated.
+         * @return The number of elements.
+         * **/
+        [[nodiscard]] TensorSize GetTotalSize() const noexcept { return totalSize_; }
+
+        /**
+         * @brief Runs a kernel over every element.
+         * @param kernel: Callable as kernel(const Offsets &offsets, const Strides &innerStrides, TensorSize count)
+         * **/
+        template <typename Kernel>
+        void ForEach(Kernel &&kernel) const {
+            ForEachRange(0, totalSize_, kernel);
+        }
+
+        /**
+         * @brief Runs a kernel over the elements at linear positions [begin, end) in iteration order.
+         * Disjoint ranges touch disjoint output elements, so ranges can be processed by different threads.
+         * @param begin: First linear position
+         * @param end: One past the last linear position
+         * @param kernel: Callable as kernel(const Offsets &offsets, const Strides &innerStrides, TensorSize count)
+         * **/
+        template <typename Kernel>
+        void ForEachRange(TensorSize begin, TensorSize end, Kernel &&kernel) const {
+            if (end > totalSize_) end = totalSize_;
+            if (begin >= end) return;
+
+            const size_t rank = shape_.size();
+            const TensorSize innerSize = shape_.back();
+            const Strides innerStrides = GetInnerStrides();
+
+            // Locate the start position once
+            TensorIndexDynamic counter(rank, 0);
+            TensorSize innerIndex = begin % innerSize;
+            TensorSize outerLinear = begin / innerSize;
+            for (size_t d = rank - 1; d-- > 0;) {
+                counter[d] = outerLinear % shape_[d];
+                outerLinear /= shape_[d];
+            }
+            Offsets offsets = baseOffsets_;
+            for (size_t op = 0; op < NumOperands; ++op) {
+                for (size_t d = 0; d + 1 < rank; ++d) offsets[op] += counter[d] * strides_[op][d];
+            }
+
+            TensorSize remaining = end - begin;
+            while (true) {
+                Offsets runOffsets = offsets;
+                for (size_t op = 0; op < NumOperands; ++op) runOffsets[op] += innerIndex * innerStrides[op];
+                const TensorSize count = (innerSize - innerIndex < remaining) ? innerSize - innerIndex : remaining;
+                kernel(static_cast<const Offsets &>(runOffsets), innerStrides, count);
+                remaining -= count;
+                if (remaining == 0) break;
+
+                // Advance the outer counter like an odometer
+                innerIndex = 0;
+                for (size_t d = rank - 1; d-- > 0;) {
+                    for (size_t op = 0; op < NumOperands; ++op) offsets[op] += strides_[op][d];
+                    if (++counter[d] < shape_[d]) break;
+                    for (size_t op = 0; op < NumOperands; ++op) offsets[op] -= shape_[d] * strides_[op][d];
+                    counter[d] = 0;
+                }
+            }
+        }
+
+    private:
+        TensorShapeDynamic shape_;                             // Coalesced shape, outermost first
+        std::array<TensorStrideDynamic, NumOperands> strides_; // Coalesced strides of every operand
+        Offsets baseOffsets_{};                                // Metadata offset of every operand
+        TensorSize totalSize_ = 0;                             // Number of elements iterated
+    };
+}
@@ -1,22 +1,29 @@
 #pragma once
 
 #include "../Utils/NextUtils.hpp"
+#include "../Utils/NextTypes/NextMemoryLayout.hpp"
+#include <string> // std::string
 
 
 namespace NextMetadata
 {
     /** 
      * @brief A class to hold metadata about a tensor, including its shape, strides, offset, total size, and contiguity.
-     * Functions : Getters, Setters, Print
+     * Channel-blocked layouts (see NextTypes::MemoryLayout) keep the logical shape [N, C, ...]; the channel stride is
+     * then the stride inside a block and GetBlockStride() the stride between blocks, so element offsets must be
+     * computed with GetElementOffset rather than from the strides alone.
+     * Functions : Getters, Setters, GetElementOffset, GetStorageSize
      * **/
     class TensorMetadata {
     protected:
-        TensorShapeDynamic shape_;    // Shape of the tensor (e.g., {2, 3, 4} for a 2x3x4 tensor) TensorShapeDynamic = std::vector<size_t>
-        TensorStrideDynamic strides_; // Strides of the tensor (e.g., {12, 4, 1} for a 2x3x4 tensor) TensorStrideDynamic = std::vector<size_t>
+        TensorShapeDynamic shape_;    // Shape of the tensor (e.g., {2, 3, 4} for a 2x3x4 tensor) TensorShapeDynamic = SmallVector<size_t, 8>
+        TensorStrideDynamic strides_; // Strides of the tensor (e.g., {12, 4, 1} for a 2x3x4 tensor) TensorStrideDynamic = SmallVector<size_t, 8>
         TensorOffset offset_;         // Offset in the underlying data array
         TensorSize totalSize_;        // Total number of elements in the tensor
         TensorRank rank_;             // Rank (number of dimensions) of the tensor
         bool isContiguous_;           // Whether the tensor is stored in contiguous memory
+        NextTypes::MemoryLayout layout_ = NextTypes::MemoryLayout::ROW_MAJOR; // Physical layout (strided views are ROW_MAJOR)
+        TensorSize blockStride_ = 0;  // Blocked layouts: stride between two channel blocks
     public:
     
         // Constructor
@@ -40,12 +47,60 @@ namespace NextMetadata
          * @param stride The strides of the tensor.
          * @param offset The offset in the underlying data array (default is 0).
          * @return A TensorMetadata object initialized with the given shape, strides, and offset.
+         * Note: Contiguity is derived from the strides (see NextUtils::ComputeContiguity).
          * **/
-        TensorMetadata(const TensorShapeDynamic &shape, TensorStrideDynamic &stride, TensorOffset offset = 0) noexcept
+        TensorMetadata(const TensorShapeDynamic &shape, const TensorStrideDynamic &stride, TensorOffset offset = 0)
             : shape_(shape), strides_(stride), offset_(offset){
+                if (strides_.size() != shape_.size()) {
+                    throw std::invalid_argument("Strides must match the tensor's rank.");
+                }
                 totalSize_ = NextUtils::ComputeSize(shape_);
                 rank_ = shape_.size();
-                isContiguous_ = true; // Assuming newly created tensors are contiguous
+                isContiguous_ = NextUtils::ComputeContiguity(shape_, strides_);
+        }
+
+        /**
+         * @brief Constructs the metadata of a dense tensor stored in a given memory layout.
+         * @param shape The logical shape of the tensor ([N, C, ...] for the blocked layouts).
+         * @param layout ROW_MAJOR, COLUMN_MAJOR (first dimension varies fastest), NCHW8C or NCHW16C.
+         * @param offset The offset in the underlying data array (default is 0).
+         * @return A TensorMetadata object describing the layout.
+         * @throws std::invalid_argument if the layout is UNKNOWN, or blocked with a rank below 2.
+         * **/
+        TensorMetadata(const TensorShapeDynamic &shape, NextTypes::MemoryLayout layout, TensorOffset offset = 0)
+            : TensorMetadata(shape, offset) {
+            layout_ = layout;
+            switch (layout) {
+                case NextTypes::MemoryLayout::ROW_MAJOR:
+                    break;
+                case NextTypes::MemoryLayout::COLUMN_MAJOR: {
+                    TensorSize stride = 1;
+                    for (size_t d = 0; d < rank_; ++d) {
+                        strides_[d] = stride;
+                        stride *= shape_[d];
+                    }
+                    isContiguous_ = NextUtils::ComputeContiguity(shape_, strides_);
+                    break;
+                }
+                case NextTypes::MemoryLayout::NCHW8C: case NextTypes::MemoryLayout::NCHW16C: {
+                    if (rank_ < 2) {
+                        throw std::invalid_argument("Channel-blocked layouts require a shape [N, C, ...].");
+                    }
+                    const TensorSize block = NextTypes::GetChannelBlock(layout);
+                    TensorSize stride = block;
+                    for (size_t d = rank_; d-- > 2;) {
+                        strides_[d] = stride;
+                        stride *= shape_[d];
+                    }
+                    blockStride_ = stride;
+                    strides_[1] = 1;
+                    strides_[0] = (shape_[1] + block - 1) / block * blockStride_;
+                    isContiguous_ = false;
+                    break;
+                }
+                default:
+                    throw std::invalid_argument("Unknown memory layout.");
+            }
         }
 
         /** 
@@ -82,10 +137,61 @@ namespace NextMetadata
 
         /** 
          * @brief Checks if the tensor is contiguous in memory.
+         * Contiguous means dense row-major order starting at the offset; views with permuted,
+         * sliced or zero strides are not contiguous.
          * @return True if the tensor is contiguous, false otherwise.
          * **/
         [[nodiscard]] bool IsContiguous() const noexcept { return isContiguous_; }
 
+        /**
+         * @brief Gets the physical layout of the tensor.
+         * @return The memory layout (ROW_MAJOR for tensors described by their strides alone).
+         * **/
+        [[nodiscard]] NextTypes::MemoryLayout GetLayout() const noexcept { return layout_; }
+
+        /**
+         * @brief Gets the channel block of a blocked layout.
+         * @return 8 or 16 for the blocked layouts, 0 otherwise.
+         * **/
+        [[nodiscard]] TensorSize GetChannelBlock() const noexcept { return NextTypes::GetChannelBlock(layout_); }
+
+        /**
+         * @brief Gets the stride between two channel blocks of a blocked layout.
+         * @return The stride, or 0 for the other layouts.
+         * **/
+        [[nodiscard]] TensorSize GetBlockStride() const noexcept { return blockStride_; }
+
+        /**
+         * @brief Computes the position of an element in the underlying data array (offset included), in any layout.
+         * @param index The logical index of the element (one entry per dimension).
+         * @return The element offset.
+         * **/
+        [[nodiscard]] TensorOffset GetElementOffset(const TensorIndexDynamic &index) const noexcept {
+            TensorOffset position = offset_;
+            const TensorSize block = GetChannelBlock();
+            for (size_t d = 0; d < rank_; ++d) {
+                if (block != 0 && d == 1) position += index[1] / block * blockStride_ + index[1] % block;
+                else position += index[d] * strides_[d];
+            }
+            return position;
+        }
+
+        /**
+         * @brief Computes the number of elements of the underlying data array addressed by the tensor, from its
+         * offset to its last element (the channel padding of the blocked layouts included).
+         * @return The number of elements a buffer must hold after the offset (0 for an empty tensor).
+         * **/
+        [[nodiscard]] TensorSize GetStorageSize() const noexcept {
+            if (GetChannelBlock() == 0) return NextUtils::ComputeStorageSize(shape_, strides_);
+            return totalSize_ == 0 ? 0 : shape_[0] * strides_[0];
+        }
+
+        /**
+         * @brief Sets the offset of the tensor (e.g. once its buffer has been placed).
+         * @param offset The new offset in the underlying data array.
+         * **/
+        void SetOffset(TensorOffset offset) noexcept { offset_ = offset; }
+
         /** 
          * @brief Sets the contiguity of the tensor.
          * @param contiguous True if the tensor is contiguous, false otherwise.
@@ -94,4 +200,17 @@ namespace NextMetadata
 
     };
 
+    /**
+     * @brief Rejects channel-blocked metadata in code that addresses elements through the strides alone.
+     * The channel stride of a blocked layout only moves inside a block, so such code would silently misread it.
+     * @param metadata The metadata to check.
+     * @param operation Name of the caller, for the error message.
+     * @throws std::invalid_argument if the layout is channel-blocked.
+     * **/
+    inline void CheckStridedLayout(const TensorMetadata &metadata, const char *operation) {
+        if (metadata.GetChannelBlock() != 0) {
+            throw std::invalid_argument(std::string(operation) + " does not support channel-blocked layouts; Reorder the tensor to a plain layout first.");
+        }
+    }
+
 }
\ No newline at end of file
@@ -1,8 +1,9 @@
 #pragma once 
 
 #include "TensorInterface.hpp"
-#include <memory> // std::unique_ptr
+#include "Memory/Storage.hpp"
 #include <array>  // std::array
+#include <type_traits> // std::is_trivially_copyable_v
 
 namespace NextTensor
 {
@@ -14,12 +15,15 @@ namespace NextTensor
      * This class is designed to handle tensors with a fixed shape and size at compile time, allowing for
      * optimizations in memory layout and access patterns. It provides methods for accessing and manipulating
      * the tensor data, as well as retrieving metadata about the tensor.
-     * Handle data storage using std::array for fixed size arrays.
+     * Handle data storage as a fixed size array of N elements obtained from a NextMemory::Allocator
+     * (the pooled default allocator, or e.g. a per-pass ArenaAllocator for scratch tensors).
+     * The array is value-initialized and lives in a reference-counted NextMemory::Storage that views can share.
      */
     template <typename T, TensorSize N> // TensorSize = size_t
     class TensorStatic : public TensorInterface {
+        static_assert(std::is_trivially_copyable_v<T>, "TensorStatic only supports trivially copyable element types.");
     public:
-        ~TensorStatic() = default;
+        ~TensorStatic() override = default;
         TensorStatic(const TensorStatic&) = delete;
         TensorStatic& operator=(const TensorStatic&) = delete;
         // Constructor
@@ -27,20 +31,24 @@ namespace NextTensor
         /** 
          * @brief TensorStatic Constructor with Shape param
          * @param shape: Shape of the tensor
+         * @param allocator: Allocator that provides the data array (default is the pooled allocator)
          * **/
-        TensorStatic(const TensorShapeStatic<N> &shape)
-            : metadata_(shape),
+        TensorStatic(const TensorShapeStatic<N> &shape, NextMemory::Allocator &allocator = NextMemory::GetDefaultAllocator())
+            : metadata_(TensorShapeDynamic(shape.begin(), shape.end())),
               dtype_(NextTypes::GetDTypeFromTemplate<T>()),
-              data_(std::make_unique<std::array<T, N>>()) {}
+              storage_(NextMemory::Storage::Create(sizeof(std::array<T, N>), allocator, ArrayAlignment)),
+              data_(new (storage_->GetData()) std::array<T, N>()) {} // Value-initialize the elements
 
         /** 
          * @brief TensorStatic Constructor with Metadata param
          * @param metadata: Metadata of the tensor
+         * @param allocator: Allocator that provides the data array (default is the pooled allocator)
          * **/
-        TensorStatic(const TensorMetadata &metadata)
+        TensorStatic(const TensorMetadata &metadata, NextMemory::Allocator &allocator = NextMemory::GetDefaultAllocator())
             : metadata_(metadata),
               dtype_(NextTypes::GetDTypeFromTemplate<T>()),
-              data_(std::make_unique<std::array<T, N>>()) {}
+              storage_(NextMemory::Storage::Create(sizeof(std::array<T, N>), allocator, ArrayAlignment)),
+              data_(new (storage_->GetData()) std::array<T, N>()) {} // Value-initialize the elements
 
         // Interface implementations
         /** 
@@ -62,7 +70,7 @@ namespace NextTensor
          * Note: Implementation of TensorInterface virtual function
          * @return The Raw pointer to the Tensor data.
          * **/
-        void *GetRawData() noexcept override { return data_.get(); }
+        void *GetRawData() noexcept override { return data_; }
 
         /** 
          * @brief Returns The Raw pointer of the Tensor data array.
@@ -70,11 +78,20 @@ namespace NextTensor
          * @return The Raw pointer to the Tensor data.
          * Note: Const version read-only access.
          * **/
-        [[nodiscard]] const void *GetRawData() const noexcept override { return data_.get(); }
+        [[nodiscard]] const void *GetRawData() const noexcept override { return data_; }
+
+        /**
+         * @brief Returns the shared storage that holds the tensor data.
+         * @return A StoragePtr sharing ownership of the array.
+         * **/
+        [[nodiscard]] const NextMemory::StoragePtr &GetStorage() const noexcept { return storage_; }
 
     private:
-        TensorMetadata metadata_; // Metadata of the tensor (shape, strides, offset, etc.)
-        DataType dtype_;          // Data type of the tensor elements
-        std::unique_ptr<std::array<T, N>> data_; // Unique pointer to the tensor data array        
+        static constexpr size_t ArrayAlignment = alignof(std::array<T, N>) > NextMemory::DefaultAlignment ? alignof(std::array<T, N>) : NextMemory::DefaultAlignment;
+
+        TensorMetadata metadata_;            // Metadata of the tensor (shape, strides, offset, etc.)
+        DataType dtype_;                     // Data type of the tensor elements
+        NextMemory::StoragePtr storage_;     // Shared storage that owns the data array
+        std::array<T, N> *data_;             // Pointer to the tensor data array inside the storage
     };
 }
\ No newline at end of file
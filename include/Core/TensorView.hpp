@@ -0,0 +1,149 @@
+#pragma once
+
+#include "TensorInterface.hpp"
+#include "Memory/Storage.hpp"
+#include "../Utils/NextShapeUtils.hpp"
+#include <utility> // std::move
+
+namespace NextTensor
+{
+
+    /**
+     * @class TensorView
+     * @brief A tensor that shares the storage of another tensor under its own metadata, inheriting from TensorInterface.
+     *
+     * A view pairs a reference-counted NextMemory::Storage with a TensorMetadata (shape, strides, offset).
+     * Creating a view never copies element data: Slice, Reshape, Permute, Transpose, Squeeze and Unsqueeze
+     * only run the corresponding NextShapeUtils function on the metadata, which costs O(rank).
+     * The storage stays alive as long as any tensor or view references it.
+     * Like every tensor, GetRawData returns the start of the storage; the metadata offset locates the first element.
+     */
+    class TensorView : public TensorInterface {
+    public:
+        ~TensorView() override = default;
+        TensorView(const TensorView&) = default;
+        TensorView& operator=(const TensorView&) = default;
+        TensorView(TensorView&&) noexcept = default;
+        TensorView& operator=(TensorView&&) noexcept = default;
+
+        // Constructor
+
+        /**
+         * @brief TensorView Constructor with Storage, Metadata and DataType params
+         * @param storage: Shared storage the view reads from
+         * @param metadata: Metadata describing the view inside the storage
+         * @param dtype: Data type of the elements
+         * @throws std::invalid_argument if the storage is null or the data type is unknown
+         * @throws std::out_of_range if the metadata addresses elements outside the storage
+         * **/
+        TensorView(NextMemory::StoragePtr storage, const TensorMetadata &metadata, DataType dtype)
+            : metadata_(metadata), dtype_(dtype), storage_(std::move(storage)) {
+            if (!storage_) {
+                throw std::invalid_argument("TensorView requires a storage.");
+            }
+            const size_t elementSize = NextTypes::GetDataTypeSize(dtype_);
+            if (elementSize == 0) {
+                throw std::invalid_argument("TensorView requires a known data type.");
+            }
+            const TensorSize required = NextUtils::ComputeStorageSize(metadata_.GetShape(), metadata_.GetStrides(), metadata_.GetOffset());
+            if (required * elementSize > storage_->GetSize()) {
+                throw std::out_of_range("View metadata addresses elements outside of the storage.");
+            }
+        }
+
+        // Interface implementations
+        /**
+         * @brief Returns the metadata of the view (shape, strides, offset, etc.).
+         * Note: Implementation of TensorInterface virtual function
+         * @return A constant reference to the TensorMetadata object.
+         * **/
+        [[nodiscard]] const TensorMetadata &GetMetadata() const noexcept override { return metadata_; }
+
+        /**
+         * @brief Returns the Data Type of the view elements.
+         * Note: Implementation of TensorInterface virtual function
+         * @return The DataType of the elements.
+         * **/
+        [[nodiscard]] DataType GetDataType() const noexcept override { return dtype_; }
+
+        /**
+         * @brief Returns the Raw pointer of the shared storage.
+         * Note: Implementation of TensorInterface virtual function
+         * @return The Raw pointer to the start of the storage.
+         * **/
+        void *GetRawData() noexcept override { return storage_->GetData(); }
+
+        /**
+         * @brief Returns the Raw pointer of the shared storage.
+         * Note: Implementation of TensorInterface virtual function
+         * @return The Raw pointer to the start of the storage.
+         * Note: Const version read-only access.
+         * **/
+        [[nodiscard]] const void *GetRawData() const noexcept override { return storage_->GetData(); }
+
+        /**
+         * @brief Returns the shared storage of the view.
+         * @return A StoragePtr sharing ownership of the buffer.
+         * **/
+        [[nodiscard]] const NextMemory::StoragePtr &GetStorage() const noexcept { return storage_; }
+
+        // View operations (zero-copy)
+
+        /**
+         * @brief Returns a view of the elements in [startIndices, endIndices). See NextShapeUtils::NextSlice.
+         * **/
+        [[nodiscard]] TensorView Slice(const TensorIndexDynamic &startIndices, const TensorIndexDynamic &endIndices) const {
+            return TensorView(storage_, NextShapeUtils::NextSlice(metadata_, startIndices, endIndices), dtype_);
+        }
+
+        /**
+         * @brief Returns a view with a new shape. See NextShapeUtils::NextReshape.
+         * **/
+        [[nodiscard]] TensorView Reshape(const TensorShapeDynamic &newShape) const {
+            return TensorView(storage_, NextShapeUtils::NextReshape(metadata_, newShape), dtype_);
+        }
+
+        /**
+         * @brief Returns a view with permuted dimensions. See NextShapeUtils::NextPermute.
+         * **/
+        [[nodiscard]] TensorView Permute(const TensorIndexDynamic &permutation) const {
+            return TensorView(storage_, NextShapeUtils::NextPermute(metadata_, permutation), dtype_);
+        }
+
+        /**
+         * @brief Returns a view with reversed dimensions. See NextShapeUtils::NextTranspose.
+         * **/
+        [[nodiscard]] TensorView Transpose() const {
+            return TensorView(storage_, NextShapeUtils::NextTranspose(metadata_), dtype_);
+        }
+
+        /**
+         * @brief Returns a view without the given single-dimensional axes. See NextShapeUtils::NextSqueeze.
+         * **/
+        [[nodiscard]] TensorView Squeeze(const TensorIndexDynamic &axes = {}) const {
+            return TensorView(storage_, NextShapeUtils::NextSqueeze(metadata_, axes), dtype_);
+        }
+
+        /**
+         * @brief Returns a view with single-dimensional axes inserted. See NextShapeUtils::NextUnsqueeze.
+         * **/
+        [[nodiscard]] TensorView Unsqueeze(const TensorIndexDynamic &axes) const {
+            return TensorView(storage_, NextShapeUtils::NextUnsqueeze(metadata_, axes), dtype_);
+        }
+
+    private:
+        TensorMetadata metadata_;            // Metadata of the view (shape, strides, offset, etc.)
+        DataType dtype_;                     // Data type of the elements
+        NextMemory::StoragePtr storage_;     // Shared storage the view reads from
+    };
+
+    /**
+     * @brief Creates a view covering a whole tensor that owns a shared storage (TensorStatic, TensorDynamic, TensorView).
+     * @param tensor The tensor to view.
+     * @return A TensorView sharing the tensor's storage and metadata.
+     * **/
+    template <typename Tensor>
+    [[nodiscard]] TensorView MakeView(const Tensor &tensor) {
+        return TensorView(tensor.GetStorage(), tensor.GetMetadata(), tensor.GetDataType());
+    }
+}
@@ -12,54 +12,95 @@ namespace NextShapeUtils
      * @param startIndices The starting indices for the slice.
      * @param endIndices The ending indices for the slice.
      * @return A new TensorMetadata object representing the sliced tensor.
-     * @throws std::invalid_argument if start and end indices do not match the tensor's rank.
+     * @throws std::invalid_argument if start and end indices do not match the tensor's rank, or the layout is channel-blocked.
      * @throws std::out_of_range if start or end indices are out of bounds
      * **/
     inline TensorMetadata NextSlice(const TensorMetadata &Metadata, const TensorIndexDynamic &startIndices, const TensorIndexDynamic &endIndices) {
+        NextMetadata::CheckStridedLayout(Metadata, "NextSlice");
+
         // Validate start and end indices
         if (startIndices.size() != Metadata.GetShape().size() || endIndices.size() != Metadata.GetShape().size()) {
             throw std::invalid_argument("Start and end indices must match the tensor's rank.");
         }
 
-        // Compute new shape and strides
+        // Compute new shape, strides and the offset of the first sliced element
         TensorShapeDynamic newShape;
         TensorStrideDynamic newStrides;
+        TensorOffset newOffset = Metadata.GetOffset();
         for (size_t i = 0; i < Metadata.GetShape().size(); ++i) {
             if (startIndices[i] >= endIndices[i] || startIndices[i] >= Metadata.GetShape()[i] || endIndices[i] > Metadata.GetShape()[i]) {
                 throw std::out_of_range("Start or end indices are out of bounds.");
             }
             newShape.push_back(endIndices[i] - startIndices[i]);
             newStrides.push_back(Metadata.GetStrides()[i]);
+            newOffset += startIndices[i] * Metadata.GetStrides()[i];
         }
 
-        // Create new metadata with the sliced shape and strides
-        return TensorMetadata(newShape, Metadata.GetOffset());
+        // Create new metadata with the sliced shape, the parent strides and the shifted offset
+        return TensorMetadata(newShape, newStrides, newOffset);
 
     }
 
     /** 
      * @brief Reshapes a tensor given its metadata and a new shape.
+     * Contiguous tensors always reshape without a copy. For strided views the new strides are derived
+     * from the old ones when every group of merged/split dimensions is itself contiguous.
      * @param Metadata The metadata of the tensor.
      * @param newShape The new shape for the tensor.
      * @return A new TensorMetadata object representing the reshaped tensor.
-     * @throws std::invalid_argument if the total size does not match.
+     * @throws std::invalid_argument if the total size does not match, if the strided view cannot be reshaped without a copy,
+     * or if the layout is channel-blocked.
      * **/
     inline TensorMetadata NextReshape(const TensorMetadata &Metadata, const TensorShapeDynamic &newShape) {
+        NextMetadata::CheckStridedLayout(Metadata, "NextReshape");
+
         // Validate that the total size remains the same
         size_t oldSize = Metadata.GetTotalSize();
-        size_t newSize = 1;
-        for (const auto& dim : newShape) {
-            newSize *= dim;
-        }
+        size_t newSize = NextUtils::ComputeSize(newShape);
         if (oldSize != newSize) {
             throw std::invalid_argument("New shape must have the same total size as the original tensor.");
         }
 
-        // Compute new strides
-        TensorStrideDynamic newStrides = NextUtils::ComputeStrides(newShape);
+        // Contiguous (or empty) tensors: fresh row-major strides
+        if (Metadata.IsContiguous() || newSize == 0) {
+            return TensorMetadata(newShape, NextUtils::ComputeStrides(newShape), Metadata.GetOffset());
+        }
+
+        // Strided view: split the old dimensions into chunks that are contiguous with respect to themselves
+        // (innermost first) and lay the new dimensions out inside each chunk.
+        const TensorShapeDynamic &oldShape = Metadata.GetShape();
+        const TensorStrideDynamic &oldStrides = Metadata.GetStrides();
+        TensorStrideDynamic newStrides(newShape.size(), 1);
+
+        long viewDim = static_cast<long>(newShape.size()) - 1;
+        TensorSize chunkBaseStride = oldStrides.back();
+        TensorSize tensorElements = 1;
+        TensorSize viewElements = 1;
+        for (long tensorDim = static_cast<long>(oldShape.size()) - 1; tensorDim >= 0; --tensorDim) {
+            tensorElements *= oldShape[tensorDim];
+            // A chunk ends at the outermost dimension or where the next dimension is not contiguous with it
+            if (tensorDim == 0 || (oldShape[tensorDim - 1] != 1 && oldStrides[tensorDim - 1] != tensorElements * chunkBaseStride)) {
+                while (viewDim >= 0 && (viewElements < tensorElements || newShape[viewDim] == 1)) {
+                    newStrides[viewDim] = viewElements * chunkBaseStride;
+                    viewElements *= newShape[viewDim];
+                    --viewDim;
+                }
+                if (viewElements != tensorElements) {
+                    throw std::invalid_argument("Strided view cannot be reshaped without a copy.");
+                }
+                if (tensorDim > 0) {
+                    chunkBaseStride = oldStrides[tensorDim - 1];
+                    tensorElements = 1;
+                    viewElements = 1;
+                }
+            }
+        }
+        if (viewDim != -1) {
+            throw std::invalid_argument("Strided view cannot be reshaped without a copy.");
+        }
 
         // Create new metadata with the reshaped shape and computed strides
-        return TensorMetadata(newShape, Metadata.GetOffset());
+        return TensorMetadata(newShape, newStrides, Metadata.GetOffset());
     }
 
     /**
@@ -67,11 +108,12 @@ namespace NextShapeUtils
      * @param metadata The metadata of the tensor.
      * @param permutation The new order of dimensions.
      * @return A new TensorMetadata object representing the permuted tensor.
-     * @throws std::invalid_argument if the permutation is invalid.
+     * @throws std::invalid_argument if the permutation is invalid or the layout is channel-blocked.
      * **/
     inline TensorMetadata NextPermute(const TensorMetadata &Metadata, TensorIndexDynamic permutation = {}) {
-        TensorShapeDynamic originalShape = Metadata.GetShape();
-        TensorStrideDynamic originalStrides = Metadata.GetStrides();
+        NextMetadata::CheckStridedLayout(Metadata, "NextPermute");
+        const TensorShapeDynamic &originalShape = Metadata.GetShape();
+        const TensorStrideDynamic &originalStrides = Metadata.GetStrides();
 
         if (permutation.empty()) {
             // Case 1: Standard transpose (reverses the dimensions)
@@ -92,7 +134,14 @@ namespace NextShapeUtils
 
         for (size_t i = 0; i < permutation.size(); ++i) {
             size_t newIndex = permutation[i];
-            // You can add more checks here to ensure newIndex is valid and not a duplicate
+            if (newIndex >= originalShape.size()) {
+                throw std::invalid_argument("Permutation axis out of bounds.");
+            }
+            for (size_t j = 0; j < i; ++j) {
+                if (permutation[j] == newIndex) {
+                    throw std::invalid_argument("Permutation must not repeat an axis.");
+                }
+            }
             newShape[i] = originalShape[newIndex];
             newStrides[i] = originalStrides[newIndex];
         }
@@ -112,50 +161,52 @@ namespace NextShapeUtils
     //TODO: Review and Optimize Squeeze and UnSqueeze Functions
     /**
      * @brief Squeezes the dimensions of a tensor by removing single-dimensional entries.
+     * The strides and offset of the remaining dimensions are preserved.
      * @param metadata The metadata of the tensor.
      * @param axes The specific axes to squeeze. If empty, all single-dimensional axes are removed.
      * @return A new TensorMetadata object representing the squeezed tensor.
-     * @throws std::invalid_argument if any specified axis is out of bounds or not of size 1.
+     * @throws std::invalid_argument if any specified axis is out of bounds or not of size 1, or the layout is channel-blocked.
      * **/
     inline TensorMetadata NextSqueeze(const TensorMetadata &Metadata, TensorIndexDynamic axes = {}) {
+        NextMetadata::CheckStridedLayout(Metadata, "NextSqueeze");
+
         // Check if valid axes are provided
-        if (!axes.empty()) {
-            TensorShapeDynamic newShape;
-            TensorStrideDynamic newStrides;
-            for (const auto &axis : axes) {
-                if (axis >= Metadata.GetRank()) {
-                    throw std::invalid_argument("Axis out of bounds.");
-                }
-                if (Metadata.GetShape()[axis] != 1) {
-                    throw std::invalid_argument("Cannot squeeze axis that is not of size 1.");
-                }
-                // Proceed to create new shape and strides
-                for (size_t i = 0; i < Metadata.GetRank(); i++) {
-                    if (i == axis) continue; // Skip the specified axis
-                    newShape.push_back(Metadata.GetShape()[i]);
-                }
+        for (const auto &axis : axes) {
+            if (axis >= Metadata.GetRank()) {
+                throw std::invalid_argument("Axis out of bounds.");
+            }
+            if (Metadata.GetShape()[axis] != 1) {
+                throw std::invalid_argument("Cannot squeeze axis that is not of size 1.");
             }
-            return TensorMetadata(newShape, Metadata.GetOffset());
         }
-        else {
-            TensorShapeDynamic newShape;
-            TensorStrideDynamic newStrides;
-            for (size_t i = 0; i < Metadata.GetRank(); i++) {
-                if (Metadata.GetShape()[i] == 1) continue; // Skip single-dimensional axes
-                newShape.push_back(Metadata.GetShape()[i]);
+
+        // Proceed to create new shape and strides
+        TensorShapeDynamic newShape;
+        TensorStrideDynamic newStrides;
+        for (size_t i = 0; i < Metadata.GetRank(); i++) {
+            bool squeeze = false;
+            if (axes.empty()) {
+                squeeze = Metadata.GetShape()[i] == 1; // Skip single-dimensional axes
+            } else {
+                for (const auto &axis : axes) squeeze |= (axis == i); // Skip the specified axes
             }
-            return TensorMetadata(newShape, Metadata.GetOffset());
+            if (squeeze) continue;
+            newShape.push_back(Metadata.GetShape()[i]);
+            newStrides.push_back(Metadata.GetStrides()[i]);
         }
+        return TensorMetadata(newShape, newStrides, Metadata.GetOffset());
     }
 
     /**
      * @brief Unsqueezes the dimensions of a tensor by adding single-dimensional entries at specified axes.
+     * The axes are inserted in the given order; existing strides and the offset are preserved.
      * @param metadata The metadata of the tensor.
      * @param axes The specific axes to unsqueeze.
      * @return A new TensorMetadata object representing the unsqueezed tensor.
-     * @throws std::invalid_argument if any specified axis is out of bounds.
+     * @throws std::invalid_argument if any specified axis is out of bounds or the layout is channel-blocked.
      * **/
     inline TensorMetadata NextUnsqueeze(const TensorMetadata &Metadata, const TensorIndexDynamic &axes) {
+        NextMetadata::CheckStridedLayout(Metadata, "NextUnsqueeze");
         TensorShapeDynamic newShape = Metadata.GetShape();
         TensorStrideDynamic newStrides = Metadata.GetStrides();
 
@@ -163,8 +214,62 @@ namespace NextShapeUtils
             if (axis > newShape.size()) {
                 throw std::invalid_argument("Axis out of bounds.");
             }
+            // A size-1 dimension never advances; give it the stride a dense layout would have
+            const TensorSize stride = (axis < newShape.size()) ? newShape[axis] * newStrides[axis] : 1;
             newShape.insert(newShape.begin() + axis, 1);
+            newStrides.insert(newStrides.begin() + axis, stride);
+        }
+        return TensorMetadata(newShape, newStrides, Metadata.GetOffset());
+    }
+
+    /**
+     * @brief Computes the shape two tensors broadcast to (NumPy rules).
+     * Shapes are aligned at their last dimension; each pair of dimensions must be equal or one of them must be 1.
+     * @param lhs The shape of the first tensor.
+     * @param rhs The shape of the second tensor.
+     * @return The broadcast shape.
+     * @throws std::invalid_argument if the shapes are not broadcast-compatible.
+     * **/
+    inline TensorShapeDynamic NextBroadcastShape(const TensorShapeDynamic &lhs, const TensorShapeDynamic &rhs) {
+        const size_t rank = lhs.size() > rhs.size() ? lhs.size() : rhs.size();
+        TensorShapeDynamic result(rank);
+        for (size_t i = 0; i < rank; ++i) {
+            const TensorSize lhsDim = (i < rank - lhs.size()) ? 1 : lhs[i - (rank - lhs.size())];
+            const TensorSize rhsDim = (i < rank - rhs.size()) ? 1 : rhs[i - (rank - rhs.size())];
+            if (lhsDim != rhsDim && lhsDim != 1 && rhsDim != 1) {
+                throw std::invalid_argument("Shapes are not broadcast-compatible.");
+            }
+            result[i] = (lhsDim == 1) ? rhsDim : lhsDim;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Expands a tensor to a broadcast shape without copying.
+     * Missing leading dimensions and dimensions of size 1 that are expanded get a stride of 0,
+     * so every output position along them reads the same element.
+     * @param Metadata The metadata of the tensor.
+     * @param shape The target shape (e.g. from NextBroadcastShape).
+     * @return A new TensorMetadata object describing the expanded view.
+     * @throws std::invalid_argument if the tensor cannot be broadcast to the shape or its layout is channel-blocked.
+     * **/
+    inline TensorMetadata NextBroadcastTo(const TensorMetadata &Metadata, const TensorShapeDynamic &shape) {
+        NextMetadata::CheckStridedLayout(Metadata, "NextBroadcastTo");
+        const TensorShapeDynamic &originalShape = Metadata.GetShape();
+        const TensorStrideDynamic &originalStrides = Metadata.GetStrides();
+        if (originalShape.size() > shape.size()) {
+            throw std::invalid_argument("Cannot broadcast a tensor to a lower rank.");
+        }
+
+        const size_t leading = shape.size() - originalShape.size();
+        TensorStrideDynamic newStrides(shape.size(), 0);
+        for (size_t i = 0; i < originalShape.size(); ++i) {
+            if (originalShape[i] == shape[leading + i]) {
+                newStrides[leading + i] = originalStrides[i];
+            } else if (originalShape[i] != 1) {
+                throw std::invalid_argument("Shapes are not broadcast-compatible.");
+            }
         }
-        return TensorMetadata(newShape, Metadata.GetOffset());
+        return TensorMetadata(shape, newStrides, Metadata.GetOffset());
     }
-}
\ No newline at end of file
+}
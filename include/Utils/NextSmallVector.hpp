@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstddef>          // size_t
+#include <cstring>          // std::memcpy, std::memmove
+#include <algorithm>        // std::max, std::fill_n, std::equal
+#include <initializer_list> // std::initializer_list
+#include <iterator>         // std::distance
+#include <new>              // ::operator new
+#include <type_traits>      // std::is_trivially_copyable_v, std::enable_if_t, std::is_integral_v
+
+namespace NextUtils
+{
+    /**
+     * @class SmallVector
+     * @brief A vector with inline capacity for N elements that only touches the heap when it grows beyond N.
+     * @tparam T The element type (must be trivially copyable, e.g. size_t for shapes and strides).
+     * @tparam N The number of elements stored inline.
+     *
+     * Used for shapes, strides and index lists: tensors rarely exceed 8 dimensions, so copying metadata
+     * or building a permuted/squeezed shape is allocation-free. The interface is the subset of std::vector
+     * that the library uses (iterators are raw pointers).
+     * **/
+    template <typename T, size_t N>
+    class SmallVector {
+        static_assert(std::is_trivially_copyable_v<T>, "SmallVector only supports trivially copyable element types.");
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using iterator = T *;
+        using const_iterator = const T *;
+
+        // Constructors
+
+        SmallVector() noexcept = default;
+
+        /**
+         * @brief Constructs a vector of count value-initialized elements.
+         * @param count The number of elements.
+         * **/
+        explicit SmallVector(size_t count) { resize(count); }
+
+        /**
+         * @brief Constructs a vector of count copies of value.
+         * @param count The number of elements.
+         * @param value The value of every element.
+         * **/
+        SmallVector(size_t count, const T &value) { resize(count, value); }
+
+        /**
+         * @brief Constructs a vector from an initializer list.
+         * @param init The elements.
+         * **/
+        SmallVector(std::initializer_list<T> init) { assign(init.begin(), init.end()); }
+
+        /**
+         * @brief Constructs a vector from an iterator range.
+         * @param first The first element of the range.
+         * @param last One past the last element of the range.
+         * **/
+        template <typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+        SmallVector(InputIt first, InputIt last) { assign(first, last); }
+
+        SmallVector(const SmallVector &other) { assign(other.begin(), other.end()); }
+
+        SmallVector(SmallVector &&other) noexcept { MoveFrom(other); }
+
+        ~SmallVector() { FreeHeap(); }
+
+        SmallVector &operator=(const SmallVector &other) {
+            if (this != &other) assign(other.begin(), other.end());
+            return *this;
+        }
+
+        SmallVector &operator=(SmallVector &&other) noexcept {
+            if (this != &other) {
+                FreeHeap();
+                MoveFrom(other);
+            }
+            return *this;
+        }
+
+        SmallVector &operator=(std::initializer_list<T> init) {
+            assign(init.begin(), init.end());
+            return *this;
+        }
+
+        // Element access
+
+        [[nodiscard]] T &operator[](size_t i) noexcept { return data_[i]; }
+        [[nodiscard]] const T &operator[](size_t i) const noexcept { return data_[i]; }
+        [[nodiscard]] T &front() noexcept { return data_[0]; }
+        [[nodiscard]] const T &front() const noexcept { return data_[0]; }
+        [[nodiscard]] T &back() noexcept { return data_[size_ - 1]; }
+        [[nodiscard]] const T &back() const noexcept { return data_[size_ - 1]; }
+        [[nodiscard]] T *data() noexcept { return data_; }
+        [[nodiscard]] const T *data() const noexcept { return data_; }
+
+        // Iterators
+
+        [[nodiscard]] iterator begin() noexcept { return data_; }
+        [[nodiscard]] const_iterator begin() const noexcept { return data_; }
+        [[nodiscard]] iterator end() noexcept { return data_ + size_; }
+        [[nodiscard]] const_iterator end() const noexcept { return data_ + size_; }
+
+        // Capacity
+
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+        [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+        /**
+         * @brief Returns whether the elements are stored inline (no heap allocation).
+         * @return True if the vector uses its inline buffer.
+         * **/
+        [[nodiscard]] bool IsInline() const noexcept { return data_ == inline_; }
+
+        void reserve(size_t newCapacity) {
+            if (newCapacity <= capacity_) return;
+            T *newData = static_cast<T *>(::operator new(newCapacity * sizeof(T)));
+            if (size_ > 0) std::memcpy(newData, data_, size_ * sizeof(T));
+            FreeHeap();
+            data_ = newData;
+            capacity_ = newCapacity;
+        }
+
+        // Modifiers
+
+        void clear() noexcept { size_ = 0; }
+
+        void resize(size_t count, const T &value = T()) {
+            if (count > size_) {
+                reserve(count);
+                std::fill_n(data_ + size_, count - size_, value);
+            }
+            size_ = count;
+        }
+
+        template <typename InputIt>
+        void assign(InputIt first, InputIt last) {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            size_ = 0;
+            reserve(count);
+            for (size_t i = 0; i < count; ++i, ++first) data_[i] = *first;
+            size_ = count;
+        }
+
+        void push_back(const T &value) {
+            if (size_ == capacity_) Grow(size_ + 1);
+            data_[size_++] = value;
+        }
+
+        void pop_back() noexcept { --size_; }
+
+        /**
+         * @brief Inserts an element before pos.
+         * @param pos The position to insert at.
+         * @param value The element to insert.
+         * @return An iterator to the inserted element.
+         * **/
+        iterator insert(const_iterator pos, const T &value) {
+            const size_t index = static_cast<size_t>(pos - data_);
+            const T copy = value; // value may alias an element that is about to move
+            if (size_ == capacity_) Grow(size_ + 1);
+            std::memmove(data_ + index + 1, data_ + index, (size_ - index) * sizeof(T));
+            data_[index] = copy;
+            ++size_;
+            return data_ + index;
+        }
+
+        /**
+         * @brief Removes the element at pos.
+         * @param pos The element to remove.
+         * @return An iterator to the element that followed the removed one.
+         * **/
+        iterator erase(const_iterator pos) noexcept {
+            const size_t index = static_cast<size_t>(pos - data_);
+            std::memmove(data_ + index, data_ + index + 1, (size_ - index - 1) * sizeof(T));
+            --size_;
+            return data_ + index;
+        }
+
+        // Comparison
+
+        [[nodiscard]] friend bool operator==(const SmallVector &lhs, const SmallVector &rhs) noexcept {
+            return lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        [[nodiscard]] friend bool operator!=(const SmallVector &lhs, const SmallVector &rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+    private:
+        void Grow(size_t minCapacity) {
+            reserve(std::max(minCapacity, capacity_ * 2));
+        }
+
+        void FreeHeap() noexcept {
+            if (data_ != inline_) ::operator delete(data_);
+            data_ = inline_;
+            capacity_ = N;
+        }
+
+        void MoveFrom(SmallVector &other) noexcept {
+            if (other.data_ == other.inline_) {
+                std::memcpy(inline_, other.inline_, other.size_ * sizeof(T));
+                data_ = inline_;
+                capacity_ = N;
+            } else {
+                // Steal the heap buffer
+                data_ = other.data_;
+                capacity_ = other.capacity_;
+                other.data_ = other.inline_;
+                other.capacity_ = N;
+            }
+            size_ = other.size_;
+            other.size_ = 0;
+        }
+
+        T inline_[N];            // Inline storage used while size() <= N
+        T *data_ = inline_;      // Active storage (inline_ or a heap buffer)
+        size_t size_ = 0;        // Number of elements
+        size_t capacity_ = N;    // Capacity of the active storage
+    };
+}
@@ -49,8 +49,14 @@ namespace NextTypes
         }
     }
 
+    /** 
+     * @brief Returns the DataType corresponding to a C++ element type.
+     * @tparam T The element type.
+     * @return The matching DataType, or DataType::UNKNOWN if T is not a supported element type.
+     * **/
     template <typename T>
     inline DataType GetDTypeFromTemplate() {
+        if (std::is_same_v<T, bool>) return DataType::BOOL;
         if (std::is_same_v<T, float>) return DataType::FLOAT32;
         if (std::is_same_v<T, double>) return DataType::FLOAT64;
         if (std::is_same_v<T, int8_t>) return DataType::INT8;
@@ -61,5 +67,6 @@ namespace NextTypes
         if (std::is_same_v<T, uint16_t>) return DataType::UINT16;
         if (std::is_same_v<T, uint32_t>) return DataType::UINT32;
         if (std::is_same_v<T, uint64_t>) return DataType::UINT64;
+        return DataType::UNKNOWN;
     }
 }
\ No newline at end of file
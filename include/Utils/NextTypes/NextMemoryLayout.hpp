@@ -1,15 +1,42 @@
 #pragma once
 
+#include <cstddef> // size_t
+
 namespace NextTypes
 {
-    /** 
+    /**
      * @enum Memory Layout
      * @brief Enumeration for different memory layouts of tensors.
-     * Values : ROW_MAJOR, COLUMN_MAJOR, UNKNOWN
+     * Values : ROW_MAJOR, COLUMN_MAJOR,
+     *          NCHW8C, NCHW16C (channel-blocked "nChw8c"/"nChw16c": a tensor [N, C, ...] is stored as
+     *          [N, ceil(C / b), ..., b] with the channels padded to a multiple of the block b),
+     *          UNKNOWN
      * **/
     enum class MemoryLayout {
         ROW_MAJOR,
         COLUMN_MAJOR,
+        NCHW8C,
+        NCHW16C,
         UNKNOWN
     };
-}
\ No newline at end of file
+
+    /**
+     * @brief Returns the channel block of a memory layout.
+     * @param layout The memory layout.
+     * @return 8 or 16 for the channel-blocked layouts, 0 otherwise.
+     * **/
+    constexpr size_t GetChannelBlock(MemoryLayout layout) noexcept {
+        switch (layout) {
+            case MemoryLayout::NCHW8C:  return 8;
+            case MemoryLayout::NCHW16C: return 16;
+            default:                    return 0;
+        }
+    }
+
+    /**
+     * @brief Checks whether a memory layout is channel-blocked.
+     * @param layout The memory layout.
+     * @return True for NCHW8C and NCHW16C.
+     * **/
+    constexpr bool IsBlockedLayout(MemoryLayout layout) noexcept { return GetChannelBlock(layout) != 0; }
+}
@@ -5,7 +5,8 @@ namespace NextTypes
     /** 
      * @enum Operation Type
      * @brief Enumeration for different types of tensor operations.
-     * Values : ADD, SUB, MUL, DIV, MATMUL, RELU, SIGMOID, TANH, SOFTMAX, CONV2D, MAXPOOL, AVGPOOL, FLATTEN, RESHAPE, TRANSPOSE, UNKNOWN
+     * Values : ADD, SUB, MUL, DIV, MATMUL, RELU, SIGMOID, TANH, SOFTMAX, CONV2D, MAXPOOL, AVGPOOL, FLATTEN, RESHAPE, TRANSPOSE,
+     *          REORDER (copy into another MemoryLayout), UNKNOWN
      * **/
     enum class OpType {
         ADD,
@@ -23,6 +24,7 @@ namespace NextTypes
         FLATTEN,
         RESHAPE,
         TRANSPOSE,
+        REORDER,
         UNKNOWN
     };
 }
\ No newline at end of file
@@ -1,9 +1,10 @@
 #pragma once
 
 #include <cstddef> // size_t
-#include <vector>  // std::vector
 #include <array>   // std::array
+#include <utility> // std::swap
 #include <stdexcept> // std::invalid_argument, std::out_of_range
+#include "NextSmallVector.hpp" // NextUtils::SmallVector
 
 
 template <size_t N>
@@ -11,8 +12,10 @@ using TensorStrideStatic = std::array<size_t, N>; // Stride of a tensor with sta
 template <size_t N>
 using TensorShapeStatic = std::array<size_t, N>;  // Shape of a tensor with static rank
 
-using TensorShapeDynamic = std::vector<size_t>;   // Shape of a tensor with dynamic rank
-using TensorStrideDynamic = std::vector<size_t>;  // Stride of a tensor with dynamic rank
+inline constexpr size_t MaxInlineRank = 8;        // Ranks up to this value are stored without heap allocation
+
+using TensorShapeDynamic = NextUtils::SmallVector<size_t, MaxInlineRank>;   // Shape of a tensor with dynamic rank
+using TensorStrideDynamic = NextUtils::SmallVector<size_t, MaxInlineRank>;  // Stride of a tensor with dynamic rank
 
 using TensorSize  = size_t;                       // Size of a tensor dimension
 using TensorIndex = size_t;                       // Index of a tensor element
@@ -20,12 +23,12 @@ using TensorOffset = size_t;                      // Offset in the tensor's unde
 using TensorRank = size_t;                        // Rank (number of dimensions) of a tensor
 template <size_t N>
 using TensorIndexStatic = std::array<size_t, N>;  // Shape of a tensor with static rank
-using TensorIndexDynamic = std::vector<size_t>;   // Shape of a tensor with dynamic rank
+using TensorIndexDynamic = NextUtils::SmallVector<size_t, MaxInlineRank>;   // Shape of a tensor with dynamic rank
 
 /** 
  * @namespace NextUtils
  * @brief A namespace for utility functions and definitions used in the project.
- * Functions : ComputeStrides, ComputeSize, FlattenIndex, UnflattenIndex
+ * Functions : ComputeStrides, ComputeSize, ComputeStorageSize, ComputeContiguity, FlattenIndex, UnflattenIndex
  * 
  * **/
 namespace NextUtils
@@ -98,7 +101,41 @@ namespace NextUtils
         return size;
     }
 
-    /** 
+    /**
+     * @brief Computes the number of elements a buffer must hold to back a tensor with the given layout.
+     * @param shape The shape of the tensor.
+     * @param strides The strides of the tensor.
+     * @param offset The offset of the first element in the buffer.
+     * @return The minimum number of elements of the underlying buffer (0 for an empty tensor).
+     * **/
+    [[nodiscard]] inline TensorSize ComputeStorageSize(const TensorShapeDynamic& shape, const TensorStrideDynamic& strides, TensorOffset offset = 0) noexcept {
+        TensorSize lastIndex = offset;
+        for (size_t i = 0; i < shape.size(); ++i) {
+            if (shape[i] == 0) return 0; // Empty tensors need no storage
+            lastIndex += (shape[i] - 1) * strides[i];
+        }
+        return lastIndex + 1;
+    }
+
+    /**
+     * @brief Checks whether a shape/stride pair describes a dense row-major layout.
+     * Dimensions of size 1 are ignored since their stride is never used to address an element.
+     * @param shape The shape of the tensor.
+     * @param strides The strides of the tensor.
+     * @return True if the elements are laid out contiguously in row-major order, false otherwise.
+     * **/
+    [[nodiscard]] inline bool ComputeContiguity(const TensorShapeDynamic& shape, const TensorStrideDynamic& strides) noexcept {
+        TensorSize expectedStride = 1;
+        for (size_t i = shape.size(); i-- > 0;) {
+            if (shape[i] == 0) return true; // Empty tensors are trivially contiguous
+            if (shape[i] == 1) continue;
+            if (strides[i] != expectedStride) return false;
+            expectedStride *= shape[i];
+        }
+        return true;
+    }
+
+    /**
      * @brief Flattens multi-dimensional indices into a single-dimensional index using the provided strides.
      * @tparam N The rank (number of dimensions) of the tensor.
      * @param strides The strides of the tensor.
@@ -172,7 +209,12 @@ namespace NextUtils
         return indices;
     }
 
-    [[nodiscard]] inline void NextReverse(std::vector<size_t> &vec) noexcept {
+    /**
+     * @brief Reverses the order of the elements of a shape, stride or index list in place.
+     * @param vec The list to reverse.
+     * **/
+    inline void NextReverse(TensorShapeDynamic &vec) noexcept {
+        if (vec.empty()) return;
         size_t left = 0;
         size_t right = vec.size() - 1;
         while (left < right) {
@@ -0,0 +1,83 @@
+// Regression tests for EliminateCommonSubexpressions: what may and may not be merged.
+// Build: g++ -std=c++17 -O2 -pthread -Iinclude tests/CommonSubexpression.cpp -o CommonSubexpression
+#include "ComputationEngine/Execution/Engines.hpp"
+#include "ComputationEngine/Graph/Passes/CommonSubexpression.hpp"
+#include "ComputationEngine/Graph/Passes/ConstantFolding.hpp"
+#include "Core/TensorDynamic.hpp"
+#include <cstdio>
+
+using namespace NextGraph;
+
+namespace
+{
+    bool Check(bool condition, const char *what) {
+        if (!condition) std::printf("failed: %s\n", what);
+        return condition;
+    }
+
+    NextTensor::TensorDynamic<float> Ramp(const TensorShapeDynamic &shape, float start) {
+        NextTensor::TensorDynamic<float> tensor(shape);
+        for (size_t i = 0; i < tensor.GetMetadata().GetTotalSize(); ++i) tensor.GetData()[i] = start + static_cast<float>(i);
+        return tensor;
+    }
+
+    // Constants with equal contents but separate buffers merge, and then so do their readers
+    bool EqualConstants() {
+        Graph graph;
+        const ValueId x = graph.AddInput("x", DataType::FLOAT32, {2, 3});
+        const ValueId b1 = graph.AddConstant("b1", Ramp({3}, 1.0f)), b2 = graph.AddConstant("b2", Ramp({3}, 1.0f));
+        const ValueId other = graph.AddConstant("b3", Ramp({3}, 2.0f));
+        graph.MarkOutput(graph.Add(graph.Add(x, b1), graph.Add(x, b2)));
+        graph.MarkOutput(graph.Add(x, other));
+        return Check(EliminateCommonSubexpressions(graph) == 2, "equal constants and their readers merge") &&
+               Check(graph.GetValue(other).consumers.size() == 1, "a constant with other contents is kept");
+    }
+
+    // Identical constant subgraphs fold into separate buffers; CSE after FoldConstants still merges them
+    bool AfterFolding() {
+        Graph graph;
+        const ValueId x = graph.AddInput("x", DataType::FLOAT32, {2, 4});
+        const ValueId w1 = graph.AddConstant("w1", Ramp({3, 4}, 0.0f)), w2 = graph.AddConstant("w2", Ramp({3, 4}, 0.0f));
+        const ValueId y1 = graph.MatMul(x, graph.Transpose(w1)), y2 = graph.MatMul(x, graph.Transpose(w2));
+        graph.MarkOutput(graph.Add(y1, y2));
+        if (!Check(FoldConstants(graph) == 2, "both transposes fold")) return false;
+        return Check(EliminateCommonSubexpressions(graph) == 2, "folded constants and their MATMULs merge") &&
+               Check(graph.TopologicalOrder().size() == 2, "one MATMUL and the ADD are left");
+    }
+
+    // Equal bytes viewed with another shape are different constants
+    bool DifferentShapes() {
+        Graph graph;
+        const ValueId x = graph.AddInput("x", DataType::FLOAT32, {6});
+        const ValueId a = graph.AddConstant("a", Ramp({6}, 0.0f)), b = graph.AddConstant("b", Ramp({2, 3}, 0.0f));
+        graph.MarkOutput(graph.Add(x, a));
+        graph.MarkOutput(graph.Reshape(b, {6}));
+        return Check(EliminateCommonSubexpressions(graph) == 0, "constants of different shapes are kept apart");
+    }
+
+    // REORDERs of one value to different layouts are different nodes (the target layout lives on the output value)
+    bool ReorderLayouts() {
+        Graph graph;
+        const ValueId x = graph.AddInput("x", DataType::FLOAT32, {1, 16, 4, 4});
+        const ValueId r8 = graph.Reorder(x, MemoryLayout::NCHW8C), r16 = graph.Reorder(x, MemoryLayout::NCHW16C);
+        const ValueId relu = graph.Relu(r8), pool = graph.MaxPool(r16, {2, 2});
+        graph.GetValue(relu).layout = MemoryLayout::NCHW8C; // Blocked nodes, as AssignLayouts leaves them
+        graph.GetValue(pool).layout = MemoryLayout::NCHW16C;
+        graph.MarkOutput(graph.Reorder(relu, MemoryLayout::ROW_MAJOR));
+        graph.MarkOutput(graph.Reorder(pool, MemoryLayout::ROW_MAJOR));
+        if (!Check(EliminateCommonSubexpressions(graph) == 0, "REORDERs to different layouts are kept apart")) return false;
+
+        NextExecution::GraphExecutor executor(std::move(graph));
+        const NextTensor::TensorDynamic<float> input = Ramp({1, 16, 4, 4}, -100.0f);
+        const std::vector<NextTensor::TensorView> outputs = executor.Run({&input});
+        const float *relued = static_cast<const float *>(outputs[0].GetRawData()) + outputs[0].GetMetadata().GetOffset();
+        const float *pooled = static_cast<const float *>(outputs[1].GetRawData()) + outputs[1].GetMetadata().GetOffset();
+        return Check(relued[0] == 0.0f && relued[255] == 155.0f && pooled[0] == -95.0f && pooled[63] == 155.0f, "both branches run in their own layout");
+    }
+}
+
+int main() {
+    if (!EqualConstants() || !AfterFolding() || !DifferentShapes() || !ReorderLayouts()) return 1;
+    std::printf("CommonSubexpression passed\n");
+    return 0;
+}
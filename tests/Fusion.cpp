@@ -0,0 +1,82 @@
+// Regression tests for FuseElementwise: which chains fold into their head, and that fused nodes compute the same.
+// Build: g++ -std=c++17 -O2 -pthread -Iinclude tests/Fusion.cpp -o Fusion
+#include "ComputationEngine/Execution/Engines.hpp"
+#include "ComputationEngine/Graph/Passes/Fusion.hpp"
+#include "Core/TensorDynamic.hpp"
+#include <cmath>
+#include <cstdio>
+
+using namespace NextGraph;
+
+namespace
+{
+    bool Check(bool condition, const char *what) {
+        if (!condition) std::printf("failed: %s\n", what);
+        return condition;
+    }
+
+    NextTensor::TensorDynamic<float> Ramp(const TensorShapeDynamic &shape, float start, float step) {
+        NextTensor::TensorDynamic<float> tensor(shape);
+        for (size_t i = 0; i < tensor.GetMetadata().GetTotalSize(); ++i) tensor.GetData()[i] = start + step * static_cast<float>(i % 13);
+        return tensor;
+    }
+
+    Graph MakeDense() {
+        Graph graph;
+        const ValueId x = graph.AddInput("x", DataType::FLOAT32, {3, 5});
+        const ValueId w = graph.AddConstant("w", Ramp({5, 4}, -0.5f, 0.1f)), b = graph.AddConstant("b", Ramp({4}, -1.0f, 0.5f));
+        graph.MarkOutput(graph.Sigmoid(graph.Relu(graph.Add(b, graph.MatMul(x, w)))));
+        return graph;
+    }
+
+    // MATMUL -> bias ADD -> RELU -> SIGMOID becomes one node, and computes what the unfused graph computes
+    bool DenseChain() {
+        Graph graph = MakeDense();
+        if (!Check(FuseElementwise(graph) == 3, "the whole chain fuses")) return false;
+        const std::vector<NodeId> order = graph.TopologicalOrder();
+        if (!Check(order.size() == 1, "one node is left")) return false;
+        const Node &node = graph.GetNode(order.front());
+        if (!Check(node.op == OpType::MATMUL && node.inputs.size() == 3 && node.epilogue.size() == 3, "the MATMUL carries the chain")) return false;
+        if (!Check(node.epilogue[0].op == OpType::ADD && node.epilogue[0].operandOnLeft && node.epilogue[0].operand == 2, "the bias operand is kept in order")) {
+            return false;
+        }
+
+        const NextTensor::TensorDynamic<float> input = Ramp({3, 5}, -1.0f, 0.25f);
+        NextExecution::GraphExecutor fused(std::move(graph)), unfused(MakeDense());
+        const NextTensor::TensorView result = fused.Run({&input}).front(), expected = unfused.Run({&input}).front();
+        const float *lhs = static_cast<const float *>(result.GetRawData()) + result.GetMetadata().GetOffset();
+        const float *rhs = static_cast<const float *>(expected.GetRawData()) + expected.GetMetadata().GetOffset();
+        for (size_t i = 0; i < 12; ++i) {
+            if (!Check(std::fabs(lhs[i] - rhs[i]) <= 1e-6f, "fused results match")) return false;
+        }
+        return true;
+    }
+
+    // Values read twice or returned must be materialized; an operand larger than the result does not fuse
+    bool Boundaries() {
+        Graph shared;
+        const ValueId x = shared.AddInput("x", DataType::FLOAT32, {2, 8});
+        const ValueId t = shared.Tanh(x);
+        shared.MarkOutput(shared.Relu(t));
+        shared.MarkOutput(shared.Sigmoid(t));
+        if (!Check(FuseElementwise(shared) == 0, "a value with two readers is not fused")) return false;
+
+        Graph returned;
+        const ValueId y = returned.AddInput("y", DataType::FLOAT32, {2, 8});
+        const ValueId u = returned.Tanh(y);
+        returned.MarkOutput(u);
+        returned.MarkOutput(returned.Relu(u));
+        if (!Check(FuseElementwise(returned) == 0, "a graph output is not fused")) return false;
+
+        Graph growing;
+        const ValueId row = growing.AddInput("row", DataType::FLOAT32, {1, 8}), full = growing.AddInput("full", DataType::FLOAT32, {4, 8});
+        growing.MarkOutput(growing.Add(growing.Relu(row), full));
+        return Check(FuseElementwise(growing) == 0, "an operand that grows the result is not fused");
+    }
+}
+
+int main() {
+    if (!DenseChain() || !Boundaries()) return 1;
+    std::printf("Fusion passed\n");
+    return 0;
+}
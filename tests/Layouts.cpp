@@ -0,0 +1,128 @@
+// Regression tests for channel-blocked layouts: stride-based code must reject them instead of misreading them, and
+// AssignLayouts blocks only the regions that pay for their REORDERs without changing the results.
+// Build: g++ -std=c++17 -O2 -pthread -Iinclude tests/Layouts.cpp -o Layouts
+#include "ComputationEngine/Execution/Engines.hpp"
+#include "ComputationEngine/Graph/Passes/LayoutPropagation.hpp"
+#include "ComputationEngine/Kernels/Conv.hpp"
+#include "ComputationEngine/Kernels/Copy.hpp"
+#include "ComputationEngine/Kernels/Pool.hpp"
+#include "ComputationEngine/Kernels/Reorder.hpp"
+#include "ComputationEngine/Kernels/Softmax.hpp"
+#include "Core/TensorAccessor.hpp"
+#include "Core/TensorDynamic.hpp"
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace
+{
+    bool Check(bool condition, const char *what) {
+        if (!condition) std::printf("failed: %s\n", what);
+        return condition;
+    }
+
+    bool Rejects(const std::function<void()> &call, const char *what) {
+        try {
+            call();
+        } catch (const std::invalid_argument &) {
+            return true;
+        }
+        std::printf("failed: %s accepts a channel-blocked tensor\n", what);
+        return false;
+    }
+
+    // Every stride-based entry point throws on blocked metadata; Reorder converts it
+    bool BlockedGuards() {
+        using namespace NextKernels;
+        const TensorMetadata blocked({2, 12, 5, 5}, NextTypes::MemoryLayout::NCHW8C), plain({2, 12, 5, 5});
+        std::vector<float> x(blocked.GetStorageSize(), 1.0f), y(blocked.GetStorageSize()), w(12 * 12 * 9, 1.0f);
+        const TensorMetadata weight({12, 12, 3, 3}), pooled({2, 12, 2, 2}), rows({2, 12, 25});
+        const DataType f32 = DataType::FLOAT32;
+        bool ok = true;
+        ok &= Rejects([&] { Copy(f32, y.data(), plain, x.data(), blocked); }, "Copy");
+        ok &= Rejects([&] { ElementwiseUnary(OpType::RELU, f32, y.data(), plain, x.data(), blocked); }, "ElementwiseUnary");
+        ok &= Rejects([&] { ElementwiseBinary(OpType::ADD, f32, y.data(), blocked, x.data(), plain, x.data(), plain); }, "ElementwiseBinary");
+        ok &= Rejects([&] { Softmax(f32, y.data(), blocked, x.data(), blocked, 1); }, "Softmax");
+        ok &= Rejects([&] { MatMul(f32, y.data(), blocked, x.data(), plain, w.data(), TensorMetadata({2, 12, 5, 5})); }, "MatMul");
+        ok &= Rejects([&] { Pool2D(OpType::MAXPOOL, f32, y.data(), pooled, x.data(), blocked, Pool2DParams{2, 2, 2, 2, 0, 0}); }, "Pool2D");
+        ok &= Rejects([&] { Conv2D(f32, y.data(), plain, x.data(), blocked, w.data(), weight, nullptr, nullptr, Conv2DParams{1, 1, 1, 1, 1}); }, "Conv2D");
+        ok &= Rejects([&] { NextShapeUtils::NextPermute(blocked, {0, 2, 3, 1}); }, "NextPermute");
+        ok &= Rejects([&] { NextShapeUtils::NextSlice(blocked, {0, 0, 0, 0}, {1, 8, 5, 5}); }, "NextSlice");
+        ok &= Rejects([&] { NextShapeUtils::NextReshape(blocked, {2, 12, 25}); }, "NextReshape");
+        ok &= Rejects([&] { NextShapeUtils::NextBroadcastTo(blocked, {3, 2, 12, 5, 5}); }, "NextBroadcastTo");
+        ok &= Rejects([&] { NextTensor::TensorIterator<2>(plain, blocked); }, "TensorIterator");
+        ok &= Rejects([&] { NextTensor::TensorAccessor<float, 4>(x.data(), blocked); }, "TensorAccessor");
+        if (!ok) return false;
+
+        // The supported route: Reorder to a plain layout, then any kernel
+        std::vector<float> source(plain.GetTotalSize()), back(plain.GetTotalSize());
+        for (size_t i = 0; i < source.size(); ++i) source[i] = static_cast<float>(i);
+        Reorder(f32, x.data(), blocked, source.data(), plain);
+        Reorder(f32, y.data(), plain, x.data(), blocked);
+        ElementwiseUnary(OpType::RELU, f32, back.data(), rows, y.data(), rows);
+        return Check(back == source, "Reorder round trip");
+    }
+
+    NextTensor::TensorDynamic<float> Ramp(const TensorShapeDynamic &shape, float start) {
+        NextTensor::TensorDynamic<float> tensor(shape);
+        for (size_t i = 0; i < tensor.GetMetadata().GetTotalSize(); ++i) tensor.GetData()[i] = start + 0.125f * static_cast<float>(i % 29);
+        return tensor;
+    }
+
+    // Depthwise convolution -> RELU -> max pooling, on 20 channels (a partial channel block)
+    NextGraph::Graph MakePooled() {
+        NextGraph::Graph graph;
+        const NextGraph::ValueId x = graph.AddInput("x", DataType::FLOAT32, {2, 20, 9, 9});
+        const NextGraph::ValueId w = graph.AddConstant("w", Ramp({20, 1, 3, 3}, -1.0f)), b = graph.AddConstant("b", Ramp({20}, -0.5f));
+        graph.MarkOutput(graph.MaxPool(graph.Relu(graph.Conv2D(x, w, b, {1, 1}, {1, 1}, 20)), {2, 2}, {2, 2}));
+        return graph;
+    }
+
+    // A region with two anchors and two boundary REORDERs is blocked; the results do not change
+    bool BlockedRegion() {
+        using namespace NextGraph;
+        Graph graph = MakePooled();
+        const LayoutPlan plan = AssignLayouts(graph, MemoryLayout::NCHW8C);
+        if (!Check(plan.blockedNodes == 3 && plan.reorders == 2, "the convolution, RELU and pooling are blocked behind two REORDERs")) return false;
+        for (NodeId id : graph.TopologicalOrder()) {
+            const Node &node = graph.GetNode(id);
+            const MemoryLayout layout = graph.GetValue(node.outputs.front()).layout;
+            if (node.op != OpType::REORDER && !Check(layout == MemoryLayout::NCHW8C, "region nodes write nChw8c")) return false;
+        }
+        if (!Check(graph.GetValue(graph.GetOutputs().front()).layout == MemoryLayout::ROW_MAJOR, "the graph output is ROW_MAJOR")) return false;
+
+        const NextTensor::TensorDynamic<float> input = Ramp({2, 20, 9, 9}, -2.0f);
+        NextExecution::GraphExecutor blocked(std::move(graph)), plain(MakePooled());
+        const NextTensor::TensorView result = blocked.Run({&input}).front(), expected = plain.Run({&input}).front();
+        const float *lhs = static_cast<const float *>(result.GetRawData()) + result.GetMetadata().GetOffset();
+        const float *rhs = static_cast<const float *>(expected.GetRawData()) + expected.GetMetadata().GetOffset();
+        for (size_t i = 0; i < expected.GetMetadata().GetTotalSize(); ++i) {
+            if (!Check(std::fabs(lhs[i] - rhs[i]) <= 1e-5f, "blocked results match")) return false;
+        }
+        return true;
+    }
+
+    // Regions without enough anchors stay ROW_MAJOR; only blocked layouts are accepted
+    bool PlainRegions() {
+        using namespace NextGraph;
+        Graph elementwise;
+        const ValueId x = elementwise.AddInput("x", DataType::FLOAT32, {1, 16, 4, 4});
+        elementwise.MarkOutput(elementwise.Sigmoid(elementwise.Relu(x)));
+        const LayoutPlan none = AssignLayouts(elementwise, MemoryLayout::NCHW16C);
+        if (!Check(none.blockedNodes == 0 && none.reorders == 0, "an elementwise-only region is not blocked")) return false;
+
+        Graph pooled;
+        const ValueId y = pooled.AddInput("y", DataType::FLOAT32, {1, 16, 4, 4});
+        pooled.MarkOutput(pooled.MaxPool(y, {2, 2}));
+        const LayoutPlan lone = AssignLayouts(pooled, MemoryLayout::NCHW16C);
+        if (!Check(lone.blockedNodes == 0 && lone.reorders == 0, "one anchor does not pay for two REORDERs")) return false;
+        return Rejects([&] { AssignLayouts(pooled, MemoryLayout::ROW_MAJOR); }, "AssignLayouts(ROW_MAJOR)");
+    }
+}
+
+int main() {
+    if (!BlockedGuards() || !BlockedRegion() || !PlainRegions()) return 1;
+    std::printf("Layouts passed\n");
+    return 0;
+}
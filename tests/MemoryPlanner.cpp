@@ -0,0 +1,95 @@
+// Regression tests for PlanMemory: buffers that are live at the same step never share bytes, views alias their base,
+// and a planned graph computes what the reference engine computes.
+// Build: g++ -std=c++17 -O2 -pthread -Iinclude tests/MemoryPlanner.cpp -o MemoryPlanner
+#include "ComputationEngine/Execution/Engines.hpp"
+#include "ComputationEngine/Graph/Passes/MemoryPlanner.hpp"
+#include "Core/TensorDynamic.hpp"
+#include <cmath>
+#include <cstdio>
+
+using namespace NextGraph;
+
+namespace
+{
+    bool Check(bool condition, const char *what) {
+        if (!condition) std::printf("failed: %s\n", what);
+        return condition;
+    }
+
+    // Long-lived a, a view of b read late, and a chain whose buffers can be reused
+    Graph MakeGraph() {
+        Graph graph;
+        const ValueId x = graph.AddInput("x", DataType::FLOAT32, {4, 63});
+        const ValueId a = graph.Sigmoid(x), b = graph.Tanh(a);
+        const ValueId view = graph.Reshape(b, {252});
+        const ValueId d = graph.Sigmoid(graph.Relu(graph.Tanh(a)));
+        graph.MarkOutput(graph.Add(a, d));
+        graph.MarkOutput(graph.Tanh(view));
+        return graph;
+    }
+
+    // Lifetimes recomputed from the graph: [producer step, last reader step (through views)], outputs to the end
+    bool LiveBuffersAreDisjoint(const Graph &graph, const MemoryPlan &plan) {
+        const std::vector<NodeId> order = graph.TopologicalOrder();
+        std::vector<size_t> stepOf(graph.GetNumNodes(), 0), first(graph.GetNumValues(), 0), last(graph.GetNumValues(), 0), bytes(graph.GetNumValues(), 0);
+        for (size_t step = 0; step < order.size(); ++step) stepOf[order[step]] = step;
+        for (ValueId id = 0; id < graph.GetNumValues(); ++id) {
+            const Value &value = graph.GetValue(id);
+            const ValueId root = value.aliasOf == InvalidId ? id : value.aliasOf;
+            if (plan.byteOffsets[root] == InvalidId) continue;
+            if (id == root) {
+                first[id] = last[id] = stepOf[value.producer];
+                bytes[id] = value.metadata->GetStorageSize() * sizeof(float);
+            }
+            for (NodeId consumer : value.consumers) last[root] = std::max(last[root], stepOf[consumer]);
+            if (value.isOutput) last[root] = order.size();
+        }
+        for (ValueId lhs = 0; lhs < graph.GetNumValues(); ++lhs) {
+            for (ValueId rhs = lhs + 1; rhs < graph.GetNumValues(); ++rhs) {
+                if (plan.byteOffsets[lhs] == InvalidId || plan.byteOffsets[rhs] == InvalidId) continue;
+                if (first[lhs] > last[rhs] || first[rhs] > last[lhs]) continue;
+                const size_t lo = plan.byteOffsets[lhs], ro = plan.byteOffsets[rhs];
+                if (lo < ro + bytes[rhs] && ro < lo + bytes[lhs]) return false;
+            }
+        }
+        return true;
+    }
+
+    bool Planning() {
+        Graph graph = MakeGraph();
+        InferShapes(graph);
+        const MemoryPlan plan = PlanMemory(graph);
+        if (!Check(LiveBuffersAreDisjoint(graph, plan), "buffers live at the same step do not overlap")) return false;
+        if (!Check(plan.slabBytes < plan.unplannedBytes, "buffers with disjoint lifetimes share the slab")) return false;
+        for (ValueId id = 0; id < graph.GetNumValues(); ++id) {
+            const Value &value = graph.GetValue(id);
+            if (value.aliasOf == InvalidId) continue;
+            const Value &base = graph.GetValue(value.aliasOf);
+            if (!Check(plan.byteOffsets[id] == InvalidId && value.metadata->GetOffset() == base.metadata->GetOffset(), "views alias their base")) return false;
+        }
+        return true;
+    }
+
+    // Reused buffers must not clobber values that are still read
+    bool Execution() {
+        NextTensor::TensorDynamic<float> input({4, 63});
+        for (size_t i = 0; i < input.GetMetadata().GetTotalSize(); ++i) input.GetData()[i] = static_cast<float>(i % 17) / 4.0f - 2.0f;
+        NextExecution::GraphExecutor planned(MakeGraph());
+        NextExecution::GraphExecutor reference(MakeGraph(), {std::make_shared<NextExecution::ReferenceEngine>()});
+        const std::vector<NextTensor::TensorView> outputs = planned.Run({&input}), expected = reference.Run({&input});
+        for (size_t o = 0; o < outputs.size(); ++o) {
+            const float *result = static_cast<const float *>(outputs[o].GetRawData()) + outputs[o].GetMetadata().GetOffset();
+            const float *truth = static_cast<const float *>(expected[o].GetRawData()) + expected[o].GetMetadata().GetOffset();
+            for (size_t i = 0; i < outputs[o].GetMetadata().GetTotalSize(); ++i) {
+                if (!Check(std::fabs(result[i] - truth[i]) <= 1e-5f, "planned graph matches the reference engine")) return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main() {
+    if (!Planning() || !Execution()) return 1;
+    std::printf("MemoryPlanner passed\n");
+    return 0;
+}
@@ -0,0 +1,18 @@
+// Regression test: every kernel of the optimized engine matches the reference engine on its validation cases.
+// Build: g++ -std=c++17 -O2 -pthread -Iinclude tests/ValidateEngine.cpp -o ValidateEngine
+#include "ComputationEngine/Execution/Engines.hpp"
+#include <cstdio>
+
+int main() {
+    const std::vector<NextExecution::KernelValidation> results = NextExecution::ValidateEngine(NextExecution::OptimizedCpuEngine());
+    size_t failed = 0;
+    for (const NextExecution::KernelValidation &result : results) {
+        if (result.passed) continue;
+        std::printf("failed: op %d dtype %d layout %d variant %zu, max error %g\n", static_cast<int>(result.key.op), static_cast<int>(result.key.dtype),
+                    static_cast<int>(result.key.layout), result.variant, result.maxError);
+        ++failed;
+    }
+    if (results.empty() || failed > 0) return 1;
+    std::printf("ValidateEngine passed (%zu kernels)\n", results.size());
+    return 0;
+}